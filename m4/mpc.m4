@@ -60,6 +60,58 @@ AC_DEFUN([MPC_COMPLEX_H], [
 ])
 
 
+#
+# SYNOPSIS
+#
+#
+# MPC_THREAD_LOCAL
+#
+# DESCRIPTION
+#
+# Check whether the compiler supports thread-local storage, through the
+# C11 keyword _Thread_local or the GNU extension __thread; if yes, define
+# MPC_THREAD_ATTR to the corresponding storage class specifier.
+#
+AC_DEFUN([MPC_THREAD_LOCAL], [
+   AC_MSG_CHECKING([for thread-local storage])
+   mpc_thread_attr=no
+   for mpc_attr in _Thread_local __thread; do
+      AC_LINK_IFELSE(
+         [AC_LANG_PROGRAM(
+            [[static $mpc_attr int x = 17;]],
+            [[x++; return x != 18;]]
+         )],
+         [mpc_thread_attr=$mpc_attr; break]
+      )
+   done
+   AC_MSG_RESULT([$mpc_thread_attr])
+   AS_IF([test "x$mpc_thread_attr" != "xno"], [
+      AC_DEFINE_UNQUOTED([MPC_THREAD_ATTR], [$mpc_thread_attr],
+         [Storage class specifier for thread-local variables])
+   ])
+])
+
+
+#
+# SYNOPSIS
+#
+#
+# MPC_PTHREAD
+#
+# DESCRIPTION
+#
+# Check whether POSIX threads are available, adding the library providing
+# pthread_create to LIBS if needed; if yes, define HAVE_PTHREAD.
+#
+AC_DEFUN([MPC_PTHREAD], [
+   AC_CHECK_HEADER([pthread.h], [
+      AC_SEARCH_LIBS([pthread_create], [pthread], [
+         AC_DEFINE([HAVE_PTHREAD], 1, [Define to 1 if POSIX threads are available])
+      ])
+   ])
+])
+
+
 #
 # SYNOPSIS
 #
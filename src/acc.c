@@ -0,0 +1,269 @@
+/* mpc_acc -- Exact accumulation of a stream of complex numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* Each part of an accumulator is an array of MPC_ACC_SIZE variables
+   followed by a spare one: entry 0 is the exact sum s of the terms already
+   collected, entries 1 to n-1 are pending terms, copied exactly. When the
+   array is full, the n entries are added by mpfr_sum into the spare
+   variable, with a precision large enough for the sum to be exact, and the
+   result becomes the new entry 0. Each term is thus read once when added
+   and once when collected, which costs O(1) per term for bounded
+   precisions and exponents. The value is only rounded by mpc_acc_get.
+
+   Entry 0 starts as -0, which is neutral for the sum including for the
+   sign of zero. The collections round to nearest, so that s is -0 exactly
+   when all collected terms are -0, and +0 when they are all +0 or when
+   they cancel. In the latter case, the sign of a zero result depends on
+   the final rounding mode; a -0 is then kept as entry 1 after s, since
+   +0 + -0 is a zero from cancellation as well for mpfr_sum. Adding the
+   collected entries to the pending terms thus gives the sign of a zero
+   result that mpfr_sum would give on all terms, in every rounding mode.
+   Infinities and NaNs follow the rules of mpfr_sum as well.
+   All computations are done in the largest exponent range, so that s and
+   the exact products of mpc_acc_add_mul do not overflow. */
+
+#define EXTEND_RANGE(saved_emin, saved_emax)    \
+  do {                                          \
+    saved_emin = mpfr_get_emin ();              \
+    saved_emax = mpfr_get_emax ();              \
+    mpfr_set_emin (mpfr_get_emin_min ());       \
+    mpfr_set_emax (mpfr_get_emax_max ());       \
+  } while (0)
+
+#define RESTORE_RANGE(saved_emin, saved_emax)   \
+  do {                                          \
+    mpfr_set_emin (saved_emin);                 \
+    mpfr_set_emax (saved_emax);                 \
+  } while (0)
+
+void
+mpc_acc_init (mpc_acc_ptr acc)
+{
+  void * (*allocfunc) (size_t);
+  unsigned long i;
+
+  mp_get_memory_functions (&allocfunc, NULL, NULL);
+  acc->re = (__mpfr_struct *) (*allocfunc) ((MPC_ACC_SIZE + 1)
+                                            * sizeof (__mpfr_struct));
+  acc->im = (__mpfr_struct *) (*allocfunc) ((MPC_ACC_SIZE + 1)
+                                            * sizeof (__mpfr_struct));
+  acc->ptr = (mpfr_ptr *) (*allocfunc) (2 * MPC_ACC_SIZE * sizeof (mpfr_ptr));
+  for (i = 0; i <= MPC_ACC_SIZE; i++)
+    {
+      mpfr_init2 (acc->re + i, MPFR_PREC_MIN);
+      mpfr_init2 (acc->im + i, MPFR_PREC_MIN);
+    }
+  for (i = 0; i < MPC_ACC_SIZE; i++)
+    {
+      acc->ptr [i] = acc->re + i;
+      acc->ptr [MPC_ACC_SIZE + i] = acc->im + i;
+    }
+  mpfr_set_zero (acc->re, -1);
+  mpfr_set_zero (acc->im, -1);
+  acc->n = 1;
+  acc->empty = 1;
+}
+
+void
+mpc_acc_clear (mpc_acc_ptr acc)
+{
+  void (*freefunc) (void *, size_t);
+  unsigned long i;
+
+  for (i = 0; i <= MPC_ACC_SIZE; i++)
+    {
+      mpfr_clear (acc->re + i);
+      mpfr_clear (acc->im + i);
+    }
+  mp_get_memory_functions (NULL, NULL, &freefunc);
+  (*freefunc) (acc->re, (MPC_ACC_SIZE + 1) * sizeof (__mpfr_struct));
+  (*freefunc) (acc->im, (MPC_ACC_SIZE + 1) * sizeof (__mpfr_struct));
+  (*freefunc) (acc->ptr, 2 * MPC_ACC_SIZE * sizeof (mpfr_ptr));
+}
+
+/* replace the n entries of x, with pointers p, by their exact sum; return
+   non-zero if the sum is a zero from cancellation, that is, +0 while not
+   all entries are +0 */
+static int
+collect (__mpfr_struct *x, mpfr_ptr *p, unsigned long n)
+{
+  mpfr_ptr spare = x + MPC_ACC_SIZE;
+  mpfr_exp_t emax = 0, lsb = 0;
+  unsigned long i, m = 0;
+  int inex, plus_zeros = 1;
+
+  /* the sum of m regular terms less than 2^emax in absolute value is less
+     than 2^(emax + ceil(log2(m))), and is a multiple of 2^lsb */
+  for (i = 0; i < n; i++)
+    if (mpfr_regular_p (x + i))
+      {
+        mpfr_exp_t e = mpfr_get_exp (x + i);
+        mpfr_exp_t l = e - (mpfr_exp_t) mpfr_get_prec (x + i);
+
+        if (m == 0 || e > emax)
+          emax = e;
+        if (m == 0 || l < lsb)
+          lsb = l;
+        m++;
+      }
+  for (i = 0; i < n && plus_zeros; i++)
+    plus_zeros = mpfr_zero_p (x + i) && !mpfr_signbit (x + i);
+  if (m == 0)
+    mpfr_set_prec (spare, MPFR_PREC_MIN);
+  else
+    mpfr_set_prec (spare, (mpfr_prec_t) (emax - lsb)
+                   + mpc_ceil_log2 ((mpfr_prec_t) m));
+  inex = mpfr_sum (spare, p, n, MPFR_RNDN);
+  MPC_ASSERT (inex == 0);
+  mpfr_swap (x, spare);
+  return !plus_zeros && mpfr_zero_p (x) && !mpfr_signbit (x);
+}
+
+/* set entry 1 of x after a collection, so that it does not change the sum
+   of the collected terms, or makes it a zero from cancellation if c is
+   non-zero */
+static void
+set_entry1 (__mpfr_struct *x, int c)
+{
+  mpfr_set_prec (x + 1, MPFR_PREC_MIN);
+  if (!c && mpfr_zero_p (x) && !mpfr_signbit (x))
+    mpfr_set_zero (x + 1, +1);
+  else
+    mpfr_set_zero (x + 1, -1);
+}
+
+static void
+acc_collect (mpc_acc_ptr acc)
+{
+  int c_re, c_im;
+
+  c_re = collect (acc->re, acc->ptr, acc->n);
+  c_im = collect (acc->im, acc->ptr + MPC_ACC_SIZE, acc->n);
+  acc->n = 1;
+  if (c_re || c_im)
+    {
+      set_entry1 (acc->re, c_re);
+      set_entry1 (acc->im, c_im);
+      acc->n = 2;
+    }
+}
+
+/* add the copies of x and y to the pending terms of the real and imaginary
+   parts; the exponent range must be extended */
+static void
+acc_push (mpc_acc_ptr acc, mpfr_srcptr x, mpfr_srcptr y)
+{
+  if (acc->n == MPC_ACC_SIZE)
+    acc_collect (acc);
+  mpfr_set_prec (acc->re + acc->n, mpfr_get_prec (x));
+  mpfr_set (acc->re + acc->n, x, MPFR_RNDN);
+  mpfr_set_prec (acc->im + acc->n, mpfr_get_prec (y));
+  mpfr_set (acc->im + acc->n, y, MPFR_RNDN);
+  acc->n++;
+  acc->empty = 0;
+}
+
+/* acc <- acc + z */
+void
+mpc_acc_add (mpc_acc_ptr acc, mpc_srcptr z)
+{
+  mpfr_exp_t saved_emin, saved_emax;
+
+  EXTEND_RANGE (saved_emin, saved_emax);
+  acc_push (acc, mpc_realref (z), mpc_imagref (z));
+  RESTORE_RANGE (saved_emin, saved_emax);
+}
+
+/* acc <- acc + x*y, where the four products of the parts are added exactly
+   as for mpc_dot */
+void
+mpc_acc_add_mul (mpc_acc_ptr acc, mpc_srcptr x, mpc_srcptr y)
+{
+  mpfr_exp_t saved_emin, saved_emax;
+  mpfr_ptr re, im;
+
+  EXTEND_RANGE (saved_emin, saved_emax);
+  if (acc->n + 2 > MPC_ACC_SIZE)
+    acc_collect (acc);
+  re = acc->re + acc->n;
+  im = acc->im + acc->n;
+  mpfr_set_prec (re, mpfr_get_prec (mpc_realref (x))
+                 + mpfr_get_prec (mpc_realref (y)));
+  mpfr_mul (re, mpc_realref (x), mpc_realref (y), MPFR_RNDN);
+  mpfr_set_prec (re + 1, mpfr_get_prec (mpc_imagref (x))
+                 + mpfr_get_prec (mpc_imagref (y)));
+  mpfr_mul (re + 1, mpc_imagref (x), mpc_imagref (y), MPFR_RNDN);
+  mpfr_neg (re + 1, re + 1, MPFR_RNDN);
+  mpfr_set_prec (im, mpfr_get_prec (mpc_realref (x))
+                 + mpfr_get_prec (mpc_imagref (y)));
+  mpfr_mul (im, mpc_realref (x), mpc_imagref (y), MPFR_RNDN);
+  mpfr_set_prec (im + 1, mpfr_get_prec (mpc_imagref (x))
+                 + mpfr_get_prec (mpc_realref (y)));
+  mpfr_mul (im + 1, mpc_imagref (x), mpc_realref (y), MPFR_RNDN);
+  acc->n += 2;
+  acc->empty = 0;
+  RESTORE_RANGE (saved_emin, saved_emax);
+}
+
+/* acc <- acc + b; b keeps its value, and may be the same as acc */
+void
+mpc_acc_merge (mpc_acc_ptr acc, mpc_acc_ptr b)
+{
+  mpfr_exp_t saved_emin, saved_emax;
+  unsigned long i, n;
+
+  if (b->empty)
+    return;
+  EXTEND_RANGE (saved_emin, saved_emax);
+  acc_collect (b);
+  /* b now has at most 2 entries, so that pushing them does not collect b
+     again when acc = b */
+  n = b->n;
+  for (i = 0; i < n; i++)
+    acc_push (acc, b->re + i, b->im + i);
+  RESTORE_RANGE (saved_emin, saved_emax);
+}
+
+/* z <- the value of acc, rounded according to rnd; as for mpc_sum, the
+   sum of no term is +0 */
+int
+mpc_acc_get (mpc_ptr z, mpc_acc_ptr acc, mpc_rnd_t rnd)
+{
+  mpfr_exp_t saved_emin, saved_emax;
+  int inex_re, inex_im;
+
+  if (acc->empty)
+    {
+      mpfr_set_zero (mpc_realref (z), +1);
+      mpfr_set_zero (mpc_imagref (z), +1);
+      return 0;
+    }
+  EXTEND_RANGE (saved_emin, saved_emax);
+  inex_re = mpfr_sum (mpc_realref (z), acc->ptr, acc->n, MPC_RND_RE (rnd));
+  inex_im = mpfr_sum (mpc_imagref (z), acc->ptr + MPC_ACC_SIZE, acc->n,
+                      MPC_RND_IM (rnd));
+  RESTORE_RANGE (saved_emin, saved_emax);
+  inex_re = mpfr_check_range (mpc_realref (z), inex_re, MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (z), inex_im, MPC_RND_IM (rnd));
+  return MPC_INEX (inex_re, inex_im);
+}
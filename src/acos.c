@@ -24,7 +24,7 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_acos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
-  int inex_re, inex_im, inex, loop = 0;
+  int inex_re, inex_im, inex, ok, loop = 0;
   mpfr_prec_t p_re, p_im, p;
   mpc_t z1;
   mpfr_t pi_over_2;
@@ -176,9 +176,32 @@ mpc_acos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
   mpfr_set_emin (mpfr_get_emin_min ());
   mpfr_set_emax (mpfr_get_emax_max ());
 
-  /* regular complex argument: acos(z) = Pi/2 - asin(z) */
+  /* regular complex argument */
   p_re = mpfr_get_prec (mpc_realref(rop));
   p_im = mpfr_get_prec (mpc_imagref(rop));
+  p = p_re >= p_im ? p_re : p_im;
+  mpc_pool_init2 (z1, p);
+  do
+    {
+      loop ++;
+      p += (loop <= 2) ? mpc_ceil_log2 (p) + 3 : p / 2;
+      mpc_pool_set_prec (z1, p);
+      ok = mpc_asin_acos_regular (z1, op, rop, rnd, 1);
+    }
+  while (ok == 0);
+  if (ok > 0)
+    {
+      mpfr_neg (mpc_imagref(z1), mpc_imagref(z1), MPFR_RNDN);
+      inex = mpc_set (rop, z1, rnd);
+      inex_re = MPC_INEX_RE(inex);
+      inex_im = MPC_INEX_IM(inex);
+      mpc_pool_clear (z1);
+      goto end;
+    }
+  mpc_pool_clear (z1);
+
+  /* for exponents too large in absolute value: acos(z) = Pi/2 - asin(z) */
+  loop = 0;
   p = p_re;
   mpc_init3 (z1, p, p_im); /* we round directly the imaginary part to p_im,
                               with rounding mode opposite to rnd_im */
@@ -231,6 +254,7 @@ mpc_acos (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
   mpc_clear (z1);
   mpfr_clear (pi_over_2);
 
+ end:
   /* restore the exponent range, and check the range of results */
   mpfr_set_emin (saved_emin);
   mpfr_set_emax (saved_emax);
@@ -0,0 +1,368 @@
+/* mpc_agm -- Arithmetic-geometric mean of two complex numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* Set a to an approximation of AGM (1, b0) computed with the optimal
+   sequences at the precision p of a, where b0 is the rounding towards 0
+   at precision p of a complex number of absolute value at most 1 in the
+   closed upper half plane, and b0 is neither a non-negative real number
+   nor -1. Return l such that the relative error of a is at most
+   2^(l-p), see algorithms.tex; l >= p means that p is too small for the
+   analysis to apply, and a is then not computed. b0 and a must be
+   different variables. */
+mpfr_prec_t
+mpc_agm1_approx (mpc_ptr a, mpc_srcptr b0)
+{
+   mpc_t b, c;
+   mpfr_prec_t p, k, n, e;
+   mpfr_exp_t eb;
+   unsigned long i;
+
+   p = MPC_PREC_RE (a);
+   MPC_ASSERT (MPC_PREC_IM (a) == p);
+
+   /* a1 = (1 + b0) / 2, with the real part rounded down */
+   mpfr_add_ui (mpc_realref (a), mpc_realref (b0), 1, MPFR_RNDD);
+   mpfr_div_2ui (mpc_realref (a), mpc_realref (a), 1, MPFR_RNDD);
+   mpfr_div_2ui (mpc_imagref (a), mpc_imagref (b0), 1, MPFR_RNDN);
+
+   /* the number of iterations n is B (p) of algorithms.tex, which is
+      at least B (N) for N = p - l */
+   k = MPC_MAX (2, 1 - mpfr_get_exp (mpc_realref (a)));
+   if (mpfr_zero_p (mpc_realref (b0)))
+      eb = mpfr_get_exp (mpc_imagref (b0));
+   else if (mpfr_zero_p (mpc_imagref (b0)))
+      eb = mpfr_get_exp (mpc_realref (b0));
+   else
+      eb = MPC_MAX (mpfr_get_exp (mpc_realref (b0)),
+                    mpfr_get_exp (mpc_imagref (b0)));
+   e = MPC_MAX (- mpfr_get_exp (mpc_realref (a)), 2 - eb);
+   n = mpc_ceil_log2 (e) + mpc_ceil_log2 (p + 4) + 3;
+   if (2 * (n + k) - 1 > p || n + k + 3 + 2 > p)
+      return p;
+
+   mpc_pool_init2 (b, p);
+   mpc_pool_init2 (c, p);
+   mpc_sqrt (b, b0, MPC_RNDNN);
+   for (i = 2; i <= (unsigned long) n; i++) {
+      /* a and b remain in the first quadrant, so that the principal
+         square root is the right choice */
+      mpc_mul (c, a, b, MPC_RNDNN);
+      mpc_add (a, a, b, MPC_RNDNN);
+      mpc_div_2ui (a, a, 1, MPC_RNDNN);
+      mpc_sqrt (b, c, MPC_RNDNN);
+   }
+   mpc_pool_clear (b);
+   mpc_pool_clear (c);
+
+   return n + k + 3;
+}
+
+/* Return non-zero if z, an approximation of a complex number with a
+   relative error at most 2^(-N), can be rounded to rop according to rnd,
+   see the end of the section on mpc_agm in algorithms.tex. */
+static int
+can_round_rel (mpc_srcptr z, mpfr_prec_t N, mpc_srcptr rop, mpc_rnd_t rnd)
+{
+   mpfr_exp_t diff;
+   mpfr_prec_t kr, ki;
+
+   if (!mpfr_regular_p (mpc_realref (z)) || !mpfr_regular_p (mpc_imagref (z)))
+      return 0;
+   diff = mpfr_get_exp (mpc_imagref (z)) - mpfr_get_exp (mpc_realref (z));
+   kr = MPC_MAX (diff + 1, 0) + 1;
+   ki = MPC_MAX (-diff + 1, 0) + 1;
+   return kr < N && ki < N
+      && mpfr_can_round (mpc_realref (z), N - kr, MPFR_RNDN, MPFR_RNDZ,
+                         MPC_PREC_RE (rop) + (MPC_RND_RE (rnd) == MPFR_RNDN))
+      && mpfr_can_round (mpc_imagref (z), N - ki, MPFR_RNDN, MPFR_RNDZ,
+                         MPC_PREC_IM (rop) + (MPC_RND_IM (rnd) == MPFR_RNDN));
+}
+
+/* Return non-zero if x is zero or can be rounded to the precision of y
+   according to rnd, given that its error is at most 2^err ulps. */
+static int
+can_round_part (mpfr_srcptr x, mpfr_prec_t err, mpfr_srcptr y,
+                mpfr_rnd_t rnd)
+{
+   return mpfr_zero_p (x)
+      || mpfr_can_round (x, mpfr_get_prec (x) - err, MPFR_RNDN, MPFR_RNDZ,
+                         mpfr_get_prec (y) + (rnd == MPFR_RNDN));
+}
+
+enum agm_kind { AGM_REAL, AGM_CONJ_POS, AGM_CONJ_NEG, AGM_GENERAL };
+
+/* Set t to s1*x1*y1 + s2*x2*y2 + s3*x3*y3 + s4*x4*y4 rounded to nearest,
+   with signs si = +1 or -1; the result is zero if and only if the exact
+   sum is zero. */
+static void
+sum_prod4 (mpfr_ptr t, mpfr_srcptr *x, mpfr_srcptr *y, const int *s)
+{
+   mpfr_t p [4];
+   mpfr_ptr tab [4];
+   int i;
+
+   for (i = 0; i < 4; i++) {
+      mpc_pool_fr_init2 (p [i], mpfr_get_prec (x [i]) + mpfr_get_prec (y [i]));
+      mpfr_mul (p [i], x [i], y [i], MPFR_RNDN); /* exact */
+      if (s [i] < 0)
+         mpfr_neg (p [i], p [i], MPFR_RNDN);
+      tab [i] = p [i];
+   }
+   mpfr_sum (t, tab, 4, MPFR_RNDN);
+   for (i = 0; i < 4; i++)
+      mpc_pool_fr_clear (p [i]);
+}
+
+/* Check whether the first step of the AGM of u and v, with u != v,
+   yields a1 = (u+v)/2 and the geometric mean b1 = conj (a1) or
+   b1 = -conj (a1); then return AGM_CONJ_POS or AGM_CONJ_NEG respectively
+   and set a1, in which case AGM (u, v) = AGM (a1, b1) is real or purely
+   imaginary, and otherwise return AGM_GENERAL. With a1 = x + i*y, we have
+   b1^2 = u*v = conj (a1)^2, that is, u*v = x^2 - y^2 - 2*i*x*y, and the
+   right choice of b1 satisfies |a1 - b1| < |a1 + b1|, so that b1 = conj (a1)
+   if |y| < |x| and b1 = -conj (a1) if |y| > |x|; |x| = |y| is impossible,
+   since u and v would then be irrational. In this case, a1 is exact with
+   one bit more than u and v. */
+static enum agm_kind
+agm_conj_step (mpc_ptr a1, mpc_srcptr u, mpc_srcptr v)
+{
+   mpfr_srcptr x [4], y [4];
+   mpfr_t t;
+   int s [4], zero;
+   mpfr_prec_t p;
+
+   p = MPC_MAX (MPC_MAX_PREC (u), MPC_MAX_PREC (v)) + 1;
+   mpc_pool_set_prec (a1, p);
+   if (   mpfr_add (mpc_realref (a1), mpc_realref (u), mpc_realref (v),
+                    MPFR_RNDN) != 0
+       || mpfr_add (mpc_imagref (a1), mpc_imagref (u), mpc_imagref (v),
+                    MPFR_RNDN) != 0
+       || !mpfr_regular_p (mpc_realref (a1))
+       || !mpfr_regular_p (mpc_imagref (a1)))
+      return AGM_GENERAL;
+   mpc_div_2ui (a1, a1, 1, MPC_RNDNN);
+
+   mpc_pool_fr_init2 (t, MPFR_PREC_MIN);
+   /* Re (u*v) - x^2 + y^2 */
+   x [0] = mpc_realref (u); y [0] = mpc_realref (v); s [0] = 1;
+   x [1] = mpc_imagref (u); y [1] = mpc_imagref (v); s [1] = -1;
+   x [2] = mpc_realref (a1); y [2] = mpc_realref (a1); s [2] = -1;
+   x [3] = mpc_imagref (a1); y [3] = mpc_imagref (a1); s [3] = 1;
+   sum_prod4 (t, x, y, s);
+   zero = mpfr_zero_p (t);
+   if (zero) {
+      /* Im (u*v) + 2*x*y, as x*y + x*y */
+      x [0] = mpc_realref (u); y [0] = mpc_imagref (v); s [0] = 1;
+      x [1] = mpc_imagref (u); y [1] = mpc_realref (v); s [1] = 1;
+      x [2] = mpc_realref (a1); y [2] = mpc_imagref (a1); s [2] = 1;
+      x [3] = mpc_realref (a1); y [3] = mpc_imagref (a1); s [3] = 1;
+      sum_prod4 (t, x, y, s);
+      zero = mpfr_zero_p (t);
+   }
+   mpc_pool_fr_clear (t);
+   if (!zero)
+      return AGM_GENERAL;
+
+   return (mpfr_cmpabs (mpc_imagref (a1), mpc_realref (a1)) < 0
+           ? AGM_CONJ_POS : AGM_CONJ_NEG);
+}
+
+int
+mpc_agm (mpc_ptr rop, mpc_srcptr a, mpc_srcptr b, mpc_rnd_t rnd)
+{
+   mpc_srcptr u, v, c;
+   mpc_t b0, z, w, a1;
+   mpfr_t one, x;
+   mpfr_prec_t p, l;
+   mpfr_exp_t saved_emin, saved_emax;
+   int inex_b0, inex, inex_re, inex_im, ok, loop, sign_a, is_conj;
+   enum agm_kind kind;
+
+   /* special values */
+   if (!mpc_fin_p (a) || !mpc_fin_p (b)) {
+      mpfr_set_nan (mpc_realref (rop));
+      mpfr_set_nan (mpc_imagref (rop));
+      return MPC_INEX (0, 0);
+   }
+   if (mpc_zero_p (a) || mpc_zero_p (b))
+      return mpc_set_ui_ui (rop, 0, 0, MPC_RNDNN);
+   if (mpc_cmp (a, b) == 0)
+      return mpc_set (rop, a, rnd);
+
+   /* AGM (u, v) = u * AGM (1, v/u) with |v| <= |u| */
+   if (mpc_cmp_abs (a, b) >= 0) {
+      u = a;
+      v = b;
+   }
+   else {
+      u = b;
+      v = a;
+   }
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+
+   /* The imaginary part of v/u rounded towards 0 is exactly 0 if and only
+      if v/u is real; then v/u is not 1, and v = -u if and only if its real
+      part is exactly -1. */
+   mpc_pool_init2 (b0, MPFR_PREC_MIN);
+   mpc_pool_init2 (a1, MPFR_PREC_MIN);
+   c = u;
+   inex_b0 = mpc_div (b0, v, u, MPC_RNDZZ);
+   if (mpfr_zero_p (mpc_imagref (b0)) && MPC_INEX_IM (inex_b0) == 0
+       && mpfr_sgn (mpc_realref (b0)) > 0)
+      kind = AGM_REAL;
+   else if (mpfr_zero_p (mpc_imagref (b0)) && MPC_INEX_IM (inex_b0) == 0
+            && mpfr_cmp_si (mpc_realref (b0), -1) == 0) {
+      mpc_pool_clear (b0);
+      mpc_pool_clear (a1);
+      mpfr_set_emin (saved_emin);
+      mpfr_set_emax (saved_emax);
+      return mpc_set_ui_ui (rop, 0, 0, MPC_RNDNN);
+   }
+   else {
+      /* v = conj (u) or v = -conj (u); then the AGM is real or purely
+         imaginary, and the generic algorithm would not terminate */
+      kind = AGM_GENERAL;
+      if (mpfr_equal_p (mpc_realref (u), mpc_realref (v))) {
+         x [0] = mpc_imagref (v) [0];
+         MPFR_CHANGE_SIGN (x);
+         if (mpfr_equal_p (mpc_imagref (u), x))
+            kind = AGM_CONJ_POS;
+      }
+      else if (mpfr_equal_p (mpc_imagref (u), mpc_imagref (v))) {
+         x [0] = mpc_realref (v) [0];
+         MPFR_CHANGE_SIGN (x);
+         if (mpfr_equal_p (mpc_realref (u), x))
+            kind = AGM_CONJ_NEG;
+      }
+      /* the same may happen after the first step, as for u = 1 and
+         v = -3-4*i with a1 = -1-2*i and b1 = 1-2*i = -conj (a1) */
+      if (kind == AGM_GENERAL) {
+         kind = agm_conj_step (a1, u, v);
+         if (kind != AGM_GENERAL)
+            c = a1;
+      }
+   }
+
+   p = MPC_MAX_PREC (rop);
+   p += 2 * mpc_ceil_log2 (p) + 20;
+   mpc_pool_init2 (z, p);
+   mpc_pool_init2 (w, p);
+   mpc_pool_fr_init2 (one, MPFR_PREC_MIN);
+   mpfr_set_ui (one, 1, MPFR_RNDN);
+   for (loop = 1, ok = 0; !ok; loop++) {
+      mpc_pool_set_prec (b0, p);
+      mpc_pool_set_prec (z, p);
+      mpc_pool_set_prec (w, p);
+      if (kind == AGM_REAL) {
+         /* z = u * AGM (1, t) with v = t*u for some real t in ]0, 1[, and
+            the real AGM has a relative sensitivity at most 1 to t;
+            both parts of z have a relative error at most 4.1 * 2^(-p) */
+         mpc_div (b0, v, u, MPC_RNDZZ);
+         mpfr_agm (mpc_realref (w), one, mpc_realref (b0), MPFR_RNDN);
+         mpfr_mul (mpc_imagref (z), mpc_imagref (u), mpc_realref (w),
+                   MPFR_RNDN);
+         mpfr_mul (mpc_realref (z), mpc_realref (u), mpc_realref (w),
+                   MPFR_RNDN);
+         /* a zero part is -0 if and only if it is -0 in u and v, as for
+            the arithmetic mean */
+         if (mpfr_zero_p (mpc_realref (z)))
+            mpfr_add (mpc_realref (z), mpc_realref (u), mpc_realref (v),
+                      MPFR_RNDN);
+         if (mpfr_zero_p (mpc_imagref (z)))
+            mpfr_add (mpc_imagref (z), mpc_imagref (u), mpc_imagref (v),
+                      MPFR_RNDN);
+         ok = can_round_part (mpc_realref (z), 3, mpc_realref (rop),
+                              MPC_RND_RE (rnd))
+            && can_round_part (mpc_imagref (z), 3, mpc_imagref (rop),
+                               MPC_RND_IM (rnd));
+      }
+      else if (kind == AGM_CONJ_POS || kind == AGM_CONJ_NEG) {
+         /* For v = conj (c), the first step of the AGM of c and v yields
+            Re (c) and sign (Re (c)) * |c|; for v = -conj (c), it yields
+            i * Im (c) and i * sign (Im (c)) * |c|, where c is u, or a1 if
+            the conjugate pair appears after the first step. The relative
+            error of the real AGM is at most 2.01 * 2^(-p). */
+         mpfr_srcptr y = (kind == AGM_CONJ_POS ? mpc_realref (c)
+                          : mpc_imagref (c));
+         x [0] = y [0];
+         sign_a = mpfr_signbit (x);
+         if (sign_a)
+            MPFR_CHANGE_SIGN (x);
+         mpc_abs (mpc_realref (w), c, MPFR_RNDN);
+         mpfr_agm (mpc_realref (w), x, mpc_realref (w), MPFR_RNDN);
+         if (sign_a)
+            MPFR_CHANGE_SIGN (mpc_realref (w));
+         if (kind == AGM_CONJ_POS) {
+            mpfr_set (mpc_realref (z), mpc_realref (w), MPFR_RNDN);
+            mpfr_set_ui (mpc_imagref (z), 0, MPFR_RNDN);
+         }
+         else {
+            mpfr_set_ui (mpc_realref (z), 0, MPFR_RNDN);
+            mpfr_set (mpc_imagref (z), mpc_realref (w), MPFR_RNDN);
+         }
+         ok = can_round_part (mpc_realref (z), 2, mpc_realref (rop),
+                              MPC_RND_RE (rnd))
+            && can_round_part (mpc_imagref (z), 2, mpc_imagref (rop),
+                               MPC_RND_IM (rnd));
+      }
+      else {
+         /* work in the upper half plane with
+            AGM (1, conj (b0)) = conj (AGM (1, b0)); for b0 real negative,
+            this chooses the first geometric mean with positive imaginary
+            part */
+         mpc_div (b0, v, u, MPC_RNDZZ);
+         is_conj = mpfr_sgn (mpc_imagref (b0)) < 0;
+         mpfr_abs (mpc_imagref (b0), mpc_imagref (b0), MPFR_RNDN);
+         l = mpc_agm1_approx (w, b0);
+         if (l < p) {
+            if (is_conj)
+               mpc_conj (w, w, MPC_RNDNN);
+            mpc_mul (z, w, u, MPC_RNDNN);
+            ok = can_round_rel (z, p - l, rop, rnd);
+         }
+         else
+            ok = 0;
+      }
+      if (!ok)
+         p += (loop == 1 ? mpc_ceil_log2 (p) + 20 : p / 2);
+   }
+
+   inex = mpc_set (rop, z, rnd);
+   mpc_pool_fr_clear (one);
+   mpc_pool_clear (w);
+   mpc_pool_clear (z);
+   mpc_pool_clear (b0);
+   mpc_pool_clear (a1);
+
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_re = mpfr_check_range (mpc_realref (rop), MPC_INEX_RE (inex),
+                               MPC_RND_RE (rnd));
+   inex_im = mpfr_check_range (mpc_imagref (rop), MPC_INEX_IM (inex),
+                               MPC_RND_IM (rnd));
+   return MPC_INEX (inex_re, inex_im);
+}
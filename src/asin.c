@@ -80,6 +80,144 @@ mpc_asin_special (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, mpc_ptr z1)
   return 1;
 }
 
+/* Put in s approximations of Re(asin(z)) and Im(asin(z)) if is_acos is
+   zero, of Re(acos(z)) and Im(asin(z)) = -Im(acos(z)) otherwise, for z
+   with regular parts, using the real formulae of Hull, Fairgrieve and Tang:
+   with A = (|z+1| + |z-1|)/2 and x = |Re(z)|,
+   Re(asin(z)) = sign(Re(z)) * atan2(x, sqrt((A-x)(A+x))),
+   Re(acos(z)) = atan2(sqrt((A-x)(A+x)), Re(z)),
+   Im(asin(z)) = sign(Im(z)) * log1p((A-1) + sqrt((A-1)(A+1))),
+   where A-1 and A-x are computed as sums of non-negative terms, so that
+   no cancellation occurs near the branch points and the real axis (see
+   algorithms.tex). The parts of s have the same precision, and the
+   exponent range is assumed to be extended.
+   Return 1 if we can get the correct result by rounding s, 0 if not, and
+   -1 if the exponents of z are too large in absolute value for the
+   formulae to be used. */
+int
+mpc_asin_acos_regular (mpc_ptr s, mpc_srcptr z, mpc_srcptr rop,
+                       mpc_rnd_t rnd, int is_acos)
+{
+  mpfr_t x, y, a, b, r, t, u, v, w;
+  mpfr_prec_t p;
+  mpfr_exp_t ex, ey, emax;
+  int ok_re = 0, ok_im = 0;
+
+  /* with |ex|, |ey| <= emax/4, no intermediate result below is out of the
+     extended exponent range */
+  ex = mpfr_get_exp (mpc_realref (z));
+  ey = mpfr_get_exp (mpc_imagref (z));
+  emax = mpfr_get_emax_max () / 4;
+  if (ex > emax || ex < -emax || ey > emax || ey < -emax)
+    return -1;
+
+  p = mpfr_get_prec (mpc_realref (s));
+  MPC_ASSERT(mpfr_get_prec (mpc_imagref (s)) == p);
+  x[0] = mpc_realref (z)[0];
+  if (mpfr_signbit (x))
+    MPFR_CHANGE_SIGN (x);
+  y[0] = mpc_imagref (z)[0];
+  if (mpfr_signbit (y))
+    MPFR_CHANGE_SIGN (y);
+  mpc_pool_fr_init2 (a, p);
+  mpc_pool_fr_init2 (b, p);
+  mpc_pool_fr_init2 (r, p);
+  mpc_pool_fr_init2 (t, p);
+  mpc_pool_fr_init2 (u, p);
+  mpc_pool_fr_init2 (v, p);
+  mpc_pool_fr_init2 (w, p);
+
+  mpfr_add_ui (a, x, 1, MPFR_RNDN);
+  mpfr_sub_ui (b, x, 1, MPFR_RNDN);
+  mpfr_hypot (r, a, y, MPFR_RNDN); /* |x+1 + i*y| */
+  mpfr_hypot (t, b, y, MPFR_RNDN); /* |x-1 + i*y| */
+  mpfr_sqr (w, y, MPFR_RNDN);
+  /* u <- |x+1 + i*y| - (x+1) = y^2 / (|x+1 + i*y| + x+1) */
+  mpfr_add (u, r, a, MPFR_RNDN);
+  mpfr_div (u, w, u, MPFR_RNDN);
+  if (mpfr_sgn (b) <= 0)
+    {
+      /* t <- |x-1 + i*y| + (1-x), v <- |x-1 + i*y| - (1-x) = y^2 / t */
+      mpfr_sub (t, t, b, MPFR_RNDN);
+      mpfr_div (v, w, t, MPFR_RNDN);
+    }
+  else
+    {
+      /* v <- |x-1 + i*y| + (x-1), t <- |x-1 + i*y| - (x-1) = y^2 / v */
+      mpfr_add (v, t, b, MPFR_RNDN);
+      mpfr_div (t, w, v, MPFR_RNDN);
+    }
+  /* t <- A - x, u <- A - 1 */
+  mpfr_add (t, u, t, MPFR_RNDN);
+  mpfr_div_2ui (t, t, 1, MPFR_RNDN);
+  mpfr_add (u, u, v, MPFR_RNDN);
+  mpfr_div_2ui (u, u, 1, MPFR_RNDN);
+
+  /* real part, with A + x = (A-1) + (x+1) */
+  mpfr_add (v, u, a, MPFR_RNDN);
+  mpfr_mul (v, v, t, MPFR_RNDN);
+  mpfr_sqrt (v, v, MPFR_RNDN);
+  if (is_acos)
+    mpfr_atan2 (mpc_realref (s), v, mpc_realref (z), MPFR_RNDN);
+  else
+    {
+      mpfr_atan2 (mpc_realref (s), x, v, MPFR_RNDN);
+      if (mpfr_signbit (mpc_realref (z)))
+        MPFR_CHANGE_SIGN (mpc_realref (s));
+    }
+
+  /* imaginary part */
+  mpfr_add_ui (v, u, 2, MPFR_RNDN);
+  mpfr_mul (v, v, u, MPFR_RNDN);
+  mpfr_sqrt (v, v, MPFR_RNDN);
+  mpfr_add (v, v, u, MPFR_RNDN);
+  mpfr_log1p (mpc_imagref (s), v, MPFR_RNDN);
+  if (mpfr_signbit (mpc_imagref (z)))
+    MPFR_CHANGE_SIGN (mpc_imagref (s));
+
+  /* For x = 1 and tiny y, Im(asin(1+i*y)) = y^(1/2) * (1+d) and
+     Re(acos(1+i*y)) = y^(1/2) * (1-d') with 0 < d, d' < y/8; when y^(1/2)
+     is exactly representable, the Ziv loop would not terminate, but since
+     y <= 2^(-p) the results lie strictly between y^(1/2) and the next
+     floating-point number away from resp. towards zero in precision p.
+     With p >= prec(y) + 2, the latter are neither representable nor
+     midpoints in the target precisions. */
+  if (mpfr_cmp_ui (x, 1) == 0 && ey <= -p
+      && p >= mpfr_get_prec (y) + 2 && mpfr_sqrt (w, y, MPFR_RNDN) == 0)
+    {
+      mpfr_set (mpc_imagref (s), w, MPFR_RNDN);
+      mpfr_nextabove (mpc_imagref (s));
+      if (mpfr_signbit (mpc_imagref (z)))
+        MPFR_CHANGE_SIGN (mpc_imagref (s));
+      ok_im = 1;
+      if (is_acos && !mpfr_signbit (mpc_realref (z)))
+        {
+          mpfr_set (mpc_realref (s), w, MPFR_RNDN);
+          mpfr_nextbelow (mpc_realref (s));
+          ok_re = 1;
+        }
+    }
+
+  mpc_pool_fr_clear (a);
+  mpc_pool_fr_clear (b);
+  mpc_pool_fr_clear (r);
+  mpc_pool_fr_clear (t);
+  mpc_pool_fr_clear (u);
+  mpc_pool_fr_clear (v);
+  mpc_pool_fr_clear (w);
+
+  /* both parts have a relative error less than 11 * 2^(-p) */
+  ok_re = ok_re
+    || mpfr_can_round (mpc_realref (s), p - 4, MPFR_RNDN, MPFR_RNDZ,
+                       mpfr_get_prec (mpc_realref (rop)) +
+                       (MPC_RND_RE(rnd) == MPFR_RNDN));
+  ok_im = ok_im
+    || mpfr_can_round (mpc_imagref (s), p - 4, MPFR_RNDN, MPFR_RNDZ,
+                       mpfr_get_prec (mpc_imagref (rop)) +
+                       (MPC_RND_IM(rnd) == MPFR_RNDN));
+  return ok_re && ok_im;
+}
+
 /* Put in s an approximation of asin(z) using:
    asin z = z + 1/2*z^3/3 + (1*3)/(2*4)*z^5/5 + ...
    Assume |Re(z)|, |Im(z)| < 1/2.
@@ -198,73 +336,13 @@ mpc_asin_series (mpc_srcptr rop, mpc_ptr s, mpc_srcptr z, mpc_rnd_t rnd)
                          (MPC_RND_IM(rnd) == MPFR_RNDN));
 }
 
-/* Put in s an approximation of asin(z) for |Re(z)| < 1 and tiny Im(y)
-   (see algorithms.tex). Assume z = x + i*y:
-   |Re(asin(z)) - asin(x)| <= Pi*beta^2/(1-beta)
-   |Im(asin(z)) - y/sqrt(1-x^2)| <= Pi/2*beta^2/(1-beta)
-   where beta = |y|/(1-|x|).
-   We assume |x| >= 1/2 > |y| here, thus beta < 1, and the bounds
-   simplify to 16y^2.
-   Assume Re(s) and Im(s) have the same precision.
-   Return non-zero if we can get the correct result by rounding s:
-   mpc_set (rop, s, ...) */
-static int
-mpc_asin_tiny (mpc_srcptr rop, mpc_ptr s, mpc_srcptr z, mpc_rnd_t rnd)
-{
-  mpfr_exp_t ey, e1, e2, es;
-  mpfr_prec_t p = mpfr_get_prec (mpc_realref (s)), err;
-
-  ey = mpfr_get_exp (mpc_imagref (z));
-
-  MPC_ASSERT(mpfr_get_exp (mpc_realref (z)) >= 0); /* |x| >= 1/2 */
-  MPC_ASSERT(ey < 0);  /* |y| < 1/2 */
-
-  e2 = 2 * ey + 4;
-  /* for |x| >= 0.5, |asin x| >= 0.5, thus no need to compute asin(x)
-     if 16y^2 >= 1/2 ulp(1) for the target variable */
-  if (e2 >= - (mpfr_exp_t) mpfr_get_prec (mpc_realref (rop)))
-    return 0;
-
-  /* real part */
-  mpfr_asin (mpc_realref (s), mpc_realref (z), MPFR_RNDN);
-  /* check that we can round with error < 16y^2 */
-  e1 = mpfr_get_exp (mpc_realref (s)) - p;
-  err = (e1 >= e2) ? 0 : e2 - e1;
-  if (!mpfr_can_round (mpc_realref (s), p - err, MPFR_RNDN, MPFR_RNDZ,
-                       mpfr_get_prec (mpc_realref (rop)) +
-                       (MPC_RND_RE(rnd) == MPFR_RNDN)))
-    return 0;
-
-  /* now compute the approximate imaginary part y/sqrt(1-x^2) */
-  mpfr_sqr (mpc_imagref (s), mpc_realref (z), MPFR_RNDN);
-  /* now Im(s) approximates x^2, with 1/4 <= Im(s) <= 1 and absolute error
-     less than 2^-p */
-  mpfr_ui_sub (mpc_imagref (s), 1, mpc_imagref (s), MPFR_RNDN);
-  /* now Im(s) approximates 1-x^2, with 0 <= Im(s) <= 3/4, assuming p >= 2,
-     and absolute error less than 2^(1-p) */
-  mpfr_sqrt (mpc_imagref (s), mpc_imagref (s), MPFR_RNDN); /* sqrt(1-x^2) */
-  es = mpfr_get_exp (mpc_imagref (s));
-  /* now Im(s) approximates sqrt(1-x^2), with 0 <= Im(s) <= 7/8,
-     assuming p >= 3, and absolute error less than 2^-p + 2^(1-p)/s
-     <= 3*2^-p/s, thus relative error less than 3*2^-p/s^2.
-     Since |s| >= 2^(es-1), the relative error is less than 3*2^(-p+2-2*es) */
-  mpfr_div (mpc_imagref (s), mpc_imagref (z), mpc_imagref (s), MPFR_RNDN);
-  /* now Im(s) approximates y/sqrt(1-x^2), with relative error less than
-     (3*2^(2-2*es)+2)*2^-p. Since es <= 0, 2-2*es >= 2, thus the relative
-     error is less than 2^(4-2*es-p) */
-  err = 4 - 2 * es;
-  return mpfr_can_round (mpc_imagref (s), p - err, MPFR_RNDN, MPFR_RNDZ,
-                         mpfr_get_prec (mpc_imagref (rop)) +
-                         (MPC_RND_IM(rnd) == MPFR_RNDN));
-}
-
 int
 mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
   mpfr_prec_t p, p_re, p_im;
   mpfr_rnd_t rnd_re, rnd_im;
   mpc_t z1;
-  int inex, inex_re, inex_im, loop = 0;
+  int inex, inex_re, inex_im, loop = 0, regular = 1;
   mpfr_exp_t saved_emin, saved_emax, err, olderr;
 
   /* special values */
@@ -377,13 +455,13 @@ mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
   mpfr_set_emin (mpfr_get_emin_min ());
   mpfr_set_emax (mpfr_get_emax_max ());
 
-  /* regular complex: asin(z) = -i*log(i*z+sqrt(1-z^2)) */
+  /* regular complex */
   p_re = mpfr_get_prec (mpc_realref(rop));
   p_im = mpfr_get_prec (mpc_imagref(rop));
   rnd_re = MPC_RND_RE(rnd);
   rnd_im = MPC_RND_IM(rnd);
   p = p_re >= p_im ? p_re : p_im;
-  mpc_init2 (z1, p);
+  mpc_pool_init2 (z1, p);
   olderr = err = 0; /* number of lost bits */
   while (1)
   {
@@ -393,8 +471,7 @@ mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
     p += err - olderr; /* add extra number of lost bits in previous loop */
     olderr = err;
     p += (loop <= 2) ? mpc_ceil_log2 (p) + 3 : p / 2;
-    mpfr_set_prec (mpc_realref(z1), p);
-    mpfr_set_prec (mpc_imagref(z1), p);
+    mpc_pool_set_prec (z1, p);
 
     /* try special code for 1+i*y with tiny y */
     if (loop == 1 && mpfr_cmp_ui (mpc_realref(op), 1) == 0 &&
@@ -407,12 +484,19 @@ mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
         mpc_asin_series (rop, z1, op, rnd))
       break;
 
-    /* try special code for 1/2 <= |x| < 1 and |y| < 1/2 */
-    if (mpfr_get_exp (mpc_realref (op)) == 0 &&
-        mpfr_get_exp (mpc_imagref (op)) <= -1 &&
-        mpc_asin_tiny (rop, z1, op, rnd))
-      break;
+    /* real formulae, accurate near the branch points and the real axis */
+    if (regular)
+      {
+        regular = mpc_asin_acos_regular (z1, op, rop, rnd, 0);
+        if (regular > 0)
+          break;
+        regular = (regular == 0);
+        if (regular)
+          continue;
+      }
 
+    /* for exponents too large in absolute value:
+       asin(z) = -i*log(i*z+sqrt(1-z^2)) */
     /* z1 <- z^2 */
     mpc_sqr (z1, op, MPC_RNDNN);
     /* err(x) <= 1/2 ulp(x), err(y) <= 1/2 ulp(y) */
@@ -480,7 +564,7 @@ mpc_asin (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
   }
 
   inex = mpc_set (rop, z1, rnd);
-  mpc_clear (z1);
+  mpc_pool_clear (z1);
 
   /* restore the exponent range, and check the range of results */
   mpfr_set_emin (saved_emin);
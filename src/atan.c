@@ -221,179 +221,118 @@ mpc_atan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 
   /* regular number argument */
   {
-    mpfr_t a, b, x, y;
+    mpfr_t a, b, x, y, one, two_x, xx, yy, abs_op_im;
+    mpfr_ptr t[3];
     mpfr_prec_t prec, p;
-    mpfr_exp_t err, expo;
-    int ok = 0;
-    mpfr_t minus_op_re;
-    mpfr_exp_t op_re_exp, op_im_exp;
-    mpfr_rnd_t rnd1, rnd2;
-
-    mpfr_inits2 (MPFR_PREC_MIN, a, b, x, y, (mpfr_ptr) 0);
-
-    /* real part: Re(arctan(x+i*y)) = [arctan2(x,1-y) - arctan2(-x,1+y)]/2 */
-    minus_op_re[0] = mpc_realref (op)[0];
-    MPFR_CHANGE_SIGN (minus_op_re);
-    op_re_exp = mpfr_get_exp (mpc_realref (op));
-    op_im_exp = mpfr_get_exp (mpc_imagref (op));
-
+    int ok, underflow_im = 0;
+
+    mpfr_inits2 (MPFR_PREC_MIN, a, b, x, y, one, (mpfr_ptr) 0);
+    mpfr_init2 (two_x, mpfr_get_prec (mpc_realref (op)));
+    mpfr_init2 (xx, 2 * mpfr_get_prec (mpc_realref (op)));
+    mpfr_init2 (yy, 2 * mpfr_get_prec (mpc_imagref (op)));
+
+    /* exact values */
+    mpfr_set_ui (one, 1, MPFR_RNDN);
+    mpfr_mul_2ui (two_x, mpc_realref (op), 1, MPFR_RNDN);
+    mpfr_sqr (xx, mpc_realref (op), MPFR_RNDN);
+    mpfr_neg (xx, xx, MPFR_RNDN);
+    mpfr_sqr (yy, mpc_imagref (op), MPFR_RNDN);
+    mpfr_neg (yy, yy, MPFR_RNDN);
+    t[0] = one;
+    t[1] = xx;
+    t[2] = yy;
+    abs_op_im[0] = mpc_imagref (op)[0];
+    if (s_im)
+      MPFR_CHANGE_SIGN (abs_op_im);
+
+    /* real part: Re(atan(x+i*y)) = atan2(2x, 1-x^2-y^2)/2, with
+       a = o(1-x^2-y^2)    rounded once by mpfr_sum from exact terms
+       b = o(atan2(2x,a))  error(b) <= 3 ulp(b), see algorithms.tex,
+       whatever the cancellation in 1-x^2-y^2 */
     prec = mpfr_get_prec (mpc_realref (rop)); /* result precision */
-
-    /* a = o(1-y)         error(a) < 1 ulp(a)
-       b = o(atan2(x,a))  error(b) < [1+2^{3+Exp(x)-Exp(a)-Exp(b)}] ulp(b)
-                                     = kb ulp(b)
-       c = o(1+y)         error(c) < 1 ulp(c)
-       d = o(atan2(-x,c)) error(d) < [1+2^{3+Exp(x)-Exp(c)-Exp(d)}] ulp(d)
-                                     = kd ulp(d)
-       e = o(b - d)       error(e) < [1 + kb*2^{Exp(b}-Exp(e)}
-                                        + kd*2^{Exp(d)-Exp(e)}] ulp(e)
-                          error(e) < [1 + 2^{4+Exp(x)-Exp(a)-Exp(e)}
-                                        + 2^{4+Exp(x)-Exp(c)-Exp(e)}] ulp(e)
-                          because |atan(u)| < |u|
-                                   < [1 + 2^{5+Exp(x)-min(Exp(a),Exp(c))
-                                             -Exp(e)}] ulp(e)
-       f = e/2            exact
-    */
-
-    /* p: working precision */
-    p = (op_im_exp > 0 || prec > SAFE_ABS (mpfr_prec_t, op_im_exp)) ? prec
-      : (prec - op_im_exp);
-    rnd1 = mpfr_sgn (mpc_realref (op)) > 0 ? MPFR_RNDD : MPFR_RNDU;
-    rnd2 = mpfr_sgn (mpc_realref (op)) < 0 ? MPFR_RNDU : MPFR_RNDD;
+    p = prec + mpc_ceil_log2 (prec) + 2; /* working precision */
 
     do
       {
-        p += mpc_ceil_log2 (p) + 2;
         mpfr_set_prec (a, p);
-        mpfr_set_prec (b, p);
         mpfr_set_prec (x, p);
 
-        /* x = upper bound for atan (x/(1-y)). Since atan is increasing, we
-           need an upper bound on x/(1-y), i.e., a lower bound on 1-y for
-           x positive, and an upper bound on 1-y for x negative */
-        mpfr_ui_sub (a, 1, mpc_imagref (op), rnd1);
-        if (mpfr_sgn (a) == 0) /* y is near 1, thus 1+y is near 2, and
-                                  expo will be 1 or 2 below */
-          {
-            MPC_ASSERT (mpfr_cmp_ui (mpc_imagref(op), 1) == 0);
-               /* check for intermediate underflow */
-            err = 2; /* ensures err will be expo below */
-          }
-        else
-          err = mpfr_get_exp (a); /* err = Exp(a) with the notations above */
-        mpfr_atan2 (x, mpc_realref (op), a, MPFR_RNDU);
-
-        /* b = lower bound for atan (-x/(1+y)): for x negative, we need a
-           lower bound on -x/(1+y), i.e., an upper bound on 1+y */
-        mpfr_add_ui (a, mpc_imagref(op), 1, rnd2);
-        /* if a is exactly zero, i.e., Im(op) = -1, then the error on a is 0,
-           and we can simply ignore the terms involving Exp(a) in the error */
-        if (mpfr_sgn (a) == 0)
-          {
-            MPC_ASSERT (mpfr_cmp_si (mpc_imagref(op), -1) == 0);
-               /* check for intermediate underflow */
-            expo = err; /* will leave err unchanged below */
-          }
-        else
-          expo = mpfr_get_exp (a); /* expo = Exp(c) with the notations above */
-        mpfr_atan2 (b, minus_op_re, a, MPFR_RNDD);
-
-        err = err < expo ? err : expo; /* err = min(Exp(a),Exp(c)) */
-        mpfr_sub (x, x, b, MPFR_RNDU);
-
-        err = 5 + op_re_exp - err - mpfr_get_exp (x);
-        /* error is bounded by [1 + 2^err] ulp(e) */
-        err = err < 0 ? 1 : err + 1;
-
-        mpfr_div_2ui (x, x, 1, MPFR_RNDU);
-
-        /* Note: using RND2=RNDD guarantees that if x is exactly representable
-           on prec + ... bits, mpfr_can_round will return 0 */
-        ok = mpfr_can_round (x, p - err, MPFR_RNDU, MPFR_RNDD,
+        mpfr_sum (a, t, 3, MPFR_RNDN);
+        mpfr_atan2 (x, two_x, a, MPFR_RNDN);
+
+        ok = mpfr_can_round (x, p - 2, MPFR_RNDN, MPFR_RNDZ,
                              prec + (MPC_RND_RE (rnd) == MPFR_RNDN));
+        if (!ok)
+          p += p / 2;
       } while (ok == 0);
+    mpfr_div_2ui (x, x, 1, MPFR_RNDN);
 
     /* Imaginary part
-       Im(atan(x+I*y)) = 1/4 * [log(x^2+(1+y)^2) - log (x^2 +(1-y)^2)] */
+       Im(atan(x+I*y)) = sign(y)/4 * log1p (4|y| / (x^2 + (1-|y|)^2)), with
+       a = o(1-|y|)
+       b = o(x^2 + a^2)     rounded once by mpfr_fmma
+       y = o(4|y|/b)        relative error at most 4.1 * 2^(-p)
+       y = o(log1p(y))      error(y) <= 6 ulp(y), see algorithms.tex;
+       since the argument of log1p is non-negative, no cancellation occurs,
+       even for tiny y. */
     prec = mpfr_get_prec (mpc_imagref (rop)); /* result precision */
+    p = MPC_MAX (prec, mpfr_get_prec (mpc_imagref (op))) + 2;
 
-    /* a = o(1+y)    error(a) < 1 ulp(a)
-       b = o(a^2)    error(b) < 5 ulp(b)
-       c = o(x^2)    error(c) < 1 ulp(c)
-       d = o(b+c)    error(d) < 7 ulp(d)
-       e = o(log(d)) error(e) < [1 + 7*2^{2-Exp(e)}] ulp(e) = ke ulp(e)
-       f = o(1-y)    error(f) < 1 ulp(f)
-       g = o(f^2)    error(g) < 5 ulp(g)
-       h = o(c+f)    error(h) < 7 ulp(h)
-       i = o(log(h)) error(i) < [1 + 7*2^{2-Exp(i)}] ulp(i) = ki ulp(i)
-       j = o(e-i)    error(j) < [1 + ke*2^{Exp(e)-Exp(j)}
-                                   + ki*2^{Exp(i)-Exp(j)}] ulp(j)
-                     error(j) < [1 + 2^{Exp(e)-Exp(j)} + 2^{Exp(i)-Exp(j)}
-                                   + 7*2^{3-Exp(j)}] ulp(j)
-                              < [1 + 2^{max(Exp(e),Exp(i))-Exp(j)+1}
-                                   + 7*2^{3-Exp(j)}] ulp(j)
-       k = j/4       exact
-    */
-    err = 2;
-    p = prec; /* working precision */
-
-    do
+    if (mpfr_cmpabs_ui (mpc_realref (op), 1) == 0
+        && mpfr_get_exp (mpc_imagref (op)) <= - (p + 1) / 2)
       {
-        p += mpc_ceil_log2 (p) + err;
-        mpfr_set_prec (a, p);
-        mpfr_set_prec (b, p);
+        /* Special case x = +/-1 and 2*Exp(y) <= -p: we have
+           0 < |y|/2 - |Im(atan(x+I*y))| < |y|^3/8 <= |y|/2 * 2^(-p-1),
+           and |y|/2 is exactly representable, so that the imaginary part
+           rounds as |y|/2 decreased by one ulp at precision p, see
+           algorithms.tex; otherwise the Ziv loop below would need a
+           precision of about -2*Exp(y). */
         mpfr_set_prec (y, p);
-
-        /* a = upper bound for log(x^2 + (1+y)^2) */
-        mpfr_add_ui (a, mpc_imagref (op), 1, MPFR_RNDA);
-        mpfr_sqr (a, a, MPFR_RNDU);
-        mpfr_sqr (y, mpc_realref (op), MPFR_RNDU);
-        mpfr_add (a, a, y, MPFR_RNDU);
-        mpfr_log (a, a, MPFR_RNDU);
-
-        /* b = lower bound for log(x^2 + (1-y)^2) */
-        mpfr_ui_sub (b, 1, mpc_imagref (op), MPFR_RNDZ); /* round to zero */
-        mpfr_sqr (b, b, MPFR_RNDZ);
-        /* we could write mpfr_sqr (y, mpc_realref (op), MPFR_RNDZ) but it is
-           more efficient to reuse the value of y (x^2) above and subtract
-           one ulp */
+        mpfr_mul_2ui (y, abs_op_im, 1, MPFR_RNDN);
         mpfr_nextbelow (y);
-        mpfr_add (b, b, y, MPFR_RNDZ);
-        mpfr_log (b, b, MPFR_RNDZ);
-
-        mpfr_sub (y, a, b, MPFR_RNDU);
+      }
+    else
+      {
+        p = prec + mpc_ceil_log2 (prec) + 3; /* working precision */
 
-        if (mpfr_zero_p (y))
-           /* FIXME: happens when x and y have very different magnitudes;
-              could be handled more efficiently                           */
-          ok = 0;
-        else
+        do
           {
-            expo = MPC_MAX (mpfr_get_exp (a), mpfr_get_exp (b));
-            expo = expo - mpfr_get_exp (y) + 1;
-            err = 3 - mpfr_get_exp (y);
-            /* error(j) <= [1 + 2^expo + 7*2^err] ulp(j) */
-            if (expo <= err) /* error(j) <= [1 + 2^{err+1}] ulp(j) */
-              err = (err < 0) ? 1 : err + 2;
+            mpfr_set_prec (a, p);
+            mpfr_set_prec (b, p);
+            mpfr_set_prec (y, p);
+
+            mpfr_ui_sub (a, 1, abs_op_im, MPFR_RNDN);
+            mpfr_fmma (b, mpc_realref (op), mpc_realref (op), a, a, MPFR_RNDN);
+            mpfr_div (y, abs_op_im, b, MPFR_RNDN);
+            mpfr_mul_2ui (y, y, 2, MPFR_RNDN);
+
+            if (mpfr_zero_p (y))
+              {
+                /* 4|y|/(x^2 + (1-|y|)^2) underflows in the extended exponent
+                   range, and so does the imaginary part in any range */
+                underflow_im = 1;
+                ok = 1;
+              }
             else
-              err = (expo < 0) ? 1 : expo + 2;
-
-            mpfr_div_2ui (y, y, 2, MPFR_RNDN);
-            MPC_ASSERT (!mpfr_zero_p (y));
-               /* FIXME: underflow. Since the main term of the Taylor series
-                  in y=0 is 1/(x^2+1) * y, this means that y is very small
-                  and/or x very large; but then the mpfr_zero_p (y) above
-                  should be true. This needs a proof, or better yet,
-                  special code.                                              */
-
-            ok = mpfr_can_round (y, p - err, MPFR_RNDU, MPFR_RNDD,
-                                 prec + (MPC_RND_IM (rnd) == MPFR_RNDN));
-          }
-      } while (ok == 0);
+              {
+                mpfr_log1p (y, y, MPFR_RNDN);
+                ok = mpfr_can_round (y, p - 3, MPFR_RNDN, MPFR_RNDZ,
+                                     prec + (MPC_RND_IM (rnd) == MPFR_RNDN));
+                if (!ok)
+                  p += p / 2;
+              }
+          } while (ok == 0);
+      }
+    mpfr_div_2ui (y, y, 2, MPFR_RNDN);
+    if (s_im)
+      MPFR_CHANGE_SIGN (y);
 
     inex = mpc_set_fr_fr (rop, x, y, rnd);
+    if (underflow_im)
+      inex = MPC_INEX (MPC_INEX_RE (inex),
+                       mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd)));
 
-    mpfr_clears (a, b, x, y, (mpfr_ptr) 0);
+    mpfr_clears (a, b, x, y, one, two_x, xx, yy, (mpfr_ptr) 0);
 
     /* restore the exponent range, and check the range of results */
     mpfr_set_emin (saved_emin);
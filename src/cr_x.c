@@ -0,0 +1,241 @@
+/* mpc_cr_x -- Correctly rounded functions on C complex numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "config.h"
+#include <float.h>
+
+#ifdef HAVE_COMPLEX_H
+# include <complex.h>
+#endif
+
+#ifdef HAVE_MPFR_FLOAT128
+# define MPFR_WANT_FLOAT128
+#endif
+
+#include "mpc-impl.h"
+
+#ifdef HAVE_COMPLEX_H
+
+/* The functions in this file return the rounding to nearest of f (z) in
+   the format of z, including subnormal numbers, as mpcheck does to check
+   the C library: the operands are converted exactly into variables of the
+   precision of the format, the GNU MPC function is evaluated in the
+   exponent range of the format, and its result is rounded to subnormal
+   numbers by mpfr_subnormalize using its ternary value, which avoids a
+   double rounding. The operands and the result live on the stack, but
+   the called functions may allocate their temporary variables.
+   For the square root in binary32 and binary64, the double-double
+   evaluation of sqrt_fp.c is tried first. */
+
+/* binary128 has 113 bits and the same exponent range as the x87 format */
+#define F128_MANT_DIG 113
+#define F128_MIN_EXP  (-16381)
+#define F128_MAX_EXP  16384
+
+/* the exponent of the smallest positive subnormal number in the MPFR
+   convention, with significands in [1/2, 1) */
+#define CR_EMIN(min_exp, mant_dig) ((min_exp) - (mant_dig) + 1)
+
+/* parts of a C complex number, which has the representation of an array
+   of two real numbers */
+#define CR_RE(T, z) (((T *) &(z)) [0])
+#define CR_IM(T, z) (((T *) &(z)) [1])
+
+typedef int (*cr_fun1) (mpc_ptr, mpc_srcptr, mpc_rnd_t);
+typedef int (*cr_fun2) (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+
+/* Set rop to f (op), or to g (op, op2) if f is NULL, rounded to nearest in
+   the format with the precision of rop and the exponent range [emin, emax],
+   including subnormal numbers. */
+static void
+cr_eval (mpc_ptr rop, mpc_srcptr op, mpc_srcptr op2, cr_fun1 f, cr_fun2 g,
+         mpfr_exp_t emin, mpfr_exp_t emax)
+{
+  mpfr_exp_t saved_emin = mpfr_get_emin (), saved_emax = mpfr_get_emax ();
+  int inex;
+
+  mpfr_set_emin (emin);
+  mpfr_set_emax (emax);
+  inex = (f != NULL) ? f (rop, op, MPC_RNDNN) : g (rop, op, op2, MPC_RNDNN);
+  mpfr_subnormalize (mpc_realref (rop), MPC_INEX_RE (inex), MPFR_RNDN);
+  mpfr_subnormalize (mpc_imagref (rop), MPC_INEX_IM (inex), MPFR_RNDN);
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+}
+
+static float _Complex
+cr_f (cr_fun1 f, cr_fun2 g, float _Complex z, float _Complex w)
+{
+  float _Complex r;
+  double re, im;
+  MPC_DECL_INIT (x, FLT_MANT_DIG);
+  MPC_DECL_INIT (y, FLT_MANT_DIG);
+  MPC_DECL_INIT (v, FLT_MANT_DIG);
+
+  if (f == mpc_sqrt
+      && mpc_sqrt_native (&re, &im, CR_RE (float, z), CR_IM (float, z), 24))
+    {
+      CR_RE (float, r) = (float) re;
+      CR_IM (float, r) = (float) im;
+      return r;
+    }
+
+  mpfr_set_flt (mpc_realref (x), CR_RE (float, z), MPFR_RNDN);
+  mpfr_set_flt (mpc_imagref (x), CR_IM (float, z), MPFR_RNDN);
+  mpfr_set_flt (mpc_realref (y), CR_RE (float, w), MPFR_RNDN);
+  mpfr_set_flt (mpc_imagref (y), CR_IM (float, w), MPFR_RNDN);
+  cr_eval (v, x, y, f, g, CR_EMIN (FLT_MIN_EXP, FLT_MANT_DIG), FLT_MAX_EXP);
+  CR_RE (float, r) = mpfr_get_flt (mpc_realref (v), MPFR_RNDN);
+  CR_IM (float, r) = mpfr_get_flt (mpc_imagref (v), MPFR_RNDN);
+  return r;
+}
+
+static double _Complex
+cr_d (cr_fun1 f, cr_fun2 g, double _Complex z, double _Complex w)
+{
+  double _Complex r;
+  MPC_DECL_INIT (x, DBL_MANT_DIG);
+  MPC_DECL_INIT (y, DBL_MANT_DIG);
+  MPC_DECL_INIT (v, DBL_MANT_DIG);
+
+  if (f == mpc_sqrt
+      && mpc_sqrt_native (&CR_RE (double, r), &CR_IM (double, r),
+                          CR_RE (double, z), CR_IM (double, z), 53))
+    return r;
+
+  mpfr_set_d (mpc_realref (x), CR_RE (double, z), MPFR_RNDN);
+  mpfr_set_d (mpc_imagref (x), CR_IM (double, z), MPFR_RNDN);
+  mpfr_set_d (mpc_realref (y), CR_RE (double, w), MPFR_RNDN);
+  mpfr_set_d (mpc_imagref (y), CR_IM (double, w), MPFR_RNDN);
+  cr_eval (v, x, y, f, g, CR_EMIN (DBL_MIN_EXP, DBL_MANT_DIG), DBL_MAX_EXP);
+  CR_RE (double, r) = mpfr_get_d (mpc_realref (v), MPFR_RNDN);
+  CR_IM (double, r) = mpfr_get_d (mpc_imagref (v), MPFR_RNDN);
+  return r;
+}
+
+static long double _Complex
+cr_ld (cr_fun1 f, cr_fun2 g, long double _Complex z, long double _Complex w)
+{
+  long double _Complex r;
+  MPC_DECL_INIT (x, LDBL_MANT_DIG);
+  MPC_DECL_INIT (y, LDBL_MANT_DIG);
+  MPC_DECL_INIT (v, LDBL_MANT_DIG);
+
+  mpfr_set_ld (mpc_realref (x), CR_RE (long double, z), MPFR_RNDN);
+  mpfr_set_ld (mpc_imagref (x), CR_IM (long double, z), MPFR_RNDN);
+  mpfr_set_ld (mpc_realref (y), CR_RE (long double, w), MPFR_RNDN);
+  mpfr_set_ld (mpc_imagref (y), CR_IM (long double, w), MPFR_RNDN);
+  cr_eval (v, x, y, f, g, CR_EMIN (LDBL_MIN_EXP, LDBL_MANT_DIG), LDBL_MAX_EXP);
+  CR_RE (long double, r) = mpfr_get_ld (mpc_realref (v), MPFR_RNDN);
+  CR_IM (long double, r) = mpfr_get_ld (mpc_imagref (v), MPFR_RNDN);
+  return r;
+}
+
+#ifdef HAVE_MPFR_FLOAT128
+static _Float128 _Complex
+cr_f128 (cr_fun1 f, cr_fun2 g, _Float128 _Complex z, _Float128 _Complex w)
+{
+  _Float128 _Complex r;
+  MPC_DECL_INIT (x, F128_MANT_DIG);
+  MPC_DECL_INIT (y, F128_MANT_DIG);
+  MPC_DECL_INIT (v, F128_MANT_DIG);
+
+  mpfr_set_float128 (mpc_realref (x), CR_RE (_Float128, z), MPFR_RNDN);
+  mpfr_set_float128 (mpc_imagref (x), CR_IM (_Float128, z), MPFR_RNDN);
+  mpfr_set_float128 (mpc_realref (y), CR_RE (_Float128, w), MPFR_RNDN);
+  mpfr_set_float128 (mpc_imagref (y), CR_IM (_Float128, w), MPFR_RNDN);
+  cr_eval (v, x, y, f, g, CR_EMIN (F128_MIN_EXP, F128_MANT_DIG), F128_MAX_EXP);
+  CR_RE (_Float128, r) = mpfr_get_float128 (mpc_realref (v), MPFR_RNDN);
+  CR_IM (_Float128, r) = mpfr_get_float128 (mpc_imagref (v), MPFR_RNDN);
+  return r;
+}
+
+#define MPC_CR_1_F128(name)                                             \
+  _Float128 _Complex                                                    \
+  mpc_cr_c ## name ## f128 (_Float128 _Complex z)                       \
+  {                                                                     \
+    return cr_f128 (mpc_ ## name, NULL, z, z);                          \
+  }
+
+_Float128 _Complex
+mpc_cr_cpowf128 (_Float128 _Complex z, _Float128 _Complex w)
+{
+  return cr_f128 (NULL, mpc_pow, z, w);
+}
+#else
+#define MPC_CR_1_F128(name)
+#endif
+
+#define MPC_CR_1(name)                                                  \
+  float _Complex                                                        \
+  mpc_cr_c ## name ## f (float _Complex z)                              \
+  {                                                                     \
+    return cr_f (mpc_ ## name, NULL, z, z);                             \
+  }                                                                     \
+                                                                        \
+  double _Complex                                                       \
+  mpc_cr_c ## name (double _Complex z)                                  \
+  {                                                                     \
+    return cr_d (mpc_ ## name, NULL, z, z);                             \
+  }                                                                     \
+                                                                        \
+  long double _Complex                                                  \
+  mpc_cr_c ## name ## l (long double _Complex z)                        \
+  {                                                                     \
+    return cr_ld (mpc_ ## name, NULL, z, z);                            \
+  }                                                                     \
+                                                                        \
+  MPC_CR_1_F128 (name)
+
+MPC_CR_1 (sqrt)
+MPC_CR_1 (exp)
+MPC_CR_1 (log)
+MPC_CR_1 (sin)
+MPC_CR_1 (cos)
+MPC_CR_1 (tan)
+MPC_CR_1 (sinh)
+MPC_CR_1 (cosh)
+MPC_CR_1 (tanh)
+MPC_CR_1 (asin)
+MPC_CR_1 (acos)
+MPC_CR_1 (atan)
+MPC_CR_1 (asinh)
+MPC_CR_1 (acosh)
+MPC_CR_1 (atanh)
+
+float _Complex
+mpc_cr_cpowf (float _Complex z, float _Complex w)
+{
+  return cr_f (NULL, mpc_pow, z, w);
+}
+
+double _Complex
+mpc_cr_cpow (double _Complex z, double _Complex w)
+{
+  return cr_d (NULL, mpc_pow, z, w);
+}
+
+long double _Complex
+mpc_cr_cpowl (long double _Complex z, long double _Complex w)
+{
+  return cr_ld (NULL, mpc_pow, z, w);
+}
+
+#endif /* HAVE_COMPLEX_H */
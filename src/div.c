@@ -229,10 +229,187 @@ mpc_div_imag (mpc_ptr rop, mpc_srcptr z, mpc_srcptr w, mpc_rnd_t rnd)
    return MPC_INEX(inex_re, inex_im);
 }
 
-#define MPFR_EXP(x)       ((x)->_mpfr_exp)
+/* Return the precision at which x*y + z*t is exact, where x, y, z and t
+   are finite, or the precision of x*y if z is NULL. */
+static mpfr_prec_t
+fmma_prec (mpfr_srcptr x, mpfr_srcptr y, mpfr_srcptr z, mpfr_srcptr t)
+{
+   int xy = !mpfr_zero_p (x) && !mpfr_zero_p (y);
+   int zt = z != NULL && !mpfr_zero_p (z) && !mpfr_zero_p (t);
+   mpfr_exp_t hi1 = 0, lo1 = 0, hi2 = 0, lo2 = 0;
+
+   if (xy) {
+      hi1 = mpfr_get_exp (x) + mpfr_get_exp (y);
+      lo1 = hi1 - mpfr_get_prec (x) - mpfr_get_prec (y);
+   }
+   if (zt) {
+      hi2 = mpfr_get_exp (z) + mpfr_get_exp (t);
+      lo2 = hi2 - mpfr_get_prec (z) - mpfr_get_prec (t);
+   }
+
+   if (xy && zt)
+      return MPC_MAX (hi1, hi2) - MPC_MIN (lo1, lo2) + 1;
+   else if (xy)
+      return hi1 - lo1;
+   else if (zt)
+      return hi2 - lo2;
+   else
+      return MPFR_PREC_MIN;
+}
 
+/* Return non-zero if x is zero or its exponent is at most 1/8 of the
+   largest possible exponent in absolute value. */
+static int
+small_exp (mpfr_srcptr x)
+{
+   return mpfr_zero_p (x)
+          || SAFE_ABS (mpfr_exp_t, mpfr_get_exp (x)) <= mpfr_get_emax_max () / 8;
+}
+
+/* Try to set a to b/c, or to 1/c if b is NULL, where b is finite and both
+   parts of c are regular numbers. The quotient is b*conj(c)/norm(c), where
+   the parts of the numerator and the norm are computed at a working
+   precision w by mpfr_fmma and mpfr_fmms, which round the exact values
+   once. When this requires at most 2w bits, they are computed exactly
+   instead, so that each part of the quotient is correctly rounded by a
+   single division. Otherwise, the relative error of each of the three
+   roundings to w bits is at most 2^(-w), so that the error of the quotient
+   is less than 3.01 * 2^(-w) times its absolute value, that is, less than
+   4 ulps; the working precision is increased in the rare case where the
+   quotient cannot be rounded.
+   The computations are done in the largest possible exponent range, in
+   which they can neither overflow nor underflow if the exponents of the
+   operands are at most 1/8 of the largest exponent in absolute value.
+   Return 0 if this is not the case, in which case a is not modified;
+   otherwise store the ternary value into *inex. */
 int
-mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
+mpc_div_fmma (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd, int *inex)
+{
+   mpfr_srcptr cre = mpc_realref (c), cim = mpc_imagref (c);
+   mpfr_t n, x [2], t, cim_neg;
+   mpc_t tmp;
+   mpc_ptr dest;
+   mpfr_ptr q [2];
+   mpfr_prec_t w, p;
+   mpfr_rnd_t r [2];
+   mpfr_exp_t saved_emin, saved_emax;
+   int inex_n, inex_x, inex_q [2], ok [2], k;
+
+   if (!small_exp (cre) || !small_exp (cim)
+       || (b != NULL && (!small_exp (mpc_realref (b))
+                         || !small_exp (mpc_imagref (b)))))
+      return 0;
+
+   /* the operands are read in each loop, so that we need a temporary
+      result if a is the same variable as one of them */
+   if (a == b || a == c) {
+      mpc_pool_init3 (tmp, MPC_PREC_RE (a), MPC_PREC_IM (a));
+      dest = tmp;
+   }
+   else
+      dest = a;
+   q [0] = mpc_realref (dest);
+   q [1] = mpc_imagref (dest);
+   r [0] = MPC_RND_RE (rnd);
+   r [1] = MPC_RND_IM (rnd);
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+
+   /* for 1/c, the numerator is conj(c) */
+   cim_neg [0] = cim [0];
+   MPFR_CHANGE_SIGN (cim_neg);
+
+   p = MPC_MAX_PREC (a);
+   w = p + mpc_ceil_log2 (p) + 5;
+   mpc_pool_fr_init2 (n, w);
+   mpc_pool_fr_init2 (x [0], w);
+   mpc_pool_fr_init2 (x [1], w);
+   mpc_pool_fr_init2 (t, w);
+   inex_n = 1;
+   ok [0] = ok [1] = 0;
+
+   while (1) {
+      if (inex_n != 0) {
+         mpfr_prec_t pn = fmma_prec (cre, cre, cim, cim);
+         mpc_pool_fr_set_prec (n, pn <= 2 * w ? pn : w);
+         inex_n = mpfr_fmma (n, cre, cre, cim, cim, MPFR_RNDN);
+      }
+
+      for (k = 0; k < 2; k++) {
+         mpfr_srcptr num;
+
+         if (ok [k])
+            continue;
+
+         if (b == NULL) {
+            num = (k == 0) ? cre : cim_neg;
+            inex_x = 0;
+         }
+         else {
+            mpfr_srcptr bre = mpc_realref (b), bim = mpc_imagref (b);
+            mpfr_prec_t px;
+
+            if (k == 0) {
+               px = fmma_prec (bre, cre, bim, cim);
+               mpc_pool_fr_set_prec (x [0], px <= 2 * w ? px : w);
+               inex_x = mpfr_fmma (x [0], bre, cre, bim, cim, MPFR_RNDN);
+            }
+            else {
+               px = fmma_prec (bim, cre, bre, cim);
+               mpc_pool_fr_set_prec (x [1], px <= 2 * w ? px : w);
+               inex_x = mpfr_fmms (x [1], bim, cre, bre, cim, MPFR_RNDN);
+            }
+            num = x [k];
+         }
+
+         if (inex_x == 0 && (inex_n == 0 || mpfr_zero_p (num))) {
+            /* a single rounding of the exact quotient */
+            inex_q [k] = mpfr_div (q [k], num, n, r [k]);
+            ok [k] = 1;
+         }
+         else {
+            mpc_pool_fr_set_prec (t, w);
+            mpfr_div (t, num, n, MPFR_RNDN);
+            if (mpfr_can_round (t, w - 3, MPFR_RNDN, MPFR_RNDZ,
+                                mpfr_get_prec (q [k]) + (r [k] == MPFR_RNDN))) {
+               inex_q [k] = mpfr_set (q [k], t, r [k]);
+               ok [k] = 1;
+            }
+         }
+      }
+
+      if (ok [0] && ok [1])
+         break;
+      w += w / 2;
+   }
+
+   mpc_pool_fr_clear (n);
+   mpc_pool_fr_clear (x [0]);
+   mpc_pool_fr_clear (x [1]);
+   mpc_pool_fr_clear (t);
+
+   if (dest != a) {
+      mpc_set (a, dest, MPC_RNDNN); /* exact */
+      mpc_pool_clear (tmp);
+   }
+
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   inex_q [0] = mpfr_check_range (mpc_realref (a), inex_q [0], r [0]);
+   inex_q [1] = mpfr_check_range (mpc_imagref (a), inex_q [1], r [1]);
+   *inex = MPC_INEX (inex_q [0], inex_q [1]);
+   return 1;
+}
+
+/* Set a to b/c, where b is finite and c is finite with non-zero parts, by
+   a Ziv loop on b*conj(c)/norm(c), with a heuristic treatment of overflows
+   and underflows; this is used for large precisions and for operands with
+   huge exponents. */
+static int
+mpc_div_ziv (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
    int ok_re = 0, ok_im = 0;
    mpc_t res, c_conj;
@@ -246,35 +423,10 @@ mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
    int tmpsgn;
    mpfr_exp_t saved_emin, saved_emax;
 
-   /* According to the C standard G.3, there are three types of numbers:   */
-   /* finite (both parts are usual real numbers; contains 0), infinite     */
-   /* (at least one part is a real infinity) and all others; the latter    */
-   /* are numbers containing a nan, but no infinity, and could reasonably  */
-   /* be called nan.                                                       */
-   /* By G.5.1.4, infinite/finite=infinite; finite/infinite=0;             */
-   /* all other divisions that are not finite/finite return nan+i*nan.     */
-   /* Division by 0 could be handled by the following case of division by  */
-   /* a real; we handle it separately instead.                             */
-   if (mpc_zero_p (c)) /* both Re(c) and Im(c) are zero */
-      return mpc_div_zero (a, b, c, rnd);
-   else if (mpc_inf_p (b) && mpc_fin_p (c)) /* either Re(b) or Im(b) is infinite
-                                               and both Re(c) and Im(c) are ordinary */
-         return mpc_div_inf_fin (a, b, c);
-   else if (mpc_fin_p (b) && mpc_inf_p (c))
-         return mpc_div_fin_inf (a, b, c);
-   else if (!mpc_fin_p (b) || !mpc_fin_p (c)) {
-      mpc_set_nan (a);
-      return MPC_INEX (0, 0);
-   }
-   else if (mpfr_zero_p(mpc_imagref(c)))
-      return mpc_div_real (a, b, c, rnd);
-   else if (mpfr_zero_p(mpc_realref(c)))
-      return mpc_div_imag (a, b, c, rnd);
-
    prec = MPC_MAX_PREC(a);
 
-   mpc_init2 (res, 2);
-   mpfr_init (q);
+   mpc_pool_init2 (res, 2);
+   mpc_pool_fr_init2 (q, 2);
 
    /* we perform the division in the largest possible exponent range,
       to avoid underflow/overflow in intermediate computations */
@@ -296,8 +448,8 @@ mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
       loops ++;
       prec += loops <= 2 ? mpc_ceil_log2 (prec) + 5 : prec / 2;
 
-      mpc_set_prec (res, prec);
-      mpfr_set_prec (q, prec);
+      mpc_pool_set_prec (res, prec);
+      mpc_pool_fr_set_prec (q, prec);
 
       /* first compute norm(c) */
       mpfr_clear_underflow ();
@@ -453,8 +605,8 @@ mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
       mpfr_set_zero (mpc_imagref (a), -inexact_im);
    }
 
-   mpc_clear (res);
-   mpfr_clear (q);
+   mpc_pool_clear (res);
+   mpc_pool_fr_clear (q);
 
    /* restore underflow and overflow flags from MPFR */
    if (saved_underflow)
@@ -470,3 +622,50 @@ mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 
    return MPC_INEX (inexact_re, inexact_im);
 }
+
+int
+mpc_div (mpc_ptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
+{
+   int inex;
+
+   /* According to the C standard G.3, there are three types of numbers:   */
+   /* finite (both parts are usual real numbers; contains 0), infinite     */
+   /* (at least one part is a real infinity) and all others; the latter    */
+   /* are numbers containing a nan, but no infinity, and could reasonably  */
+   /* be called nan.                                                       */
+   /* By G.5.1.4, infinite/finite=infinite; finite/infinite=0;             */
+   /* all other divisions that are not finite/finite return nan+i*nan.     */
+   /* Division by 0 could be handled by the following case of division by  */
+   /* a real; we handle it separately instead.                             */
+   if (mpc_zero_p (c)) /* both Re(c) and Im(c) are zero */
+      return mpc_div_zero (a, b, c, rnd);
+   else if (mpc_inf_p (b) && mpc_fin_p (c)) /* either Re(b) or Im(b) is infinite
+                                               and both Re(c) and Im(c) are ordinary */
+         return mpc_div_inf_fin (a, b, c);
+   else if (mpc_fin_p (b) && mpc_inf_p (c))
+         return mpc_div_fin_inf (a, b, c);
+   else if (!mpc_fin_p (b) || !mpc_fin_p (c)) {
+      mpc_set_nan (a);
+      return MPC_INEX (0, 0);
+   }
+   else if (mpfr_zero_p(mpc_imagref(c)))
+      return mpc_div_real (a, b, c, rnd);
+   else if (mpfr_zero_p(mpc_realref(c)))
+      return mpc_div_imag (a, b, c, rnd);
+
+   /* small operands: the quotient needs a single rounding */
+   if (MPC_MAX_PREC (b) <= MPC_SMALL_PREC && MPC_MAX_PREC (c) <= MPC_SMALL_PREC
+       && mpfr_regular_p (mpc_realref (b)) && mpfr_regular_p (mpc_imagref (b))
+       && mpc_div_small (a, b, c, rnd, &inex))
+      return inex;
+
+   /* above MPC_FMMA_THRESHOLD limbs, the first pass of the Ziv loop, with
+      a Karatsuba product and rounded operations, is faster than the exact
+      computations of mpc_div_fmma */
+   if (MPC_MAX_PREC (a) <= MPC_FMMA_PREC && MPC_MAX_PREC (b) <= MPC_FMMA_PREC
+       && MPC_MAX_PREC (c) <= MPC_FMMA_PREC
+       && mpc_div_fmma (a, b, c, rnd, &inex))
+      return inex;
+   else
+      return mpc_div_ziv (a, b, c, rnd);
+}
@@ -1,4 +1,4 @@
-/* mpc_dot -- Dot product of two arrays of complex numbers.
+/* mpc_dot, mpc_dot_strided -- Dot product of two arrays of complex numbers.
 
 Copyright (C) 2018, 2020 INRIA
 
@@ -21,67 +21,108 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 #include <stdio.h> /* for MPC_ASSERT */
 #include "mpc-impl.h"
 
-/* res <- x[0]*y[0] + ... + x[n-1]*y[n-1] */
-int
-mpc_dot (mpc_ptr res, const mpc_ptr *x, const mpc_ptr *y,
-         unsigned long n, mpc_rnd_t rnd)
+#define LIMBS(p) ((size_t) (((p) - 1) / GMP_NUMB_BITS + 1))
+
+/* the i-th operand of an array given either as an array of pointers p,
+   or, if p is NULL, as an array of mpc_t starting at b with stride inc */
+#define ELT(p, b, inc, i) \
+  ((p) != NULL ? (mpc_srcptr) (p)[i] : (b) + (long) (i) * (inc))
+
+/* res <- x[0]*y[0] + ... + x[n-1]*y[n-1], where the operands are read with
+   ELT (xp, xb, incx, i) and ELT (yp, yb, incy, i) */
+static int
+dot (mpc_ptr res, const mpc_ptr *xp, mpc_srcptr xb, long incx,
+     const mpc_ptr *yp, mpc_srcptr yb, long incy, unsigned long n,
+     mpc_rnd_t rnd)
 {
   int inex_re, inex_im;
   mpfr_ptr *t;
   mpfr_t *z;
+  mpc_srcptr x, y;
   unsigned long i;
-  mpfr_t re_res;
+  mp_limb_t *m;
+  size_t size;
+  char *block;
 
-  z = (mpfr_t *) malloc (2 * n * sizeof (mpfr_t));
-  MPC_ASSERT(z != NULL);
-  t = (mpfr_ptr *) malloc (2 * n * sizeof(mpfr_ptr));
-  MPC_ASSERT(t != NULL);
-  for (i = 0; i < 2 * n; i++)
-    t[i] = z[i];
-  /* we first store in z[i] the value of Re(x[i])*Re(y[i])
-     and in z[n+i] that of -Im(x[i])*Im(y[i]) */
+  /* All temporaries live in a single block taken from the pool: the array
+     z of 4n variables, the array t of pointers to them, and their
+     significands. The 4n exact products are computed in a single pass over
+     x and y: z[i] and z[n+i] receive Re(x[i])*Re(y[i]) and
+     -Im(x[i])*Im(y[i]), whose sum is the real part, and z[2n+i] and
+     z[3n+i] receive Re(x[i])*Im(y[i]) and Im(x[i])*Re(y[i]), whose sum is
+     the imaginary part. Since res is only written once all products are
+     known, it may be one of the operands. */
+  size = 0;
   for (i = 0; i < n; i++)
     {
-      mpfr_prec_t prec_x_re = mpfr_get_prec (mpc_realref (x[i]));
-      mpfr_prec_t prec_x_im = mpfr_get_prec (mpc_imagref (x[i]));
-      mpfr_prec_t prec_y_re = mpfr_get_prec (mpc_realref (y[i]));
-      mpfr_prec_t prec_y_im = mpfr_get_prec (mpc_imagref (y[i]));
-      mpfr_prec_t prec_y_max = MPC_MAX (prec_y_re, prec_y_im);
-      /* we allocate z[i] with prec_x_re + prec_y_max bits
-         so that the second loop below does not reallocate */
-      mpfr_init2 (z[i], prec_x_re + prec_y_max);
-      mpfr_set_prec (z[i], prec_x_re + prec_y_re);
-      mpfr_mul (z[i], mpc_realref (x[i]), mpc_realref (y[i]), MPFR_RNDZ);
-      /* idem for z[n+i]: we allocate with prec_x_im + prec_y_max bits */
-      mpfr_init2 (z[n+i], prec_x_im + prec_y_max);
-      mpfr_set_prec (z[n+i], prec_x_im + prec_y_im);
-      mpfr_mul (z[n+i], mpc_imagref (x[i]), mpc_imagref (y[i]), MPFR_RNDZ);
-      mpfr_neg (z[n+i], z[n+i], MPFR_RNDZ);
+      x = ELT (xp, xb, incx, i);
+      y = ELT (yp, yb, incy, i);
+      size += LIMBS (mpfr_get_prec (mpc_realref (x))
+                     + mpfr_get_prec (mpc_realref (y)))
+        + LIMBS (mpfr_get_prec (mpc_imagref (x))
+                 + mpfr_get_prec (mpc_imagref (y)))
+        + LIMBS (mpfr_get_prec (mpc_realref (x))
+                 + mpfr_get_prec (mpc_imagref (y)))
+        + LIMBS (mpfr_get_prec (mpc_imagref (x))
+                 + mpfr_get_prec (mpc_realref (y)));
     }
-  /* copy the real part in a temporary variable, since it might be in the
-     input array */
-  mpfr_init2 (re_res, mpfr_get_prec (mpc_realref (res)));
-  inex_re = mpfr_sum (re_res, t, 2 * n, MPC_RND_RE (rnd));
-  /* we then store in z[i] the value of Re(x[i])*Im(y[i])
-     and in z[n+i] that of Im(x[i])*Re(y[i]) */
+  size = 4 * n * (sizeof (mpfr_t) + sizeof (mpfr_ptr))
+    + size * sizeof (mp_limb_t);
+  if (size == 0)
+    size = sizeof (mp_limb_t);
+  block = (char *) mpc_pool_alloc (size);
+  MPC_ASSERT(block != NULL);
+  z = (mpfr_t *) block;
+  t = (mpfr_ptr *) (block + 4 * n * sizeof (mpfr_t));
+  m = (mp_limb_t *) (block + 4 * n * (sizeof (mpfr_t) + sizeof (mpfr_ptr)));
   for (i = 0; i < n; i++)
     {
-      mpfr_prec_t prec_x_re = mpfr_get_prec (mpc_realref (x[i]));
-      mpfr_prec_t prec_x_im = mpfr_get_prec (mpc_imagref (x[i]));
-      mpfr_prec_t prec_y_re = mpfr_get_prec (mpc_realref (y[i]));
-      mpfr_prec_t prec_y_im = mpfr_get_prec (mpc_imagref (y[i]));
-      mpfr_set_prec (z[i], prec_x_re + prec_y_im);
-      mpfr_mul (z[i], mpc_realref (x[i]), mpc_imagref (y[i]), MPFR_RNDZ);
-      mpfr_set_prec (z[n+i], prec_x_im + prec_y_re);
-      mpfr_mul (z[n+i], mpc_imagref (x[i]), mpc_realref (y[i]), MPFR_RNDZ);
+      mpfr_prec_t prec_x_re, prec_x_im, prec_y_re, prec_y_im;
+
+      x = ELT (xp, xb, incx, i);
+      y = ELT (yp, yb, incy, i);
+      prec_x_re = mpfr_get_prec (mpc_realref (x));
+      prec_x_im = mpfr_get_prec (mpc_imagref (x));
+      prec_y_re = mpfr_get_prec (mpc_realref (y));
+      prec_y_im = mpfr_get_prec (mpc_imagref (y));
+      mpfr_custom_init_set (z[i], MPFR_NAN_KIND, 0, prec_x_re + prec_y_re, m);
+      m += LIMBS (prec_x_re + prec_y_re);
+      mpfr_mul (z[i], mpc_realref (x), mpc_realref (y), MPFR_RNDZ);
+      mpfr_custom_init_set (z[n+i], MPFR_NAN_KIND, 0, prec_x_im + prec_y_im,
+                            m);
+      m += LIMBS (prec_x_im + prec_y_im);
+      mpfr_mul (z[n+i], mpc_imagref (x), mpc_imagref (y), MPFR_RNDZ);
+      mpfr_neg (z[n+i], z[n+i], MPFR_RNDZ);
+      mpfr_custom_init_set (z[2*n+i], MPFR_NAN_KIND, 0, prec_x_re + prec_y_im,
+                            m);
+      m += LIMBS (prec_x_re + prec_y_im);
+      mpfr_mul (z[2*n+i], mpc_realref (x), mpc_imagref (y), MPFR_RNDZ);
+      mpfr_custom_init_set (z[3*n+i], MPFR_NAN_KIND, 0, prec_x_im + prec_y_re,
+                            m);
+      m += LIMBS (prec_x_im + prec_y_re);
+      mpfr_mul (z[3*n+i], mpc_imagref (x), mpc_realref (y), MPFR_RNDZ);
     }
-  inex_im = mpfr_sum (mpc_imagref (res), t, 2 * n, MPC_RND_IM (rnd));
-  mpfr_swap (mpc_realref (res), re_res);
-  mpfr_clear (re_res);
-  for (i = 0; i < 2 * n; i++)
-    mpfr_clear (z[i]);
-  free (t);
-  free (z);
+  for (i = 0; i < 4 * n; i++)
+    t[i] = z[i];
+  inex_re = mpfr_sum (mpc_realref (res), t, 2 * n, MPC_RND_RE (rnd));
+  inex_im = mpfr_sum (mpc_imagref (res), t + 2 * n, 2 * n, MPC_RND_IM (rnd));
+  mpc_pool_free (block, size);
 
   return MPC_INEX(inex_re, inex_im);
 }
+
+/* res <- x[0]*y[0] + ... + x[n-1]*y[n-1] */
+int
+mpc_dot (mpc_ptr res, const mpc_ptr *x, const mpc_ptr *y,
+         unsigned long n, mpc_rnd_t rnd)
+{
+  return dot (res, x, NULL, 0, y, NULL, 0, n, rnd);
+}
+
+/* res <- x[0]*y[0] + x[incx]*y[incy] + ... + x[(n-1)*incx]*y[(n-1)*incy] */
+int
+mpc_dot_strided (mpc_ptr res, mpc_srcptr x, long incx, mpc_srcptr y,
+                 long incy, unsigned long n, mpc_rnd_t rnd)
+{
+  return dot (res, NULL, x, incx, NULL, y, incy, n, rnd);
+}
@@ -20,13 +20,76 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 
 #include "mpc-impl.h"
 
+/* Compute exp(op) into rop when both parts of op are regular numbers,
+   using the pooled temporaries x, y and z, whose precision is changed.
+   The caller must have extended the exponent range and saved the underflow
+   and overflow flags of MPFR, which are overwritten; the returned ternary
+   value has not been checked against the original exponent range. */
 int
-mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+mpc_exp_regular (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd,
+                 mpfr_ptr x, mpfr_ptr y, mpfr_ptr z)
 {
-  mpfr_t x, y, z;
   mpfr_prec_t prec;
   int ok = 0;
   int inex_re, inex_im;
+
+  prec = MPC_MAX_PREC(rop)
+         + MPC_MAX (MPC_MAX (-mpfr_get_exp (mpc_realref (op)), 0),
+                   -mpfr_get_exp (mpc_imagref (op)));
+    /* When op is close to 0, then exp is close to 1+Re(op), while
+       cos is close to 1-Im(op); to decide on the ternary value of exp*cos,
+       we need a high enough precision so that none of exp or cos is
+       computed as 1. */
+
+  do
+    {
+      prec += prec / 2 + mpc_ceil_log2 (prec) + 5;
+
+      mpc_pool_fr_set_prec (x, prec);
+      mpc_pool_fr_set_prec (y, prec);
+      mpc_pool_fr_set_prec (z, prec);
+
+      /* FIXME: x may overflow so x.y does overflow too, while Re(exp(op))
+         could be represented in the precision of rop. */
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+      mpfr_exp (x, mpc_realref(op), MPFR_RNDN); /* error <= 0.5ulp */
+      mpfr_sin_cos (z, y, mpc_imagref(op), MPFR_RNDN); /* errors <= 0.5ulp */
+      mpfr_mul (y, y, x, MPFR_RNDN); /* error <= 2ulp */
+      ok = mpfr_overflow_p () || mpfr_zero_p (x)
+        || mpfr_can_round (y, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                       MPC_PREC_RE(rop) + (MPC_RND_RE(rnd) == MPFR_RNDN));
+      if (ok) /* compute imaginary part */
+        {
+          mpfr_mul (z, z, x, MPFR_RNDN);
+          ok = mpfr_overflow_p () || mpfr_zero_p (x)
+            || mpfr_can_round (z, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                       MPC_PREC_IM(rop) + (MPC_RND_IM(rnd) == MPFR_RNDN));
+        }
+    }
+  while (ok == 0);
+
+  inex_re = mpfr_set (mpc_realref(rop), y, MPC_RND_RE(rnd));
+  inex_im = mpfr_set (mpc_imagref(rop), z, MPC_RND_IM(rnd));
+  if (mpfr_overflow_p ())
+    {
+      inex_re = mpc_fix_inf (mpc_realref(rop), MPC_RND_RE(rnd));
+      inex_im = mpc_fix_inf (mpc_imagref(rop), MPC_RND_IM(rnd));
+    }
+  else if (mpfr_underflow_p ())
+    {
+      inex_re = mpc_fix_zero (mpc_realref(rop), MPC_RND_RE(rnd));
+      inex_im = mpc_fix_zero (mpc_imagref(rop), MPC_RND_IM(rnd));
+    }
+
+  return MPC_INEX(inex_re, inex_im);
+}
+
+int
+mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpfr_t x, y, z;
+  int inex, inex_re, inex_im;
   int saved_underflow, saved_overflow;
   mpfr_exp_t saved_emin, saved_emax;
 
@@ -136,65 +199,19 @@ mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 
   /* from now on, both parts of op are regular numbers */
 
-  prec = MPC_MAX_PREC(rop)
-         + MPC_MAX (MPC_MAX (-mpfr_get_exp (mpc_realref (op)), 0),
-                   -mpfr_get_exp (mpc_imagref (op)));
-    /* When op is close to 0, then exp is close to 1+Re(op), while
-       cos is close to 1-Im(op); to decide on the ternary value of exp*cos,
-       we need a high enough precision so that none of exp or cos is
-       computed as 1. */
-  mpfr_init2 (x, 2);
-  mpfr_init2 (y, 2);
-  mpfr_init2 (z, 2);
+  mpc_pool_fr_init2 (x, 2);
+  mpc_pool_fr_init2 (y, 2);
+  mpc_pool_fr_init2 (z, 2);
 
   /* save the underflow or overflow flags from MPFR */
   saved_underflow = mpfr_underflow_p ();
   saved_overflow = mpfr_overflow_p ();
 
-  do
-    {
-      prec += prec / 2 + mpc_ceil_log2 (prec) + 5;
-
-      mpfr_set_prec (x, prec);
-      mpfr_set_prec (y, prec);
-      mpfr_set_prec (z, prec);
-
-      /* FIXME: x may overflow so x.y does overflow too, while Re(exp(op))
-         could be represented in the precision of rop. */
-      mpfr_clear_overflow ();
-      mpfr_clear_underflow ();
-      mpfr_exp (x, mpc_realref(op), MPFR_RNDN); /* error <= 0.5ulp */
-      mpfr_sin_cos (z, y, mpc_imagref(op), MPFR_RNDN); /* errors <= 0.5ulp */
-      mpfr_mul (y, y, x, MPFR_RNDN); /* error <= 2ulp */
-      ok = mpfr_overflow_p () || mpfr_zero_p (x)
-        || mpfr_can_round (y, prec - 2, MPFR_RNDN, MPFR_RNDZ,
-                       MPC_PREC_RE(rop) + (MPC_RND_RE(rnd) == MPFR_RNDN));
-      if (ok) /* compute imaginary part */
-        {
-          mpfr_mul (z, z, x, MPFR_RNDN);
-          ok = mpfr_overflow_p () || mpfr_zero_p (x)
-            || mpfr_can_round (z, prec - 2, MPFR_RNDN, MPFR_RNDZ,
-                       MPC_PREC_IM(rop) + (MPC_RND_IM(rnd) == MPFR_RNDN));
-        }
-    }
-  while (ok == 0);
-
-  inex_re = mpfr_set (mpc_realref(rop), y, MPC_RND_RE(rnd));
-  inex_im = mpfr_set (mpc_imagref(rop), z, MPC_RND_IM(rnd));
-  if (mpfr_overflow_p ())
-    {
-      inex_re = mpc_fix_inf (mpc_realref(rop), MPC_RND_RE(rnd));
-      inex_im = mpc_fix_inf (mpc_imagref(rop), MPC_RND_IM(rnd));
-    }
-  else if (mpfr_underflow_p ())
-    {
-      inex_re = mpc_fix_zero (mpc_realref(rop), MPC_RND_RE(rnd));
-      inex_im = mpc_fix_zero (mpc_imagref(rop), MPC_RND_IM(rnd));
-    }
+  inex = mpc_exp_regular (rop, op, rnd, x, y, z);
 
-  mpfr_clear (x);
-  mpfr_clear (y);
-  mpfr_clear (z);
+  mpc_pool_fr_clear (x);
+  mpc_pool_fr_clear (y);
+  mpc_pool_fr_clear (z);
 
   /* restore underflow and overflow flags from MPFR */
   if (saved_underflow)
@@ -205,8 +222,10 @@ mpc_exp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
   /* restore the exponent range, and check the range of results */
   mpfr_set_emin (saved_emin);
   mpfr_set_emax (saved_emax);
-  inex_re = mpfr_check_range (mpc_realref (rop), inex_re, MPC_RND_RE (rnd));
-  inex_im = mpfr_check_range (mpc_imagref (rop), inex_im, MPC_RND_IM (rnd));
+  inex_re = mpfr_check_range (mpc_realref (rop), MPC_INEX_RE (inex),
+                              MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (rop), MPC_INEX_IM (inex),
+                              MPC_RND_IM (rnd));
 
   return MPC_INEX(inex_re, inex_im);
 }
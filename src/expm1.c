@@ -0,0 +1,438 @@
+/* mpc_expm1 -- exponential of a complex number minus one.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* Put in r an approximation of expm1 (x) - x - x^2/2 for |x| < 1/4, with
+   an error of at most 4 ulps, see algorithms.tex. */
+static void
+expm1_minus_quad (mpfr_ptr r, mpfr_srcptr x)
+{
+  mpfr_prec_t p = mpfr_get_prec (r);
+  mpfr_exp_t e;
+  mpfr_t t, mx, xx;
+  mpfr_srcptr tab [3];
+
+  if (mpfr_zero_p (x))
+    {
+      mpfr_set_zero (r, +1);
+      return;
+    }
+
+  e = mpfr_get_exp (x);
+  if (e < - (mpfr_exp_t) p - 1)
+    {
+      /* x^3/6 approximates expm1 (x) - x - x^2/2 with relative error
+         less than 2^(-p-3) */
+      mpfr_sqr (r, x, MPFR_RNDN);
+      mpfr_mul (r, r, x, MPFR_RNDN);
+      mpfr_div_ui (r, r, 6, MPFR_RNDN);
+    }
+  else
+    {
+      /* |expm1 (x) - x - x^2/2| >= 2^(3*e-6), so that -2*e+6 more bits
+         absorb the cancellation; x and x^2/2 are subtracted exactly */
+      mpc_pool_fr_init2 (t, p - 2 * e + 6);
+      mpc_pool_fr_init2 (xx, 2 * mpfr_get_prec (x));
+      mpfr_expm1 (t, x, MPFR_RNDN);
+      mpfr_sqr (xx, x, MPFR_RNDN);
+      mpfr_div_2ui (xx, xx, 1, MPFR_RNDN);
+      mpfr_neg (xx, xx, MPFR_RNDN);
+      mx [0] = x [0];
+      MPFR_CHANGE_SIGN (mx);
+      tab [0] = t;
+      tab [1] = mx;
+      tab [2] = xx;
+      mpfr_sum (r, (mpfr_ptr *) tab, 3, MPFR_RNDN);
+      mpc_pool_fr_clear (t);
+      mpc_pool_fr_clear (xx);
+    }
+}
+
+/* Put in r an approximation of x - sin x for 0 < |x| < 1/4, with an error
+   of at most 4 ulps, see algorithms.tex. */
+static void
+id_minus_sin (mpfr_ptr r, mpfr_srcptr x)
+{
+  mpfr_prec_t p = mpfr_get_prec (r);
+  mpfr_exp_t e = mpfr_get_exp (x);
+  mpfr_t t;
+
+  if (2 * e < - (mpfr_exp_t) p - 2)
+    {
+      /* x^3/6 approximates x - sin x with relative error < 2^(-p-6) */
+      mpfr_sqr (r, x, MPFR_RNDN);
+      mpfr_mul (r, r, x, MPFR_RNDN);
+      mpfr_div_ui (r, r, 6, MPFR_RNDN);
+    }
+  else
+    {
+      /* |x - sin x| >= 2^(3*e-6) */
+      mpc_pool_fr_init2 (t, p - 2 * e + 5);
+      mpfr_sin (t, x, MPFR_RNDN);
+      mpfr_sub (r, x, t, MPFR_RNDN);
+      mpc_pool_fr_clear (t);
+    }
+}
+
+/* Compute expm1 (op) for op = x + i*y with |x| < 1/4 and 0 < |y| < 1/4 in
+   the extended exponent range; then
+      expm1 (op) = x + x^2/2 - y^2/2 + (expm1 (x) - x - x^2/2) cos y
+                   - 2 (x + x^2/2) sin (y/2)^2
+                   + 2 (y/2 - sin (y/2)) (y/2 + sin (y/2))
+                 + i (y + expm1 (x) sin y - (y - sin y)),
+   where x, x^2, y and y^2 are exact, and the remaining terms, which are of
+   order 3 in op, are computed with relative errors that do not depend on
+   the exponents of x and y. The rounding of the sums is decided by
+   mpc_round_sum, which also works when a part is extremely close to a
+   representable number, such as y or x for tiny op, in which case
+   mpfr_can_round would need a working precision of about -Exp (op).
+   This fails only when a sum of terms of order 4 and more in op, which
+   are computed to a relative precision, is itself close to a
+   representable number, as for x = y^2/2; then the working precision
+   grows until it is about -2 Exp (op), see algorithms.tex. */
+static int
+expm1_small (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpfr_srcptr x = mpc_realref (op), y = mpc_imagref (op);
+  mpfr_srcptr tab [3];
+  mpfr_t a, c, s, u, t, h, xx, yy, re, im;
+  mpfr_prec_t prec;
+  mpfr_exp_t err;
+  int ok, loops, inex_re, inex_im;
+
+  mpc_pool_fr_init2 (a, 2);
+  mpc_pool_fr_init2 (c, 2);
+  mpc_pool_fr_init2 (s, 2);
+  mpc_pool_fr_init2 (u, 2);
+  mpc_pool_fr_init2 (t, 2);
+  mpc_pool_fr_init2 (re, MPC_PREC_RE (rop));
+  mpc_pool_fr_init2 (im, MPC_PREC_IM (rop));
+
+  /* imaginary part y + (expm1 (x) sin y - (y - sin y)), where the first
+     product has an error of at most 4 ulps, and so has y - sin y;
+     with the final rounding, the error is at most
+     2^(max (Exp (a), Exp (s), Exp (t) - 3) + 4 - prec) */
+  tab [0] = y;
+  prec = MPC_PREC_IM (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (a, prec);
+      mpc_pool_fr_set_prec (s, prec);
+      mpc_pool_fr_set_prec (t, prec);
+
+      mpfr_expm1 (a, x, MPFR_RNDN);
+      mpfr_sin (s, y, MPFR_RNDN);
+      mpfr_mul (a, a, s, MPFR_RNDN);
+      id_minus_sin (s, y);
+      mpfr_sub (t, a, s, MPFR_RNDN);
+      err = mpfr_get_exp (s);
+      if (!mpfr_zero_p (a))
+        err = MPC_MAX (err, mpfr_get_exp (a));
+      if (!mpfr_zero_p (t))
+        err = MPC_MAX (err, mpfr_get_exp (t) - 3);
+      ok = mpc_round_sum (im, tab, 1, t, err + 4 - (mpfr_exp_t) prec,
+                          MPC_RND_IM (rnd), &inex_im);
+    }
+
+  /* real part x + x^2/2 - y^2/2 + t1 + t2 + t3 with
+     t1 = (expm1 (x) - x - x^2/2) cos y, with an error of at most 16 ulps,
+     t2 = - 2 (x + x^2/2) sin (y/2)^2, with an error of at most 8 ulps,
+     t3 = 2 (y/2 - sin (y/2)) (y/2 + sin (y/2)), with an error of at most
+     32 ulps; with the final rounding, the error is at most
+     2^(max (Exp (t1) + 4, Exp (t2) + 3, Exp (t3) + 5, Exp (t) - 1) + 2
+        - prec) */
+  mpc_pool_fr_init2 (xx, 2 * mpfr_get_prec (x));
+  mpc_pool_fr_init2 (yy, 2 * mpfr_get_prec (y));
+  mpfr_sqr (xx, x, MPFR_RNDN);
+  mpfr_div_2ui (xx, xx, 1, MPFR_RNDN);
+  mpfr_sqr (yy, y, MPFR_RNDN);
+  mpfr_div_2ui (yy, yy, 1, MPFR_RNDN);
+  mpfr_neg (yy, yy, MPFR_RNDN);
+  tab [0] = x;
+  tab [1] = xx;
+  tab [2] = yy;
+  h [0] = y [0];
+  mpfr_set_exp (h, mpfr_get_exp (h) - 1); /* h = y/2, as a shallow copy */
+  prec = MPC_PREC_RE (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      mpfr_srcptr terms [3];
+
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (a, prec);
+      mpc_pool_fr_set_prec (c, prec);
+      mpc_pool_fr_set_prec (s, prec);
+      mpc_pool_fr_set_prec (u, prec);
+      mpc_pool_fr_set_prec (t, prec);
+
+      expm1_minus_quad (a, x);
+      mpfr_cos (c, y, MPFR_RNDN);
+      mpfr_mul (a, a, c, MPFR_RNDN);
+      mpfr_add (c, x, xx, MPFR_RNDN);
+      mpfr_sin (s, h, MPFR_RNDN);
+      mpfr_sqr (u, s, MPFR_RNDN);
+      mpfr_mul (c, c, u, MPFR_RNDN);
+      mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
+      mpfr_neg (c, c, MPFR_RNDN);
+      mpfr_add (s, s, h, MPFR_RNDN);
+      id_minus_sin (u, h);
+      mpfr_mul (u, u, s, MPFR_RNDN);
+      mpfr_mul_2ui (u, u, 1, MPFR_RNDN);
+      terms [0] = a;
+      terms [1] = c;
+      terms [2] = u;
+      mpfr_sum (t, (mpfr_ptr *) terms, 3, MPFR_RNDN);
+      err = mpfr_get_exp (u) + 5;
+      if (!mpfr_zero_p (x))
+        err = MPC_MAX (err, MPC_MAX (mpfr_get_exp (a) + 4,
+                                     mpfr_get_exp (c) + 3));
+      if (!mpfr_zero_p (t))
+        err = MPC_MAX (err, mpfr_get_exp (t) - 1);
+      ok = mpc_round_sum (re, tab, 3, t, err + 2 - (mpfr_exp_t) prec,
+                          MPC_RND_RE (rnd), &inex_re);
+    }
+
+  mpfr_set (mpc_realref (rop), re, MPFR_RNDN);
+  mpfr_set (mpc_imagref (rop), im, MPFR_RNDN);
+
+  mpc_pool_fr_clear (a);
+  mpc_pool_fr_clear (c);
+  mpc_pool_fr_clear (s);
+  mpc_pool_fr_clear (u);
+  mpc_pool_fr_clear (t);
+  mpc_pool_fr_clear (xx);
+  mpc_pool_fr_clear (yy);
+  mpc_pool_fr_clear (re);
+  mpc_pool_fr_clear (im);
+
+  return MPC_INEX (inex_re, inex_im);
+}
+
+/* Compute expm1 (op) for op = x + i*y with x finite and y regular in the
+   extended exponent range; then
+      expm1 (op) = e^x cos y - 1 + i e^x sin y
+                 = expm1 (x) cos y - 2 sin (y/2)^2 + i e^x sin y,
+   where the subtraction cancels only close to the curve e^x cos y = 1.
+   Unlike in mpc_exp, the working precision does not depend on the
+   exponents of x and y, see algorithms.tex. */
+static int
+expm1_regular (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpfr_t a, c, s, h, re, im;
+  mpfr_prec_t prec;
+  mpfr_exp_t err;
+  int ok, loops, inex_re, inex_im;
+  int inf_re = 0, zero_re = 0, inf_im = 0, zero_im = 0;
+
+  mpc_pool_fr_init2 (a, 2);
+  mpc_pool_fr_init2 (c, 2);
+  mpc_pool_fr_init2 (s, 2);
+  mpc_pool_fr_init2 (re, 2);
+  mpc_pool_fr_init2 (im, 2);
+
+  /* imaginary part e^x sin y, computed as in mpc_exp;
+     FIXME: e^x may overflow while the imaginary part could be
+     represented in the precision of rop. */
+  prec = MPC_PREC_IM (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (a, prec);
+      mpc_pool_fr_set_prec (im, prec);
+
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+      mpfr_exp (a, mpc_realref (op), MPFR_RNDN); /* error <= 0.5 ulp */
+      mpfr_sin (im, mpc_imagref (op), MPFR_RNDN); /* error <= 0.5 ulp */
+      mpfr_mul (im, im, a, MPFR_RNDN); /* error <= 2 ulp */
+      inf_im = mpfr_overflow_p ();
+      zero_im = mpfr_underflow_p ();
+      if (zero_im)
+        /* the imaginary part underflows in the extended exponent range,
+           and so it does in any range */
+        mpfr_set_zero (im, mpfr_signbit (im) ? -1 : +1);
+      ok = inf_im || zero_im
+        || mpfr_can_round (im, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                           MPC_PREC_IM (rop) + (MPC_RND_IM (rnd) == MPFR_RNDN));
+    }
+
+  /* real part expm1 (x) cos y - 2 sin (y/2)^2; a and 2 sin (y/2)^2 are
+     computed with relative errors at most 3.01 * 2^(-prec), so that the
+     error of the difference is at most 2^(max (Exp (a), Exp (s)) + 4) ulps
+     of its result, see algorithms.tex */
+  h [0] = mpc_imagref (op) [0];
+  mpfr_set_exp (h, mpfr_get_exp (h) - 1); /* h = y/2, as a shallow copy */
+  prec = MPC_PREC_RE (rop);
+  ok = 0;
+  if (mpfr_cmp_si (mpc_realref (op), - (long) prec - 2) <= 0)
+    {
+      /* The real part is -1 + e^x cos y with 0 < e^x |cos y| < 2^(-prec-2),
+         which rounds as -1 + 2^(-prec-4) or -1 - 2^(-prec-3) according to
+         the sign of cos y, which is not zero; otherwise the Ziv loop below
+         would not terminate for e^x underflowing. */
+      mpc_pool_fr_set_prec (c, MPFR_PREC_MIN);
+      mpc_pool_fr_set_prec (re, prec + 4);
+      mpfr_cos (c, mpc_imagref (op), MPFR_RNDN);
+      mpfr_set_si (re, -1, MPFR_RNDN);
+      if (mpfr_sgn (c) > 0)
+        mpfr_nextabove (re);
+      else
+        mpfr_nextbelow (re);
+      ok = 1;
+    }
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (a, prec);
+      mpc_pool_fr_set_prec (c, prec);
+      mpc_pool_fr_set_prec (s, prec);
+      mpc_pool_fr_set_prec (re, prec);
+
+      mpfr_clear_overflow ();
+      mpfr_clear_underflow ();
+      mpfr_expm1 (a, mpc_realref (op), MPFR_RNDN);
+      mpfr_cos (c, mpc_imagref (op), MPFR_RNDN);
+      mpfr_mul (a, a, c, MPFR_RNDN);
+      mpfr_sin (s, h, MPFR_RNDN);
+      mpfr_sqr (s, s, MPFR_RNDN);
+      mpfr_mul_2ui (s, s, 1, MPFR_RNDN);
+      if (mpfr_overflow_p ())
+        {
+          /* expm1 (x) overflows, and so does the real part */
+          mpfr_set (re, a, MPFR_RNDN);
+          inf_re = ok = 1;
+        }
+      else if (mpfr_zero_p (a) && mpfr_underflow_p ())
+        {
+          /* x = 0 and 2 sin (y/2)^2 underflows in the extended exponent
+             range, and so does the real part in any range */
+          mpfr_set_zero (re, -1);
+          zero_re = ok = 1;
+        }
+      else
+        {
+          mpfr_sub (re, a, s, MPFR_RNDN);
+          if (!mpfr_zero_p (re))
+            {
+              err = (mpfr_zero_p (a) ? mpfr_get_exp (s)
+                     : MPC_MAX (mpfr_get_exp (a), mpfr_get_exp (s)))
+                    + 4 - mpfr_get_exp (re);
+              ok = err < (mpfr_exp_t) prec
+                && mpfr_can_round (re, prec - err, MPFR_RNDN, MPFR_RNDZ,
+                                   MPC_PREC_RE (rop)
+                                   + (MPC_RND_RE (rnd) == MPFR_RNDN));
+            }
+        }
+    }
+
+  inex_re = mpfr_set (mpc_realref (rop), re, MPC_RND_RE (rnd));
+  inex_im = mpfr_set (mpc_imagref (rop), im, MPC_RND_IM (rnd));
+  if (inf_re)
+    inex_re = mpc_fix_inf (mpc_realref (rop), MPC_RND_RE (rnd));
+  else if (zero_re)
+    inex_re = mpc_fix_zero (mpc_realref (rop), MPC_RND_RE (rnd));
+  if (inf_im)
+    inex_im = mpc_fix_inf (mpc_imagref (rop), MPC_RND_IM (rnd));
+  else if (zero_im)
+    inex_im = mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd));
+
+  mpc_pool_fr_clear (a);
+  mpc_pool_fr_clear (c);
+  mpc_pool_fr_clear (s);
+  mpc_pool_fr_clear (re);
+  mpc_pool_fr_clear (im);
+
+  return MPC_INEX (inex_re, inex_im);
+}
+
+int
+mpc_expm1 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpfr_exp_t saved_emin, saved_emax, ex, ey;
+  int inex, inex_re, inex_im;
+  int saved_underflow, saved_overflow;
+
+  if (mpfr_zero_p (mpc_imagref (op)))
+    /* special case when the input is real
+       expm1(x-i*0) = expm1(x) -i*0, even if x is NaN
+       expm1(x+i*0) = expm1(x) +i*0, even if x is NaN */
+    {
+      inex_re = mpfr_expm1 (mpc_realref (rop), mpc_realref (op),
+                            MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (op),
+                          MPC_RND_IM (rnd));
+      return MPC_INEX (inex_re, inex_im);
+    }
+
+  if (!mpfr_number_p (mpc_realref (op)) || !mpfr_number_p (mpc_imagref (op)))
+    /* infinities and NaNs: the real part of exp(op) is an infinity or NaN,
+       which is not changed by subtracting 1, or a zero for x = -inf,
+       in which case the real part of expm1(op) is exactly -1 */
+    {
+      inex = mpc_exp (rop, op, rnd);
+      if (mpfr_zero_p (mpc_realref (rop)))
+        mpfr_set_si (mpc_realref (rop), -1, MPFR_RNDN);
+      return inex;
+    }
+
+  /* from now on, x is a finite number and y is a regular number */
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  /* save the underflow or overflow flags from MPFR */
+  saved_underflow = mpfr_underflow_p ();
+  saved_overflow = mpfr_overflow_p ();
+
+  /* |x|, |y| < 1/4, and the powers of x and y up to the fourth one do not
+     underflow in the extended exponent range */
+  ex = mpfr_zero_p (mpc_realref (op)) ? -2 : mpfr_get_exp (mpc_realref (op));
+  ey = mpfr_get_exp (mpc_imagref (op));
+  if (ex <= -2 && ey <= -2 && ex > mpfr_get_emin () / 8
+      && ey > mpfr_get_emin () / 8)
+    inex = expm1_small (rop, op, rnd);
+  else
+    inex = expm1_regular (rop, op, rnd);
+
+  /* restore underflow and overflow flags from MPFR */
+  mpfr_clear_underflow ();
+  mpfr_clear_overflow ();
+  if (saved_underflow)
+    mpfr_set_underflow ();
+  if (saved_overflow)
+    mpfr_set_overflow ();
+
+  /* restore the exponent range, and check the range of results */
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+  inex_re = mpfr_check_range (mpc_realref (rop), MPC_INEX_RE (inex),
+                              MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (rop), MPC_INEX_IM (inex),
+                              MPC_RND_IM (rnd));
+
+  return MPC_INEX (inex_re, inex_im);
+}
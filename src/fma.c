@@ -1,6 +1,7 @@
-/* mpc_fma -- Fused multiply-add of three complex numbers
+/* mpc_fma, mpc_fms -- Fused multiply-add and multiply-subtract of three
+   complex numbers
 
-Copyright (C) 2011, 2012 INRIA
+Copyright (C) 2011, 2012, 2020 INRIA
 
 This file is part of GNU MPC.
 
@@ -130,62 +131,157 @@ mpc_fma_naive (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rn
   return MPC_INEX(inex_re, inex_im);
 }
 
+/* r <- a*b+c for finite a, b and c: the exact products Re(a)*Re(b),
+   -Im(a)*Im(b), Re(a)*Im(b) and Im(a)*Re(b) are computed in the extended
+   exponent range, so that they cannot overflow or underflow, and each part
+   of r is then rounded once by mpfr_sum */
+static int
+fma_sum (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
+{
+  mpfr_t rea_reb, ima_imb, rea_imb, ima_reb;
+  mpfr_ptr t[3];
+  mpfr_exp_t saved_emin, saved_emax;
+  int inex_re, inex_im;
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  mpc_pool_fr_init2 (rea_reb, MPC_PREC_RE (a) + MPC_PREC_RE (b));
+  mpc_pool_fr_init2 (ima_imb, MPC_PREC_IM (a) + MPC_PREC_IM (b));
+  mpc_pool_fr_init2 (rea_imb, MPC_PREC_RE (a) + MPC_PREC_IM (b));
+  mpc_pool_fr_init2 (ima_reb, MPC_PREC_IM (a) + MPC_PREC_RE (b));
+
+  /* all exact, also when r overlaps a or b */
+  mpfr_mul (rea_reb, mpc_realref (a), mpc_realref (b), MPFR_RNDZ);
+  mpfr_mul (ima_imb, mpc_imagref (a), mpc_imagref (b), MPFR_RNDZ);
+  mpfr_neg (ima_imb, ima_imb, MPFR_RNDZ);
+  mpfr_mul (rea_imb, mpc_realref (a), mpc_imagref (b), MPFR_RNDZ);
+  mpfr_mul (ima_reb, mpc_imagref (a), mpc_realref (b), MPFR_RNDZ);
+
+  /* if r overlaps c, writing its real part leaves Im(c) untouched */
+  t[0] = rea_reb;
+  t[1] = ima_imb;
+  t[2] = (mpfr_ptr) mpc_realref (c);
+  inex_re = mpfr_sum (mpc_realref (r), t, 3, MPC_RND_RE (rnd));
+  t[0] = rea_imb;
+  t[1] = ima_reb;
+  t[2] = (mpfr_ptr) mpc_imagref (c);
+  inex_im = mpfr_sum (mpc_imagref (r), t, 3, MPC_RND_IM (rnd));
+
+  mpc_pool_fr_clear (rea_reb);
+  mpc_pool_fr_clear (ima_imb);
+  mpc_pool_fr_clear (rea_imb);
+  mpc_pool_fr_clear (ima_reb);
+
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+  inex_re = mpfr_check_range (mpc_realref (r), inex_re, MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (r), inex_im, MPC_RND_IM (rnd));
+
+  return MPC_INEX (inex_re, inex_im);
+}
+
 /* The algorithm is as follows:
-   - in a first pass, we use the target precision + some extra bits
-   - if it fails, we add the number of cancelled bits when adding
-     Re(a*b) and Re(c) [similarly for the imaginary part]
-   - it is fails again, we call the mpc_fma_naive function, which also
-     deals with the special cases */
+   - for small operands, we call fma_sum, which rounds the exact result
+   - otherwise, we try one pass with the target precision + some extra bits,
+     which is cheaper than the exact products for large precisions
+   - if it fails, we call fma_sum */
 int
 mpc_fma (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
 {
   mpc_t ab;
   mpfr_prec_t pre, pim, wpre, wpim;
   mpfr_exp_t diffre, diffim;
-  int i, inex = 0, okre = 0, okim = 0;
+  int inex = 0, okre = 0, okim = 0;
+  int saved_underflow, saved_overflow;
 
   if (mpc_fin_p (a) == 0 || mpc_fin_p (b) == 0 || mpc_fin_p (c) == 0)
     return mpc_fma_naive (r, a, b, c, rnd);
 
+  /* small operands: compute both parts exactly on limb arrays */
+  if (MPC_MAX_PREC (a) <= MPC_SMALL_PREC && MPC_MAX_PREC (b) <= MPC_SMALL_PREC
+      && MPC_MAX_PREC (c) <= MPC_SMALL_PREC
+      && mpfr_regular_p (mpc_realref (a)) && mpfr_regular_p (mpc_imagref (a))
+      && mpfr_regular_p (mpc_realref (b)) && mpfr_regular_p (mpc_imagref (b))
+      && mpfr_regular_p (mpc_realref (c)) && mpfr_regular_p (mpc_imagref (c))
+      && mpc_mul_small (r, a, b, c, rnd, &inex))
+    return inex;
+
+  if (MPC_MAX_PREC (a) <= MPC_FMMA_PREC && MPC_MAX_PREC (b) <= MPC_FMMA_PREC)
+    return fma_sum (r, a, b, c, rnd);
+
   pre = mpfr_get_prec (mpc_realref(r));
   pim = mpfr_get_prec (mpc_imagref(r));
   wpre = pre + mpc_ceil_log2 (pre) + 10;
   wpim = pim + mpc_ceil_log2 (pim) + 10;
-  mpc_init3 (ab, wpre, wpim);
-  for (i = 0; i < 2; ++i)
+  mpc_pool_init3 (ab, wpre, wpim);
+
+  /* an underflow or overflow in the product or the sum invalidates the
+     error analysis, in particular since rounding towards zero then yields
+     the largest representable number instead of an infinity */
+  saved_underflow = mpfr_underflow_p ();
+  saved_overflow = mpfr_overflow_p ();
+  mpfr_clear_underflow ();
+  mpfr_clear_overflow ();
+
+  mpc_mul (ab, a, b, MPC_RNDZZ);
+  if (!mpfr_zero_p (mpc_realref(ab)) && !mpfr_zero_p (mpc_imagref(ab)))
     {
-      mpc_mul (ab, a, b, MPC_RNDZZ);
-      if (mpfr_zero_p (mpc_realref(ab)) || mpfr_zero_p (mpc_imagref(ab)))
-        break;
       diffre = mpfr_get_exp (mpc_realref(ab));
       diffim = mpfr_get_exp (mpc_imagref(ab));
       mpc_add (ab, ab, c, MPC_RNDZZ);
-      if (mpfr_zero_p (mpc_realref(ab)) || mpfr_zero_p (mpc_imagref(ab)))
-        break;
-      diffre -= mpfr_get_exp (mpc_realref(ab));
-      diffim -= mpfr_get_exp (mpc_imagref(ab));
-      diffre = (diffre > 0 ? diffre + 1 : 1);
-      diffim = (diffim > 0 ? diffim + 1 : 1);
-      okre = diffre > (mpfr_exp_t) wpre ? 0 : mpfr_can_round (mpc_realref(ab),
-                                 wpre - diffre, MPFR_RNDN, MPFR_RNDZ,
-                                 pre + (MPC_RND_RE (rnd) == MPFR_RNDN));
-      okim = diffim > (mpfr_exp_t) wpim ? 0 : mpfr_can_round (mpc_imagref(ab),
-                                 wpim - diffim, MPFR_RNDN, MPFR_RNDZ,
-                                 pim + (MPC_RND_IM (rnd) == MPFR_RNDN));
-      if (okre && okim)
+      if (!mpfr_zero_p (mpc_realref(ab)) && !mpfr_zero_p (mpc_imagref(ab))
+          && !mpfr_underflow_p () && !mpfr_overflow_p ())
         {
-          inex = mpc_set (r, ab, rnd);
-          break;
+          diffre -= mpfr_get_exp (mpc_realref(ab));
+          diffim -= mpfr_get_exp (mpc_imagref(ab));
+          diffre = (diffre > 0 ? diffre + 1 : 1);
+          diffim = (diffim > 0 ? diffim + 1 : 1);
+          okre = diffre > (mpfr_exp_t) wpre ? 0 : mpfr_can_round (mpc_realref(ab),
+                                     wpre - diffre, MPFR_RNDN, MPFR_RNDZ,
+                                     pre + (MPC_RND_RE (rnd) == MPFR_RNDN));
+          okim = diffim > (mpfr_exp_t) wpim ? 0 : mpfr_can_round (mpc_imagref(ab),
+                                     wpim - diffim, MPFR_RNDN, MPFR_RNDZ,
+                                     pim + (MPC_RND_IM (rnd) == MPFR_RNDN));
         }
-      if (i == 1)
-        break;
-      if (okre == 0 && diffre > 1)
-        wpre += diffre;
-      if (okim == 0 && diffim > 1)
-        wpim += diffim;
-      mpfr_set_prec (mpc_realref(ab), wpre);
-      mpfr_set_prec (mpc_imagref(ab), wpim);
     }
-  mpc_clear (ab);
-  return okre && okim ? inex : mpc_fma_naive (r, a, b, c, rnd);
+  mpfr_clear_underflow ();
+  mpfr_clear_overflow ();
+  if (saved_underflow)
+    mpfr_set_underflow ();
+  if (saved_overflow)
+    mpfr_set_overflow ();
+  if (okre && okim)
+    inex = mpc_set (r, ab, rnd);
+  mpc_pool_clear (ab);
+  return okre && okim ? inex : fma_sum (r, a, b, c, rnd);
+}
+
+/* r <- a*b-c, computed as a*b+(-c) */
+int
+mpc_fms (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
+{
+  mpc_t c_neg;
+  int inex;
+
+  if (r == c)
+    {
+      /* a shallow copy of c would share its significands with r, which
+         mpfr_sum or mpfr_add may overwrite while still reading them */
+      mpc_pool_init3 (c_neg, MPC_PREC_RE (c), MPC_PREC_IM (c));
+      mpc_neg (c_neg, c, MPC_RNDNN); /* exact */
+      inex = mpc_fma (r, a, b, c_neg, rnd);
+      mpc_pool_clear (c_neg);
+      return inex;
+    }
+
+  /* create the opposite of c without allocating new memory */
+  mpc_realref (c_neg)[0] = mpc_realref (c)[0];
+  mpc_imagref (c_neg)[0] = mpc_imagref (c)[0];
+  MPFR_CHANGE_SIGN (mpc_realref (c_neg));
+  MPFR_CHANGE_SIGN (mpc_imagref (c_neg));
+
+  return mpc_fma (r, a, b, c_neg, rnd);
 }
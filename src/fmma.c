@@ -0,0 +1,188 @@
+/* mpc_fmma, mpc_fmms -- Sum and difference of two products of complex
+   numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* r <- a*b+c*d: the eight exact products of the parts of a and b and of
+   c and d are computed in the extended exponent range, so that they cannot
+   overflow or underflow, and each part of r is then rounded once by
+   mpfr_sum. As for mpc_fma_naive, infinities and NaNs follow the rules
+   of the real arithmetic on the parts. */
+static int
+fmma_sum (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_srcptr d,
+          mpc_rnd_t rnd)
+{
+  mpfr_t p[8];
+  mpfr_ptr t[4];
+  mpfr_exp_t saved_emin, saved_emax;
+  int inex_re, inex_im, i;
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  mpc_pool_fr_init2 (p[0], MPC_PREC_RE (a) + MPC_PREC_RE (b));
+  mpc_pool_fr_init2 (p[1], MPC_PREC_IM (a) + MPC_PREC_IM (b));
+  mpc_pool_fr_init2 (p[2], MPC_PREC_RE (c) + MPC_PREC_RE (d));
+  mpc_pool_fr_init2 (p[3], MPC_PREC_IM (c) + MPC_PREC_IM (d));
+  mpc_pool_fr_init2 (p[4], MPC_PREC_RE (a) + MPC_PREC_IM (b));
+  mpc_pool_fr_init2 (p[5], MPC_PREC_IM (a) + MPC_PREC_RE (b));
+  mpc_pool_fr_init2 (p[6], MPC_PREC_RE (c) + MPC_PREC_IM (d));
+  mpc_pool_fr_init2 (p[7], MPC_PREC_IM (c) + MPC_PREC_RE (d));
+
+  /* all exact, and done before r is written, so that r may be the same
+     variable as any of the operands */
+  mpfr_mul (p[0], mpc_realref (a), mpc_realref (b), MPFR_RNDZ);
+  mpfr_mul (p[1], mpc_imagref (a), mpc_imagref (b), MPFR_RNDZ);
+  mpfr_neg (p[1], p[1], MPFR_RNDZ);
+  mpfr_mul (p[2], mpc_realref (c), mpc_realref (d), MPFR_RNDZ);
+  mpfr_mul (p[3], mpc_imagref (c), mpc_imagref (d), MPFR_RNDZ);
+  mpfr_neg (p[3], p[3], MPFR_RNDZ);
+  mpfr_mul (p[4], mpc_realref (a), mpc_imagref (b), MPFR_RNDZ);
+  mpfr_mul (p[5], mpc_imagref (a), mpc_realref (b), MPFR_RNDZ);
+  mpfr_mul (p[6], mpc_realref (c), mpc_imagref (d), MPFR_RNDZ);
+  mpfr_mul (p[7], mpc_imagref (c), mpc_realref (d), MPFR_RNDZ);
+
+  for (i = 0; i < 4; i++)
+    t[i] = p[i];
+  inex_re = mpfr_sum (mpc_realref (r), t, 4, MPC_RND_RE (rnd));
+  for (i = 0; i < 4; i++)
+    t[i] = p[4 + i];
+  inex_im = mpfr_sum (mpc_imagref (r), t, 4, MPC_RND_IM (rnd));
+
+  for (i = 0; i < 8; i++)
+    mpc_pool_fr_clear (p[i]);
+
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+  inex_re = mpfr_check_range (mpc_realref (r), inex_re, MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (r), inex_im, MPC_RND_IM (rnd));
+
+  return MPC_INEX (inex_re, inex_im);
+}
+
+/* Try to round one part s = x + y of a*b+c*d, where x and y are the
+   corresponding parts of a*b and c*d rounded towards zero to w bits, and
+   s is their sum rounded towards zero. Each of x and y has an error of
+   less than 1 ulp, and s adds another one, so that the total error is
+   less than 2^(e-w+2), where e is the largest exponent of x, y and s.
+   Return non-zero if s can be rounded to p bits with rounding mode rnd. */
+static int
+fmma_can_round (mpfr_srcptr s, mpfr_srcptr x, mpfr_srcptr y, mpfr_prec_t w,
+                mpfr_prec_t p, mpfr_rnd_t rnd)
+{
+  mpfr_exp_t diff;
+
+  if (mpfr_zero_p (x) || mpfr_zero_p (y) || mpfr_zero_p (s))
+    return 0;
+  diff = MPC_MAX (mpfr_get_exp (x), mpfr_get_exp (y)) - mpfr_get_exp (s);
+  diff = (diff > 0 ? diff : 0) + 2;
+  return diff < (mpfr_exp_t) w
+    && mpfr_can_round (s, w - diff, MPFR_RNDN, MPFR_RNDZ,
+                       p + (rnd == MPFR_RNDN));
+}
+
+/* As mpc_fma, we use the exact kernel of fmma_small.c for small regular
+   operands, call fmma_sum for moderate or non-finite operands, and
+   otherwise try one pass with the target precision + some extra bits,
+   which is cheaper than the exact products for large precisions. */
+int
+mpc_fmma (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_srcptr d,
+          mpc_rnd_t rnd)
+{
+  mpc_t ab, cd, s;
+  mpfr_prec_t pre, pim, wpre, wpim;
+  int inex = 0, ok;
+  int saved_underflow, saved_overflow;
+
+  /* small regular operands: compute both parts exactly on limb arrays */
+  if (MPC_MAX_PREC (a) <= MPC_SMALL_PREC && MPC_MAX_PREC (b) <= MPC_SMALL_PREC
+      && MPC_MAX_PREC (c) <= MPC_SMALL_PREC
+      && MPC_MAX_PREC (d) <= MPC_SMALL_PREC
+      && mpfr_regular_p (mpc_realref (a)) && mpfr_regular_p (mpc_imagref (a))
+      && mpfr_regular_p (mpc_realref (b)) && mpfr_regular_p (mpc_imagref (b))
+      && mpfr_regular_p (mpc_realref (c)) && mpfr_regular_p (mpc_imagref (c))
+      && mpfr_regular_p (mpc_realref (d)) && mpfr_regular_p (mpc_imagref (d))
+      && mpc_mul2_small (r, a, b, c, d, rnd, &inex))
+    return inex;
+
+  if (mpc_fin_p (a) == 0 || mpc_fin_p (b) == 0 || mpc_fin_p (c) == 0
+      || mpc_fin_p (d) == 0
+      || (MPC_MAX_PREC (a) <= MPC_FMMA_PREC && MPC_MAX_PREC (b) <= MPC_FMMA_PREC
+          && MPC_MAX_PREC (c) <= MPC_FMMA_PREC
+          && MPC_MAX_PREC (d) <= MPC_FMMA_PREC))
+    return fmma_sum (r, a, b, c, d, rnd);
+
+  pre = mpfr_get_prec (mpc_realref (r));
+  pim = mpfr_get_prec (mpc_imagref (r));
+  wpre = pre + mpc_ceil_log2 (pre) + 10;
+  wpim = pim + mpc_ceil_log2 (pim) + 10;
+  mpc_pool_init3 (ab, wpre, wpim);
+  mpc_pool_init3 (cd, wpre, wpim);
+  mpc_pool_init3 (s, wpre, wpim);
+
+  /* an underflow or overflow invalidates the error analysis */
+  saved_underflow = mpfr_underflow_p ();
+  saved_overflow = mpfr_overflow_p ();
+  mpfr_clear_underflow ();
+  mpfr_clear_overflow ();
+
+  mpc_mul (ab, a, b, MPC_RNDZZ);
+  mpc_mul (cd, c, d, MPC_RNDZZ);
+  mpc_add (s, ab, cd, MPC_RNDZZ);
+  ok = !mpfr_underflow_p () && !mpfr_overflow_p ()
+    && fmma_can_round (mpc_realref (s), mpc_realref (ab), mpc_realref (cd),
+                       wpre, pre, MPC_RND_RE (rnd))
+    && fmma_can_round (mpc_imagref (s), mpc_imagref (ab), mpc_imagref (cd),
+                       wpim, pim, MPC_RND_IM (rnd));
+
+  mpfr_clear_underflow ();
+  mpfr_clear_overflow ();
+  if (saved_underflow)
+    mpfr_set_underflow ();
+  if (saved_overflow)
+    mpfr_set_overflow ();
+  if (ok)
+    inex = mpc_set (r, s, rnd);
+  mpc_pool_clear (ab);
+  mpc_pool_clear (cd);
+  mpc_pool_clear (s);
+  return ok ? inex : fmma_sum (r, a, b, c, d, rnd);
+}
+
+/* r <- a*b-c*d, computed as a*b+c*(-d) */
+int
+mpc_fmms (mpc_ptr r, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_srcptr d,
+          mpc_rnd_t rnd)
+{
+  mpc_t d_neg;
+
+  /* create the opposite of d without allocating new memory; since both
+     functions above read all operands before writing r, r may be the same
+     variable as d */
+  mpc_realref (d_neg)[0] = mpc_realref (d)[0];
+  mpc_imagref (d_neg)[0] = mpc_imagref (d)[0];
+  MPFR_CHANGE_SIGN (mpc_realref (d_neg));
+  MPFR_CHANGE_SIGN (mpc_imagref (d_neg));
+
+  return mpc_fmma (r, a, b, c, d_neg, rnd);
+}
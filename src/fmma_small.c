@@ -0,0 +1,345 @@
+/* mpc_fmma_small, mpc_mul_small, mpc_mul2_small, mpc_div_small -- Exact
+   kernels for small precisions.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* When all operands have at most MPC_SMALL_LIMBS limbs, a sum such as
+   a*b - c*d is computed exactly with fixed-size limb arrays: each term is
+   an integer significand of at most 2*MPC_SMALL_LIMBS limbs and an
+   exponent, and is added at its position to an accumulator for the
+   positive terms or for the negative terms. The difference of both
+   accumulators is the exact result, which is then rounded once by
+   mpfr_set; this gives the same results and ternary values as mpfr_fmma
+   and mpfr_fmms, without their generic dispatch and temporary
+   allocations.
+
+   The accumulators represent A * 2^B, where B is the exponent of the
+   least significant bit of all terms, and have the n limbs needed to hold
+   the sum of the terms with the possible carries. Sums for which n exceeds
+   MPC_SMALL_ACC_LIMBS, that is, with terms whose exponents are far apart,
+   and exact results outside the current exponent range are not handled;
+   the caller then falls back to the generic code. */
+
+#define L MPC_SMALL_ACC_LIMBS
+
+/* the significand of the regular number x and its number of limbs */
+#define FR_MANT(x)      ((mp_limb_t *) mpfr_custom_get_significand (x))
+#define FR_LIMB_SIZE(x) ((mpfr_get_prec (x) - 1) / GMP_NUMB_BITS + 1)
+
+typedef struct {
+  mp_limb_t m [2 * MPC_SMALL_LIMBS]; /* integer significand */
+  mp_size_t k;                       /* number of limbs of m */
+  mpfr_exp_t e;                      /* |term| = m * 2^(e - k*GMP_NUMB_BITS) */
+  int neg;
+} small_term;
+
+/* {p, 2} <- u*v, as umul_ppmm of GMP's longlong.h */
+static void
+mul_1_1 (mp_limb_t *p, mp_limb_t u, mp_limb_t v)
+{
+  const unsigned int hb = GMP_NUMB_BITS / 2;
+  const mp_limb_t lm = ((mp_limb_t) 1 << hb) - 1;
+  mp_limb_t ul = u & lm, uh = u >> hb, vl = v & lm, vh = v >> hb;
+  mp_limb_t x0 = ul * vl, x1 = ul * vh, x2 = uh * vl, x3 = uh * vh;
+
+  x1 += x0 >> hb;
+  x1 += x2;
+  if (x1 < x2)
+    x3 += (mp_limb_t) 1 << hb;
+  p [1] = x3 + (x1 >> hb);
+  p [0] = (x1 << hb) + (x0 & lm);
+}
+
+/* t <- s*x*y */
+static void
+term_mul (small_term *t, mpfr_srcptr x, mpfr_srcptr y, int s)
+{
+  mp_size_t kx = FR_LIMB_SIZE (x), ky = FR_LIMB_SIZE (y);
+
+  if (kx == 1 && ky == 1)
+    mul_1_1 (t->m, FR_MANT (x) [0], FR_MANT (y) [0]);
+  else if (kx >= ky)
+    mpn_mul (t->m, FR_MANT (x), kx, FR_MANT (y), ky);
+  else
+    mpn_mul (t->m, FR_MANT (y), ky, FR_MANT (x), kx);
+  t->k = kx + ky;
+  t->e = mpfr_get_exp (x) + mpfr_get_exp (y);
+  t->neg = ((mpfr_signbit (x) != mpfr_signbit (y)) != (s < 0));
+}
+
+/* t <- x */
+static void
+term_set (small_term *t, mpfr_srcptr x)
+{
+  t->k = FR_LIMB_SIZE (x);
+  mpn_copyi (t->m, FR_MANT (x), t->k);
+  t->e = mpfr_get_exp (x);
+  t->neg = (mpfr_signbit (x) != 0);
+}
+
+/* return the number of leading zero bits of the nonzero limb x */
+static unsigned int
+leading_zeros (mp_limb_t x)
+{
+  unsigned int n = 0, s;
+
+  for (s = GMP_NUMB_BITS / 2; s != 0; s /= 2)
+    if ((x >> (GMP_NUMB_BITS - s)) == 0)
+      {
+        x <<= s;
+        n += s;
+      }
+  return n;
+}
+
+/* add the term t to the accumulator acc of n limbs representing A * 2^b;
+   the loops below are short, and written out instead of calling the mpn
+   functions, whose call overhead dominates at these sizes */
+static void
+acc_add (mp_limb_t *acc, mp_size_t n, const small_term *t, mpfr_exp_t b)
+{
+  mpfr_exp_t s = t->e - t->k * GMP_NUMB_BITS - b; /* shift of t->m */
+  mp_size_t off = (mp_size_t) (s / GMP_NUMB_BITS), k = t->k, i;
+  unsigned int sh = (unsigned int) (s % GMP_NUMB_BITS);
+  mp_limb_t x, v, prev = 0, cy = 0;
+
+  /* since |term| < 2^(emax-b) < 2^(n*GMP_NUMB_BITS-1), off + k < n */
+  acc += off;
+  n -= off;
+  for (i = 0; i < k; i++)
+    {
+      x = t->m [i];
+      v = (sh == 0) ? x : (x << sh) | prev;
+      prev = (sh == 0) ? 0 : x >> (GMP_NUMB_BITS - sh);
+      v += cy;
+      cy = (v < cy);
+      acc [i] += v;
+      cy += (acc [i] < v);
+    }
+  v = prev + cy;
+  acc [i] += v;
+  cy = (acc [i] < v);
+  i++;
+  for (; cy != 0 && i < n; i++)
+    cy = ((acc [i] += 1) == 0);
+}
+
+/* Set w to the exact sum of the n_terms terms t, with n_terms <= 4; w is a
+   custom variable with significand in buf, of size MPC_SMALL_ACC_LIMBS
+   limbs. An exact zero result has the sign given by the IEEE 754 rules for
+   the rounding mode rnd.
+   Return 0 if the sum cannot be handled, in which case w is not set. */
+static int
+small_sum (mpfr_ptr w, mp_limb_t *buf, const small_term *t, int n_terms,
+           mpfr_rnd_t rnd)
+{
+  mp_limb_t neg [L];
+  mp_limb_t *pos = buf;
+  mpfr_exp_t emax, base, lsb, exp;
+  mp_limb_t x, y, borrow;
+  int n_neg = 0, negative;
+  mp_size_t n, h, i;
+  unsigned int shift;
+
+  emax = t [0].e;
+  base = t [0].e - t [0].k * GMP_NUMB_BITS;
+  for (i = 1; i < n_terms; i++)
+    {
+      if (t [i].e > emax)
+        emax = t [i].e;
+      lsb = t [i].e - t [i].k * GMP_NUMB_BITS;
+      if (lsb < base)
+        base = lsb;
+    }
+  /* the sum of at most 4 terms less than 2^emax is less than 2^(emax+2) */
+  if (emax + 2 - base > (mpfr_exp_t) L * GMP_NUMB_BITS)
+    return 0;
+  n = (mp_size_t) ((emax + 1 - base) / GMP_NUMB_BITS + 1);
+
+  for (i = 0; i < L; i++)
+    pos [i] = neg [i] = 0;
+  for (i = 0; i < n_terms; i++)
+    {
+      acc_add (t [i].neg ? neg : pos, n, &t [i], base);
+      n_neg += t [i].neg;
+    }
+
+  /* pos <- |pos - neg| */
+  if (n_neg == 0)
+    negative = 0;
+  else if (n_neg == n_terms)
+    {
+      for (i = 0; i < n; i++)
+        pos [i] = neg [i];
+      negative = 1;
+    }
+  else
+    {
+      for (h = n - 1; h > 0 && pos [h] == neg [h]; h--);
+      if (pos [h] == neg [h])
+        {
+          mpfr_custom_init_set (w, (rnd == MPFR_RNDD) ? -MPFR_ZERO_KIND
+                                : MPFR_ZERO_KIND, 0, GMP_NUMB_BITS, buf);
+          return 1;
+        }
+      negative = (pos [h] < neg [h]);
+      for (i = 0, borrow = 0; i <= h; i++)
+        {
+          x = negative ? neg [i] : pos [i];
+          y = (negative ? pos [i] : neg [i]) + borrow;
+          borrow = (y < borrow) | (x < y);
+          pos [i] = x - y;
+        }
+      n = h + 1; /* the limbs above h cancel */
+    }
+
+  /* normalize the significand */
+  for (h = n - 1; pos [h] == 0; h--);
+  shift = leading_zeros (pos [h]);
+  exp = base + (mpfr_exp_t) ((h + 1) * GMP_NUMB_BITS - shift);
+  if (exp < mpfr_get_emin () || exp > mpfr_get_emax ())
+    return 0;
+  if (shift != 0)
+    {
+      for (i = h; i > 0; i--)
+        pos [i] = (pos [i] << shift) | (pos [i - 1] >> (GMP_NUMB_BITS - shift));
+      pos [0] <<= shift;
+    }
+  mpfr_custom_init_set (w, negative ? -MPFR_REGULAR_KIND : MPFR_REGULAR_KIND,
+                        exp, (h + 1) * GMP_NUMB_BITS, pos);
+  return 1;
+}
+
+/* Set w to a*b + sign*c*d + e exactly, where c and d may both be NULL and
+   e may be NULL, and all given operands are regular numbers of at most
+   MPC_SMALL_LIMBS limbs; w is a custom variable with significand in buf,
+   of size MPC_SMALL_ACC_LIMBS limbs. An exact zero result has the sign
+   given by the IEEE 754 rules for the rounding mode rnd.
+   Return 0 if the sum cannot be handled, in which case w is not set. */
+int
+mpc_fmma_small (mpfr_ptr w, mp_limb_t *buf, mpfr_srcptr a, mpfr_srcptr b,
+                mpfr_srcptr c, mpfr_srcptr d, int sign, mpfr_srcptr e,
+                mpfr_rnd_t rnd)
+{
+  small_term t [3];
+  int n_terms = 0;
+
+  term_mul (&t [n_terms++], a, b, +1);
+  if (c != NULL)
+    term_mul (&t [n_terms++], c, d, sign);
+  if (e != NULL)
+    term_set (&t [n_terms++], e);
+  return small_sum (w, buf, t, n_terms, rnd);
+}
+
+/* Set z to x*y + c, or to x*y if c is NULL, correctly rounded, when all
+   parts of x, y and c are regular numbers of at most MPC_SMALL_LIMBS limbs.
+   z may be the same variable as an operand.
+   Return 0 if the exponents do not allow the exact kernel, in which case
+   z is not modified; otherwise store the ternary value into *inex. */
+int
+mpc_mul_small (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_srcptr c,
+               mpc_rnd_t rnd, int *inex)
+{
+  mp_limb_t re [L], im [L];
+  mpfr_t u, v;
+  int inex_re, inex_im;
+
+  if (!mpc_fmma_small (u, re, mpc_realref (x), mpc_realref (y),
+                       mpc_imagref (x), mpc_imagref (y), -1,
+                       (c == NULL) ? NULL : mpc_realref (c), MPC_RND_RE (rnd))
+      || !mpc_fmma_small (v, im, mpc_realref (x), mpc_imagref (y),
+                          mpc_imagref (x), mpc_realref (y), +1,
+                          (c == NULL) ? NULL : mpc_imagref (c),
+                          MPC_RND_IM (rnd)))
+    return 0;
+
+  inex_re = mpfr_set (mpc_realref (z), u, MPC_RND_RE (rnd));
+  inex_im = mpfr_set (mpc_imagref (z), v, MPC_RND_IM (rnd));
+  *inex = MPC_INEX (inex_re, inex_im);
+  return 1;
+}
+
+/* Set z to a*b + c*d, correctly rounded, when all parts of a, b, c
+   and d are regular numbers of at most MPC_SMALL_LIMBS limbs: each part is
+   the exact sum of four products, rounded once. z may be the same variable
+   as an operand.
+   Return 0 if the exponents do not allow the exact kernel, in which case
+   z is not modified; otherwise store the ternary value into *inex. */
+int
+mpc_mul2_small (mpc_ptr z, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c,
+                mpc_srcptr d, mpc_rnd_t rnd, int *inex)
+{
+  mp_limb_t re [L], im [L];
+  small_term t [4];
+  mpfr_t u, v;
+  int inex_re, inex_im;
+
+  term_mul (&t [0], mpc_realref (a), mpc_realref (b), +1);
+  term_mul (&t [1], mpc_imagref (a), mpc_imagref (b), -1);
+  term_mul (&t [2], mpc_realref (c), mpc_realref (d), +1);
+  term_mul (&t [3], mpc_imagref (c), mpc_imagref (d), -1);
+  if (!small_sum (u, re, t, 4, MPC_RND_RE (rnd)))
+    return 0;
+  term_mul (&t [0], mpc_realref (a), mpc_imagref (b), +1);
+  term_mul (&t [1], mpc_imagref (a), mpc_realref (b), +1);
+  term_mul (&t [2], mpc_realref (c), mpc_imagref (d), +1);
+  term_mul (&t [3], mpc_imagref (c), mpc_realref (d), +1);
+  if (!small_sum (v, im, t, 4, MPC_RND_IM (rnd)))
+    return 0;
+
+  inex_re = mpfr_set (mpc_realref (z), u, MPC_RND_RE (rnd));
+  inex_im = mpfr_set (mpc_imagref (z), v, MPC_RND_IM (rnd));
+  *inex = MPC_INEX (inex_re, inex_im);
+  return 1;
+}
+
+/* Set z to x/y, correctly rounded, when all parts of x and y are regular
+   numbers of at most MPC_SMALL_LIMBS limbs: the real and imaginary parts
+   of x*conj(y) and the norm of y are computed exactly, so that each part
+   of the quotient needs a single division. z may be the same variable as
+   an operand.
+   Return 0 if the exponents do not allow the exact kernel, in which case
+   z is not modified; otherwise store the ternary value into *inex. */
+int
+mpc_div_small (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd,
+               int *inex)
+{
+  mp_limb_t re [L], im [L], nm [L];
+  mpfr_t u, v, n;
+  int inex_re, inex_im;
+
+  /* as in mpc_div, an exact zero part of x*conj(y) is +0 */
+  if (!mpc_fmma_small (u, re, mpc_realref (x), mpc_realref (y),
+                       mpc_imagref (x), mpc_imagref (y), +1, NULL, MPFR_RNDZ)
+      || !mpc_fmma_small (v, im, mpc_imagref (x), mpc_realref (y),
+                          mpc_realref (x), mpc_imagref (y), -1, NULL,
+                          MPFR_RNDZ)
+      || !mpc_fmma_small (n, nm, mpc_realref (y), mpc_realref (y),
+                          mpc_imagref (y), mpc_imagref (y), +1, NULL,
+                          MPFR_RNDZ))
+    return 0;
+
+  inex_re = mpfr_div (mpc_realref (z), u, n, MPC_RND_RE (rnd));
+  inex_im = mpfr_div (mpc_imagref (z), v, n, MPC_RND_IM (rnd));
+  *inex = MPC_INEX (inex_re, inex_im);
+  return 1;
+}
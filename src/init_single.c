@@ -0,0 +1,55 @@
+/* mpc_init2_single, mpc_clear_single -- Initialize or free a complex
+   variable whose parts share one block of memory.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* The significand of the imaginary part directly follows the one of the
+   real part; both parts are MPFR custom variables of the same precision. */
+
+void
+mpc_init2_single (mpc_ptr z, mpfr_prec_t prec)
+{
+  void * (*allocfunc) (size_t);
+  size_t size = mpfr_custom_get_size (prec);
+  mp_limb_t *d;
+
+  mp_get_memory_functions (&allocfunc, NULL, NULL);
+  d = (mp_limb_t *) (*allocfunc) (2 * size);
+  mpfr_custom_init (d, prec);
+  mpfr_custom_init_set (mpc_realref (z), MPFR_NAN_KIND, 0, prec, d);
+  d += size / sizeof (mp_limb_t);
+  mpfr_custom_init (d, prec);
+  mpfr_custom_init_set (mpc_imagref (z), MPFR_NAN_KIND, 0, prec, d);
+}
+
+/* Functions such as mpc_mul_i may exchange the parts of z with mpfr_swap,
+   so that the block starts at the lower of the two significands. */
+void
+mpc_clear_single (mpc_ptr z)
+{
+  void (*freefunc) (void *, size_t);
+  mp_limb_t *re = (mp_limb_t *) mpfr_custom_get_significand (mpc_realref (z));
+  mp_limb_t *im = (mp_limb_t *) mpfr_custom_get_significand (mpc_imagref (z));
+
+  mp_get_memory_functions (NULL, NULL, &freefunc);
+  (*freefunc) (im < re ? im : re,
+               2 * mpfr_custom_get_size (mpfr_get_prec (mpc_realref (z))));
+}
@@ -0,0 +1,39 @@
+/* mpc_inv -- Inverse of a complex number.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+int
+mpc_inv (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+   int inex;
+   MPC_DECL_INIT (one, MPFR_PREC_MIN);
+
+   /* 1/op = conj(op)/norm(op): if both parts of op are regular, only the
+      norm is computed, exactly in general, and each part of the result
+      is obtained by a single division */
+   if (mpfr_regular_p (mpc_realref (op)) && mpfr_regular_p (mpc_imagref (op))
+       && mpc_div_fmma (rop, NULL, op, rnd, &inex))
+      return inex;
+
+   /* special values, real or purely imaginary op, and huge exponents */
+   mpc_set_ui (one, 1, MPC_RNDNN);
+   return mpc_div (rop, one, op, rnd);
+}
@@ -21,11 +21,171 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 #include <stdio.h> /* for MPC_ASSERT */
 #include "mpc-impl.h"
 
+/* Return non-zero if x is non-zero and can be rounded to the precision of
+   y according to rnd, given that its error is at most 2^err ulps. */
+static int
+can_round_log (mpfr_srcptr x, mpfr_exp_t err, mpfr_srcptr y, mpfr_rnd_t rnd)
+{
+   return !mpfr_zero_p (x) && err < (mpfr_exp_t) mpfr_get_prec (x)
+      && mpfr_can_round (x, mpfr_get_prec (x) - err, MPFR_RNDN, MPFR_RNDZ,
+                         mpfr_get_prec (y) + (rnd == MPFR_RNDN));
+}
+
+/* Try to compute the logarithm of op through an arithmetic-geometric
+   mean, which is asymptotically faster than the real logarithm and
+   arctangent of mpc_log, see algorithms.tex: with
+   s = 2^m (|Re op| + i |Im op|),
+   log (conj (s)) = pi / (2 AGM (1, 4 / conj (s))) up to a relative error
+   of |4/s|^2, and log (op) is deduced from log (conj (s)) by subtracting
+   m log 2 and by symmetry. Both parts of op must be non-zero.
+   A part of the result that is small compared to the other one is only
+   known with a large relative error, for instance when op is very close
+   to the unit circle or to the real axis. So if the result cannot be
+   rounded after two attempts, return 0 and leave rop unchanged;
+   otherwise set rop, put the ternary value into *inex and return 1. */
+int
+mpc_log_agm (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, int *inex)
+{
+   mpc_t b0, w, g;
+   mpfr_t x, y, c, re, im;
+   mpfr_prec_t prec, l;
+   mpfr_exp_t saved_emin, saved_emax, e, m, eg, err_re, err_im;
+   int ok, loops, inex_re, inex_im;
+
+   MPC_ASSERT (mpfr_regular_p (mpc_realref (op))
+               && mpfr_regular_p (mpc_imagref (op)));
+
+   /* if op is close to the positive real axis, its argument is about
+      Im (op) / Re (op), and both attempts below are bound to fail */
+   prec = MPC_MAX_PREC (rop);
+   if (mpfr_sgn (mpc_realref (op)) > 0
+       && mpfr_get_exp (mpc_realref (op)) - mpfr_get_exp (mpc_imagref (op))
+          > 2 * (mpfr_exp_t) mpc_ceil_log2 (prec) + 40)
+      return 0;
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
+
+   /* x + i y = 2^(-e) (|Re op| + i |Im op|) with max (Exp (x), Exp (y)) = 0,
+      as shallow copies; this fails only for exponents that differ by more
+      than the extended exponent range */
+   e = MPC_MAX (mpfr_get_exp (mpc_realref (op)),
+                mpfr_get_exp (mpc_imagref (op)));
+   x [0] = mpc_realref (op) [0];
+   y [0] = mpc_imagref (op) [0];
+   if (mpfr_signbit (x))
+      MPFR_CHANGE_SIGN (x);
+   if (mpfr_signbit (y))
+      MPFR_CHANGE_SIGN (y);
+   if (mpfr_set_exp (x, mpfr_get_exp (x) - e) != 0
+       || mpfr_set_exp (y, mpfr_get_exp (y) - e) != 0) {
+      mpfr_set_emin (saved_emin);
+      mpfr_set_emax (saved_emax);
+      return 0;
+   }
+
+   mpc_pool_init2 (b0, MPFR_PREC_MIN);
+   mpc_pool_init2 (w, MPFR_PREC_MIN);
+   mpc_pool_init2 (g, MPFR_PREC_MIN);
+   mpc_pool_fr_init2 (c, MPFR_PREC_MIN);
+   mpc_pool_fr_init2 (re, MPFR_PREC_MIN);
+   mpc_pool_fr_init2 (im, MPFR_PREC_MIN);
+   ok = 0;
+   for (loops = 1; !ok && loops <= 2; loops++) {
+      prec += (loops == 1 ? 4 : 1) * mpc_ceil_log2 (prec) + 20;
+      mpc_pool_set_prec (b0, prec);
+      mpc_pool_set_prec (w, prec);
+      mpc_pool_set_prec (g, prec);
+      mpc_pool_fr_set_prec (c, prec);
+      mpc_pool_fr_set_prec (re, prec);
+      mpc_pool_fr_set_prec (im, prec);
+
+      /* m = floor (prec/2) + 4 - e, so that |s| >= 2^(floor(prec/2)+3)
+         and |4/s| <= 2^(-prec/2); then
+         b0 = 4 / conj (s) = 2^(-floor(prec/2)-2) (x + i y) / (x^2 + y^2)
+         lies in the first quadrant. Both of its parts are rounded towards
+         0 with a relative error at most 3.03 * 2^(1-prec); unlike mpc_div,
+         this does not depend on the difference of the exponents of x
+         and y. */
+      m = (mpfr_exp_t) (prec / 2) + 4 - e;
+      mpfr_sqr (c, x, MPFR_RNDU);
+      mpfr_sqr (re, y, MPFR_RNDU);
+      mpfr_add (c, c, re, MPFR_RNDU);
+      mpfr_div (mpc_realref (b0), x, c, MPFR_RNDZ);
+      mpfr_div (mpc_imagref (b0), y, c, MPFR_RNDZ);
+      if (mpfr_zero_p (mpc_realref (b0)) || mpfr_zero_p (mpc_imagref (b0)))
+         /* underflow for extremely different exponents of x and y */
+         break;
+      mpc_mul_2si (b0, b0, - (long) (prec / 2) - 2, MPC_RNDNN);
+      l = mpc_agm1_approx (w, b0);
+      if (l >= prec)
+         continue;
+
+      /* g = pi / (2 w) approximates log (conj (s)) with a relative error
+         at most 2^(l-prec), so that both of its parts have an absolute
+         error at most 2^(eg+l+1-prec) */
+      mpfr_const_pi (c, MPFR_RNDN);
+      mpc_fr_div (g, c, w, MPC_RNDNN);
+      mpc_div_2ui (g, g, 1, MPC_RNDNN);
+      eg = MPC_MAX (mpfr_get_exp (mpc_realref (g)),
+                    mpfr_get_exp (mpc_imagref (g)));
+
+      /* the imaginary part of g is minus the argument of s */
+      if (mpfr_signbit (mpc_realref (op)))
+         mpfr_add (im, c, mpc_imagref (g), MPFR_RNDN);
+      else
+         mpfr_neg (im, mpc_imagref (g), MPFR_RNDN);
+      err_im = eg + l + 2 - mpfr_get_exp (im);
+
+      /* c = m log 2 with an error at most 2^(Exp (c) + 1 - prec) */
+      mpfr_const_log2 (c, MPFR_RNDN);
+      mpfr_mul_si (c, c, m, MPFR_RNDN);
+      mpfr_sub (re, mpc_realref (g), c, MPFR_RNDN);
+      if (mpfr_zero_p (re))
+         err_re = prec;
+      else {
+         err_re = eg + l + 1;
+         if (!mpfr_zero_p (c))
+            err_re = MPC_MAX (err_re, mpfr_get_exp (c) + 1);
+         err_re += 2 - mpfr_get_exp (re);
+      }
+
+      ok = can_round_log (re, err_re, mpc_realref (rop), MPC_RND_RE (rnd))
+         && can_round_log (im, err_im, mpc_imagref (rop), MPC_RND_IM (rnd));
+   }
+
+   if (ok) {
+      if (mpfr_signbit (mpc_imagref (op)))
+         mpfr_neg (im, im, MPFR_RNDN);
+      inex_re = mpfr_set (mpc_realref (rop), re, MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), im, MPC_RND_IM (rnd));
+   }
+   mpc_pool_fr_clear (im);
+   mpc_pool_fr_clear (re);
+   mpc_pool_fr_clear (c);
+   mpc_pool_clear (g);
+   mpc_pool_clear (w);
+   mpc_pool_clear (b0);
+
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   if (ok) {
+      inex_re = mpfr_check_range (mpc_realref (rop), inex_re,
+                                  MPC_RND_RE (rnd));
+      inex_im = mpfr_check_range (mpc_imagref (rop), inex_im,
+                                  MPC_RND_IM (rnd));
+      *inex = MPC_INEX (inex_re, inex_im);
+   }
+   return ok;
+}
+
 int
 mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
    int ok, underflow = 0;
    mpfr_srcptr x, y;
-   mpfr_t v, w;
+   mpfr_t u, v, w;
    mpfr_prec_t prec;
    int loops;
    int re_cmp, im_cmp;
@@ -115,6 +275,10 @@ mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
       return MPC_INEX(inex_re, inex_im);
    }
 
+   if (MPC_MAX_PREC (rop) >= MPC_LOG_AGM_PREC
+       && mpc_log_agm (rop, op, rnd, &inex_re))
+      return inex_re;
+
    prec = MPC_PREC_RE(rop);
    mpfr_init2 (w, 2);
    /* let op = x + iy; log = 1/2 log (x^2 + y^2) + i atan2 (y, x)   */
@@ -173,8 +337,12 @@ mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
          mpfr_div_2ui (v, v, 1, MPFR_RNDD);
             /* If the result is 0, then there has been an underflow somewhere. */
 
-         mpfr_abs (w, x, MPFR_RNDN); /* exact */
-         mpfr_log (w, w, MPFR_RNDN); /* error 0.5 ulp */
+         /* w may have a smaller precision than x, so take the logarithm
+            of a shallow copy of |x| */
+         u [0] = x [0];
+         if (mpfr_signbit (u))
+            MPFR_CHANGE_SIGN (u);
+         mpfr_log (w, u, MPFR_RNDN); /* error 0.5 ulp */
          expw = mpfr_get_exp (w);
          sgnw = mpfr_signbit (w);
 
@@ -182,8 +350,11 @@ mpc_log (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd){
          if (!sgnw) /* v is positive, so no cancellation;
                        error 22.25 ulp; error counts lost bits */
             err = 5;
+         else if (mpfr_zero_p (w))
+            /* complete cancellation, impossible to round */
+            err = (int) prec;
          else
-            err =   MPC_MAX (5 + mpfr_get_exp (v),
+            err =   MPC_MAX (5 + mpfr_get_exp (v) - mpfr_get_exp (w),
                   /* 21.25 ulp (v) rewritten in ulp (result, now in w) */
                            -1 + expw             - mpfr_get_exp (w)
                   /* 0.5 ulp (previous w), rewritten in ulp (result) */
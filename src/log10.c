@@ -44,15 +44,15 @@ mpc_log10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
    mpfr_set_emin (mpfr_get_emin_min ());
    mpfr_set_emax (mpfr_get_emax_max ());
 
-   mpfr_init2 (log10, 2);
-   mpc_init2 (log, 2);
+   mpc_pool_fr_init2 (log10, 2);
+   mpc_pool_init2 (log, 2);
    prec = MPC_MAX_PREC (rop);
    /* compute log(op)/log(10) */
    while (ok == 0) {
       loops ++;
       prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 4 : prec / 2;
-      mpfr_set_prec (log10, prec);
-      mpc_set_prec (log, prec);
+      mpc_pool_fr_set_prec (log10, prec);
+      mpc_pool_set_prec (log, prec);
 
       inex = mpc_log (log, op, rnd); /* error <= 1 ulp */
 
@@ -126,8 +126,8 @@ mpc_log10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
                   /* Re(log10(x+i*y)) is exactly v/2
                      we reset the precision of Re(log) so that v can be
                      represented exactly */
-                  mpfr_set_prec (mpc_realref (log),
-                                 sizeof(unsigned long)*CHAR_BIT);
+                  mpc_pool_fr_set_prec (mpc_realref (log),
+                                        sizeof(unsigned long)*CHAR_BIT);
                   mpfr_set_ui_2exp (mpc_realref (log), v, -1, MPFR_RNDN);
                      /* exact */
                   ok = 1;
@@ -146,8 +146,8 @@ mpc_log10 (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
    inex_im = mpfr_set (mpc_imagref(rop), mpc_imagref (log), MPC_RND_IM (rnd));
    if (special_im)
       inex_im = MPC_INEX_IM (inex);
-   mpfr_clear (log10);
-   mpc_clear (log);
+   mpc_pool_fr_clear (log10);
+   mpc_pool_clear (log);
 
    /* restore the exponent range, and check the range of results */
    mpfr_set_emin (saved_emin);
@@ -0,0 +1,394 @@
+/* mpc_log1p -- Logarithm of one plus a complex number.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* Put in r an approximation of atan (x) - x for 0 < |x| < 1, with an error
+   of at most 4 ulps, see algorithms.tex. */
+static void
+atan_minus_id (mpfr_ptr r, mpfr_srcptr x)
+{
+  mpfr_prec_t p = mpfr_get_prec (r);
+  mpfr_exp_t e = mpfr_get_exp (x);
+  mpfr_t t;
+
+  if (2 * e < - (mpfr_exp_t) p - 3)
+    {
+      /* -x^3/3 approximates atan (x) - x with relative error
+         less than 2^(-p-3) */
+      mpfr_sqr (r, x, MPFR_RNDN);
+      mpfr_mul (r, r, x, MPFR_RNDN);
+      mpfr_div_ui (r, r, 3, MPFR_RNDN);
+      mpfr_neg (r, r, MPFR_RNDN);
+    }
+  else
+    {
+      /* |atan (x) - x| >= 2^(3*e-6) */
+      mpc_pool_fr_init2 (t, p - 2 * e + 6);
+      mpfr_atan (t, x, MPFR_RNDN);
+      mpfr_sub (r, t, x, MPFR_RNDN);
+      mpc_pool_fr_clear (t);
+    }
+}
+
+/* Put in r an approximation of log1p (q) - q + q^2/2 for 0 < |q| <= 5/8,
+   with an error of at most 4 ulps, see algorithms.tex. */
+static void
+log1p_minus_quad (mpfr_ptr r, mpfr_srcptr q)
+{
+  mpfr_prec_t p = mpfr_get_prec (r);
+  mpfr_exp_t e = mpfr_get_exp (q);
+  mpfr_t t, mq, qq;
+  mpfr_srcptr tab [3];
+
+  if (e < - (mpfr_exp_t) p - 2)
+    {
+      /* q^3/3 approximates log1p (q) - q + q^2/2 with relative error
+         less than 2^(-p-2) */
+      mpfr_sqr (r, q, MPFR_RNDN);
+      mpfr_mul (r, r, q, MPFR_RNDN);
+      mpfr_div_ui (r, r, 3, MPFR_RNDN);
+    }
+  else
+    {
+      /* |log1p (q) - q + q^2/2| >= 2^(3*e-6), so that -2*e+8 more bits
+         absorb the cancellation; q and q^2/2 are added exactly */
+      mpc_pool_fr_init2 (t, p - 2 * e + 8);
+      mpc_pool_fr_init2 (qq, 2 * mpfr_get_prec (q));
+      mpfr_log1p (t, q, MPFR_RNDN);
+      mpfr_sqr (qq, q, MPFR_RNDN);
+      mpfr_div_2ui (qq, qq, 1, MPFR_RNDN);
+      mq [0] = q [0];
+      MPFR_CHANGE_SIGN (mq);
+      tab [0] = t;
+      tab [1] = mq;
+      tab [2] = qq;
+      mpfr_sum (r, (mpfr_ptr *) tab, 3, MPFR_RNDN);
+      mpc_pool_fr_clear (t);
+      mpc_pool_fr_clear (qq);
+    }
+}
+
+/* Compute log1p (op) for op = x + i*y with |x| < 1/4 and 0 < |y| < 1/4 in
+   the extended exponent range; then
+      log1p (op) = x + y^2/2 - x^2/2 + 1/2 (log1p (q) - q + q^2/2)
+                   - x n - n^2/4
+                 + i (y + atan (w) - w - x w),
+   where q = x (2+x) + y^2, n = x^2 + y^2 and w = y / (1+x), so that
+   w - y = -x w. As in mpc_expm1, x, x^2, y and y^2 are exact, the other
+   terms, which are of order 3 in op, are computed with relative errors
+   that do not depend on the exponents of x and y, and the rounding of the
+   sums is decided by mpc_round_sum, see algorithms.tex. */
+static int
+log1p_small (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpfr_srcptr x = mpc_realref (op), y = mpc_imagref (op);
+  mpfr_srcptr tab [3];
+  mpfr_t a, c, u, w, q, t, n4, xx, yy, re, im;
+  mpfr_prec_t prec;
+  mpfr_exp_t err, eq;
+  int ok, loops, inex_re, inex_im;
+
+  mpc_pool_fr_init2 (a, 2);
+  mpc_pool_fr_init2 (c, 2);
+  mpc_pool_fr_init2 (u, 2);
+  mpc_pool_fr_init2 (w, 2);
+  mpc_pool_fr_init2 (q, 2);
+  mpc_pool_fr_init2 (t, 2);
+  mpc_pool_fr_init2 (re, MPC_PREC_RE (rop));
+  mpc_pool_fr_init2 (im, MPC_PREC_IM (rop));
+
+  /* imaginary part y + (atan (w) - w) - x w, where w has an error of at
+     most 4 ulps, which changes atan (w) - w by at most 2^(3 Exp (w) + 2)
+     ulps of 1; then atan (w) - w has an error of at most 4 ulps plus this
+     amount, and x w an error of at most 16 ulps; with the final rounding,
+     the error is at most
+     2^(max (Exp (a) + 2, 3 Exp (w) + 3, Exp (c) + 4, Exp (t) - 1) + 2
+        - prec) */
+  tab [0] = y;
+  prec = MPC_PREC_IM (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (a, prec);
+      mpc_pool_fr_set_prec (c, prec);
+      mpc_pool_fr_set_prec (u, prec);
+      mpc_pool_fr_set_prec (w, prec);
+      mpc_pool_fr_set_prec (t, prec);
+
+      mpfr_add_ui (u, x, 1, MPFR_RNDN);
+      mpfr_div (w, y, u, MPFR_RNDN);
+      atan_minus_id (a, w);
+      mpfr_mul (c, x, w, MPFR_RNDN);
+      mpfr_sub (t, a, c, MPFR_RNDN);
+      err = MPC_MAX (mpfr_get_exp (a) + 2, 3 * mpfr_get_exp (w) + 3);
+      if (!mpfr_zero_p (x))
+        err = MPC_MAX (err, mpfr_get_exp (c) + 4);
+      if (!mpfr_zero_p (t))
+        err = MPC_MAX (err, mpfr_get_exp (t) - 1);
+      ok = mpc_round_sum (im, tab, 1, t, err + 2 - (mpfr_exp_t) prec,
+                          MPC_RND_IM (rnd), &inex_im);
+    }
+
+  /* real part x + y^2/2 - x^2/2 + a - c with
+     a = 1/2 (log1p (q) - q + q^2/2) and c = x n + n^2/4, where q has an
+     error of at most 2^eq, which changes a by at most
+     2^(2 max (Exp (q), eq) + eq + 1), and a has an error of at most
+     4 ulps plus this amount; n has an error of at most 1/2 ulp, which
+     changes c by at most 2^(Exp (n) + max (Exp (x), Exp (n) - 1) + 1 - prec),
+     and c has an error of at most 1/2 ulp plus this amount; with the final
+     rounding, the error is at most 2^3 times the maximum of these bounds */
+  mpc_pool_fr_init2 (xx, 2 * mpfr_get_prec (x));
+  mpc_pool_fr_init2 (yy, 2 * mpfr_get_prec (y));
+  mpfr_sqr (xx, x, MPFR_RNDN);
+  mpfr_div_2ui (xx, xx, 1, MPFR_RNDN);
+  mpfr_neg (xx, xx, MPFR_RNDN);
+  mpfr_sqr (yy, y, MPFR_RNDN);
+  mpfr_div_2ui (yy, yy, 1, MPFR_RNDN);
+  tab [0] = x;
+  tab [1] = yy;
+  tab [2] = xx;
+  prec = MPC_PREC_RE (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (a, prec);
+      mpc_pool_fr_set_prec (c, prec);
+      mpc_pool_fr_set_prec (u, prec);
+      mpc_pool_fr_set_prec (w, prec);
+      mpc_pool_fr_set_prec (q, prec);
+      mpc_pool_fr_set_prec (t, prec);
+
+      mpfr_add_ui (u, x, 2, MPFR_RNDN);
+      mpfr_fmma (q, x, u, y, y, MPFR_RNDN);
+      if (mpfr_zero_p (q))
+        /* complete cancellation in q */
+        continue;
+      eq = mpfr_get_exp (q);
+      if (!mpfr_zero_p (x))
+        eq = MPC_MAX (eq, mpfr_get_exp (x) + mpfr_get_exp (u));
+      eq += 2 - (mpfr_exp_t) prec;
+      log1p_minus_quad (a, q);
+      mpfr_div_2ui (a, a, 1, MPFR_RNDN);
+      mpfr_fmma (w, x, x, y, y, MPFR_RNDN);
+      n4 [0] = w [0];
+      mpfr_set_exp (n4, mpfr_get_exp (n4) - 2); /* n/4, as a shallow copy */
+      mpfr_fmma (c, x, w, w, n4, MPFR_RNDN);
+      mpfr_sub (t, a, c, MPFR_RNDN);
+      err = MPC_MAX (mpfr_get_exp (a) + 2 - (mpfr_exp_t) prec,
+                     2 * MPC_MAX (mpfr_get_exp (q), eq) + eq + 1);
+      err = MPC_MAX (err, mpfr_get_exp (w) + 1 - (mpfr_exp_t) prec
+                     + (mpfr_zero_p (x) ? mpfr_get_exp (w) - 1
+                        : MPC_MAX (mpfr_get_exp (x), mpfr_get_exp (w) - 1)));
+      err = MPC_MAX (err, mpfr_get_exp (c) - 1 - (mpfr_exp_t) prec);
+      if (!mpfr_zero_p (t))
+        err = MPC_MAX (err, mpfr_get_exp (t) - 1 - (mpfr_exp_t) prec);
+      ok = mpc_round_sum (re, tab, 3, t, err + 3, MPC_RND_RE (rnd), &inex_re);
+    }
+
+  mpfr_set (mpc_realref (rop), re, MPFR_RNDN);
+  mpfr_set (mpc_imagref (rop), im, MPFR_RNDN);
+
+  mpc_pool_fr_clear (a);
+  mpc_pool_fr_clear (c);
+  mpc_pool_fr_clear (u);
+  mpc_pool_fr_clear (w);
+  mpc_pool_fr_clear (q);
+  mpc_pool_fr_clear (t);
+  mpc_pool_fr_clear (xx);
+  mpc_pool_fr_clear (yy);
+  mpc_pool_fr_clear (re);
+  mpc_pool_fr_clear (im);
+
+  return MPC_INEX (inex_re, inex_im);
+}
+
+/* Compute log1p (op) for op = x + i*y with x finite, x < -2 or x > -1/2,
+   and y regular or x < -2, in the extended exponent range; then
+      log1p (op) = 1/2 log1p (x (2+x) + y^2) + i atan2 (y, 1+x),
+   where 1+x need not be computed exactly, so that the working precision
+   does not depend on the exponents of x and y, see algorithms.tex. */
+static int
+log1p_regular (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpfr_t u, q, re, im;
+  mpfr_prec_t prec;
+  mpfr_exp_t err;
+  int ok, loops, inex_re, inex_im, zero_re = 0, zero_im = 0;
+
+  mpc_pool_fr_init2 (u, 2);
+  mpc_pool_fr_init2 (q, 2);
+  mpc_pool_fr_init2 (re, 2);
+  mpc_pool_fr_init2 (im, 2);
+
+  /* imaginary part atan2 (y, u) with u = o(1+x); the relative error
+     of u changes the argument by at most the same relative error,
+     so that the error is at most 4 ulps, see algorithms.tex */
+  prec = MPC_PREC_IM (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (u, prec);
+      mpc_pool_fr_set_prec (im, prec);
+
+      mpfr_add_ui (u, mpc_realref (op), 1, MPFR_RNDN);
+      mpfr_atan2 (im, mpc_imagref (op), u, MPFR_RNDN);
+      if (mpfr_zero_p (im))
+        /* y/u underflows in the extended exponent range, and so does
+           the imaginary part in any range; y is not zero here */
+        zero_im = ok = 1;
+      else
+        ok = mpfr_can_round (im, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                             MPC_PREC_IM (rop)
+                             + (MPC_RND_IM (rnd) == MPFR_RNDN));
+    }
+
+  /* real part 1/2 log1p (q) with q = o(x u + y^2) and u = o(2+x);
+     since 1+q = |1+op|^2 > 1/4, its error is at most
+     2^(max (Exp (x) + Exp (u), Exp (q)) - Exp (q) + 8) ulps, or
+     2^(... + 5) ulps when q is positive, see algorithms.tex;
+     FIXME: q may overflow while the real part could be represented. */
+  prec = MPC_PREC_RE (rop);
+  ok = 0;
+  for (loops = 1; !ok; loops++)
+    {
+      prec += (loops <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+      mpc_pool_fr_set_prec (u, prec);
+      mpc_pool_fr_set_prec (q, prec);
+      mpc_pool_fr_set_prec (re, prec);
+
+      mpfr_clear_underflow ();
+      mpfr_add_ui (u, mpc_realref (op), 2, MPFR_RNDN);
+      mpfr_fmma (q, mpc_realref (op), u, mpc_imagref (op), mpc_imagref (op),
+                 MPFR_RNDN);
+      mpfr_log1p (re, q, MPFR_RNDN);
+      mpfr_div_2ui (re, re, 1, MPFR_RNDN);
+      if (mpfr_zero_p (mpc_realref (op)) && mpfr_underflow_p ())
+        {
+          /* x = 0 and y^2/2 underflows in the extended exponent range,
+             and so does the real part in any range */
+          mpfr_set_zero (re, +1);
+          zero_re = ok = 1;
+          break;
+        }
+      if (mpfr_zero_p (re))
+        /* complete cancellation in q */
+        continue;
+      err = (mpfr_zero_p (mpc_realref (op)) ? mpfr_get_exp (q)
+             : MPC_MAX (mpfr_get_exp (mpc_realref (op)) + mpfr_get_exp (u),
+                        mpfr_get_exp (q)))
+            - mpfr_get_exp (q) + (mpfr_sgn (q) < 0 ? 8 : 5);
+      ok = err < (mpfr_exp_t) prec
+        && mpfr_can_round (re, prec - err, MPFR_RNDN, MPFR_RNDZ,
+                           MPC_PREC_RE (rop) + (MPC_RND_RE (rnd) == MPFR_RNDN));
+    }
+
+  inex_re = mpfr_set (mpc_realref (rop), re, MPC_RND_RE (rnd));
+  inex_im = mpfr_set (mpc_imagref (rop), im, MPC_RND_IM (rnd));
+  if (zero_re)
+    inex_re = mpc_fix_zero (mpc_realref (rop), MPC_RND_RE (rnd));
+  if (zero_im)
+    inex_im = mpc_fix_zero (mpc_imagref (rop), MPC_RND_IM (rnd));
+
+  mpc_pool_fr_clear (u);
+  mpc_pool_fr_clear (q);
+  mpc_pool_fr_clear (re);
+  mpc_pool_fr_clear (im);
+
+  return MPC_INEX (inex_re, inex_im);
+}
+
+int
+mpc_log1p (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpc_t w;
+  mpfr_exp_t saved_emin, saved_emax, ex, ey;
+  int inex, inex_re, inex_im;
+  int saved_underflow;
+
+  if (!mpfr_number_p (mpc_realref (op)) || !mpfr_number_p (mpc_imagref (op)))
+    /* infinities and NaNs: the logarithm of 1+op depends only on the
+       infinite or NaN parts of op, which are those of 1+op */
+    return mpc_log (rop, op, rnd);
+
+  if (mpfr_zero_p (mpc_imagref (op)) && mpfr_cmp_si (mpc_realref (op), -1) > 0)
+    /* special case when the input is real and larger than -1
+       log1p(x-i*0) = log1p(x) -i*0
+       log1p(x+i*0) = log1p(x) +i*0 */
+    {
+      inex_re = mpfr_log1p (mpc_realref (rop), mpc_realref (op),
+                            MPC_RND_RE (rnd));
+      inex_im = mpfr_set (mpc_imagref (rop), mpc_imagref (op),
+                          MPC_RND_IM (rnd));
+      return MPC_INEX (inex_re, inex_im);
+    }
+
+  if (mpfr_cmp_si (mpc_realref (op), -2) >= 0
+      && mpfr_cmp_si_2exp (mpc_realref (op), -1, -1) <= 0)
+    /* -2 <= x <= -1/2: 1+x is exact in the precision of x by Sterbenz's
+       lemma, and 1+op is far from 1, so take its logarithm directly;
+       this also handles the branch cut and 1+op = 0 */
+    {
+      mpc_pool_init3 (w, mpfr_get_prec (mpc_realref (op)),
+                      mpfr_get_prec (mpc_imagref (op)));
+      mpfr_add_ui (mpc_realref (w), mpc_realref (op), 1, MPFR_RNDN);
+      mpfr_set (mpc_imagref (w), mpc_imagref (op), MPFR_RNDN);
+      inex = mpc_log (rop, w, rnd);
+      mpc_pool_clear (w);
+      return inex;
+    }
+
+  /* from now on, x is a finite number with x < -2 or x > -1/2, so that
+     |1+op| > 1/2, and y is a regular number or x < -2 */
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+  saved_underflow = mpfr_underflow_p ();
+
+  /* |x|, |y| < 1/4, and the powers of x and y up to the fourth one do not
+     underflow in the extended exponent range */
+  ex = mpfr_zero_p (mpc_realref (op)) ? -2 : mpfr_get_exp (mpc_realref (op));
+  ey = mpfr_get_exp (mpc_imagref (op));
+  if (ex <= -2 && ey <= -2 && ex > mpfr_get_emin () / 8
+      && ey > mpfr_get_emin () / 8)
+    inex = log1p_small (rop, op, rnd);
+  else
+    inex = log1p_regular (rop, op, rnd);
+
+  /* restore the underflow flag from MPFR */
+  mpfr_clear_underflow ();
+  if (saved_underflow)
+    mpfr_set_underflow ();
+
+  /* restore the exponent range, and check the range of results */
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+  inex_re = mpfr_check_range (mpc_realref (rop), MPC_INEX_RE (inex),
+                              MPC_RND_RE (rnd));
+  inex_im = mpfr_check_range (mpc_imagref (rop), MPC_INEX_IM (inex),
+                              MPC_RND_IM (rnd));
+
+  return MPC_INEX (inex_re, inex_im);
+}
@@ -76,6 +76,10 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 #define MPC_PREC_IM(x) (mpfr_get_prec(mpc_imagref(x)))
 #define MPC_MAX_PREC(x) MPC_MAX(MPC_PREC_RE(x), MPC_PREC_IM(x))
 
+/* number of limbs of the significand of each part of an element of an
+   mpc_vec_t of precision prec */
+#define MPC_VEC_LIMBS(prec) (mpfr_custom_get_size (prec) / sizeof (mp_limb_t))
+
 #define INV_RND(r) \
    (((r) == MPFR_RNDU) ? MPFR_RNDD : (((r) == MPFR_RNDD) ? MPFR_RNDU : (r)))
 
@@ -148,6 +152,44 @@ do {                                                            \
 #define MUL_KARATSUBA_THRESHOLD 23
 #endif
 
+/* up to MPC_FMMA_THRESHOLD limbs, mpc_sqr, mpc_norm, mpc_fma and mpc_div
+   round the exact sums of exact products once; above, a single pass with
+   rounded products is tried first */
+#ifndef MPC_FMMA_THRESHOLD
+#define MPC_FMMA_THRESHOLD 32
+#endif
+#define MPC_FMMA_PREC ((mpfr_prec_t) MPC_FMMA_THRESHOLD * GMP_NUMB_BITS)
+
+/* from MPC_LOG_AGM_THRESHOLD limbs on, mpc_log first tries an
+   arithmetic-geometric mean instead of the real logarithm and arctangent;
+   the latter were still faster at 4*10^6 bits, see TODO */
+#ifndef MPC_LOG_AGM_THRESHOLD
+#define MPC_LOG_AGM_THRESHOLD 1000000
+#endif
+#define MPC_LOG_AGM_PREC ((mpfr_prec_t) MPC_LOG_AGM_THRESHOLD * GMP_NUMB_BITS)
+
+/* mpc_sum_mt and mpc_dot_mt give each thread at least MPC_MT_CHUNK_MIN
+   terms */
+#ifndef MPC_MT_CHUNK_MIN
+#define MPC_MT_CHUNK_MIN 1024
+#endif
+
+/* an mpc_acc_t keeps at most MPC_ACC_SIZE terms per part, including the
+   sum of the terms already collected */
+#ifndef MPC_ACC_SIZE
+#define MPC_ACC_SIZE 256
+#endif
+
+/* operands of at most MPC_SMALL_LIMBS limbs use the exact kernels of
+   fmma_small.c, which need accumulators of MPC_SMALL_ACC_LIMBS limbs */
+#define MPC_SMALL_LIMBS 2
+#define MPC_SMALL_PREC (MPC_SMALL_LIMBS * GMP_NUMB_BITS)
+#define MPC_SMALL_ACC_LIMBS 10
+
+/* operands and results of at most MPC_FP_PREC bits are first tried with
+   the double-double arithmetic of sqrt_fp.c */
+#define MPC_FP_PREC 53
+
 
 /*
  * Define internal functions
@@ -161,7 +203,15 @@ extern "C" {
 __MPC_DECLSPEC int  mpc_mul_naive (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_mul_karatsuba (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_fma_naive (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_fmma_small (mpfr_ptr, mp_limb_t *, mpfr_srcptr, mpfr_srcptr, mpfr_srcptr, mpfr_srcptr, int, mpfr_srcptr, mpfr_rnd_t);
+__MPC_DECLSPEC int  mpc_mul_small (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, int *);
+__MPC_DECLSPEC int  mpc_mul2_small (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, int *);
+__MPC_DECLSPEC int  mpc_div_small (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, int *);
+__MPC_DECLSPEC int  mpc_div_fmma (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, int *);
+__MPC_DECLSPEC int  mpc_sqrt_fp (mpc_ptr, mpc_srcptr, mpc_rnd_t, int *);
+__MPC_DECLSPEC int  mpc_sqrt_native (double *, double *, double, double, int);
 __MPC_DECLSPEC int  mpc_pow_usi (mpc_ptr, mpc_srcptr, unsigned long, int, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_pow_usz (mpc_ptr, mpc_srcptr, mpz_srcptr, int, mpc_rnd_t);
 __MPC_DECLSPEC char* mpc_alloc_str (size_t);
 __MPC_DECLSPEC char* mpc_realloc_str (char*, size_t, size_t);
 __MPC_DECLSPEC void mpc_free_str (char*);
@@ -169,6 +219,24 @@ __MPC_DECLSPEC mpfr_prec_t mpc_ceil_log2 (mpfr_prec_t);
 __MPC_DECLSPEC int set_pi_over_2 (mpfr_ptr, int, mpfr_rnd_t);
 __MPC_DECLSPEC int mpc_fix_inf (mpfr_t x, mpfr_rnd_t rnd);
 __MPC_DECLSPEC int mpc_fix_zero (mpfr_t x, mpfr_rnd_t rnd);
+__MPC_DECLSPEC int mpc_round_sum (mpfr_ptr, mpfr_srcptr *, unsigned long, mpfr_srcptr, mpfr_exp_t, mpfr_rnd_t, int *);
+__MPC_DECLSPEC int mpc_exp_regular (mpc_ptr, mpc_srcptr, mpc_rnd_t, mpfr_ptr, mpfr_ptr, mpfr_ptr);
+__MPC_DECLSPEC int mpc_sin_cos_regular (mpc_ptr, mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_rnd_t, mpfr_t *);
+__MPC_DECLSPEC int mpc_asin_acos_regular (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, int);
+__MPC_DECLSPEC mpfr_prec_t mpc_agm1_approx (mpc_ptr, mpc_srcptr);
+__MPC_DECLSPEC int mpc_log_agm (mpc_ptr, mpc_srcptr, mpc_rnd_t, int *);
+__MPC_DECLSPEC void mpc_pool_fr_init2 (mpfr_ptr, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_pool_fr_set_prec (mpfr_ptr, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_pool_fr_clear (mpfr_ptr);
+__MPC_DECLSPEC void mpc_pool_init2 (mpc_ptr, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_pool_init3 (mpc_ptr, mpfr_prec_t, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_pool_set_prec (mpc_ptr, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_pool_clear (mpc_ptr);
+__MPC_DECLSPEC int mpc_pool_fr_prec_round (mpfr_ptr, mpfr_prec_t, mpfr_rnd_t);
+__MPC_DECLSPEC void* mpc_pool_alloc (size_t);
+__MPC_DECLSPEC void mpc_pool_free (void *, size_t);
+__MPC_DECLSPEC void* mpc_workspace_enter (mpc_workspace_ptr);
+__MPC_DECLSPEC void mpc_workspace_leave (void *);
 
 #if defined (__cplusplus)
 }
@@ -108,6 +108,48 @@ typedef __mpc_struct mpc_t[1];
 typedef __mpc_struct *mpc_ptr;
 typedef const __mpc_struct *mpc_srcptr;
 
+/* A workspace holds the memory for the temporary variables of the _ws
+   functions; its contents are private to the library. */
+typedef struct {
+  void *pool;
+}
+__mpc_workspace_struct;
+
+typedef __mpc_workspace_struct mpc_workspace_t[1];
+typedef __mpc_workspace_struct *mpc_workspace_ptr;
+
+/* An accumulator holds the exact sum of the complex numbers added to it:
+   for each part, the first entry of re (respectively im) is the exact sum
+   of the terms already collected, and the next n-1 entries are pending
+   terms; its contents are private to the library. */
+typedef struct {
+  __mpfr_struct *re, *im;
+  mpfr_ptr *ptr;
+  unsigned long n;
+  int empty;
+}
+__mpc_acc_struct;
+
+typedef __mpc_acc_struct mpc_acc_t[1];
+typedef __mpc_acc_struct *mpc_acc_ptr;
+
+/* A vector of size complex numbers of precision prec, in structure of
+   arrays form: the significands of the real parts are stored one after the
+   other in re_d, those of the imaginary parts in im_d, and the kinds (as
+   returned by mpfr_custom_get_kind) and exponents in dense arrays. */
+typedef struct {
+  unsigned long size;
+  mpfr_prec_t prec;
+  mp_limb_t *re_d, *im_d;
+  mpfr_exp_t *re_exp, *im_exp;
+  signed char *re_kind, *im_kind;
+}
+__mpc_vec_struct;
+
+typedef __mpc_vec_struct mpc_vec_t[1];
+typedef __mpc_vec_struct *mpc_vec_ptr;
+typedef const __mpc_vec_struct *mpc_vec_srcptr;
+
 /* Support for WINDOWS DLL, see
    http://lists.gforge.inria.fr/pipermail/mpc-discuss/2011-November/000990.html;
    when building the DLL, export symbols, otherwise behave as GMP           */
@@ -144,10 +186,12 @@ __MPC_DECLSPEC int  mpc_pow_d     (mpc_ptr, mpc_srcptr, double, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_pow_si    (mpc_ptr, mpc_srcptr, long, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_pow_ui    (mpc_ptr, mpc_srcptr, unsigned long, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_pow_z     (mpc_ptr, mpc_srcptr, mpz_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_pow_table (mpc_ptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_div_fr    (mpc_ptr, mpc_srcptr, mpfr_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_fr_div    (mpc_ptr, mpfr_srcptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_div_ui    (mpc_ptr, mpc_srcptr, unsigned long int, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_ui_div    (mpc_ptr, unsigned long int, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_inv       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_div_2ui   (mpc_ptr, mpc_srcptr, unsigned long int, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_mul_2ui   (mpc_ptr, mpc_srcptr, unsigned long int, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_div_2si   (mpc_ptr, mpc_srcptr, long int, mpc_rnd_t);
@@ -156,6 +200,15 @@ __MPC_DECLSPEC int  mpc_conj      (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_neg       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_sum (mpc_ptr, const mpc_ptr *, unsigned long, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_dot (mpc_ptr, const mpc_ptr *, const mpc_ptr *, unsigned long, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_dot_strided (mpc_ptr, mpc_srcptr, long, mpc_srcptr, long, unsigned long, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_sum_mt (mpc_ptr, const mpc_ptr *, unsigned long, mpc_rnd_t, unsigned int);
+__MPC_DECLSPEC int  mpc_dot_mt (mpc_ptr, const mpc_ptr *, const mpc_ptr *, unsigned long, mpc_rnd_t, unsigned int);
+__MPC_DECLSPEC void mpc_acc_init (mpc_acc_ptr);
+__MPC_DECLSPEC void mpc_acc_clear (mpc_acc_ptr);
+__MPC_DECLSPEC void mpc_acc_add (mpc_acc_ptr, mpc_srcptr);
+__MPC_DECLSPEC void mpc_acc_add_mul (mpc_acc_ptr, mpc_srcptr, mpc_srcptr);
+__MPC_DECLSPEC void mpc_acc_merge (mpc_acc_ptr, mpc_acc_ptr);
+__MPC_DECLSPEC int  mpc_acc_get (mpc_ptr, mpc_acc_ptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_norm      (mpfr_ptr, mpc_srcptr, mpfr_rnd_t);
 __MPC_DECLSPEC int  mpc_abs       (mpfr_ptr, mpc_srcptr, mpfr_rnd_t);
 __MPC_DECLSPEC int  mpc_sqrt      (mpc_ptr, mpc_srcptr, mpc_rnd_t);
@@ -178,6 +231,9 @@ __MPC_DECLSPEC int  mpc_set_z     (mpc_ptr, mpz_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_set_z_z   (mpc_ptr, mpz_srcptr, mpz_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC void mpc_swap      (mpc_ptr, mpc_ptr);
 __MPC_DECLSPEC int  mpc_fma       (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_fms       (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_fmma      (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_fmms      (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
 
 __MPC_DECLSPEC void mpc_set_nan   (mpc_ptr);
 
@@ -189,8 +245,10 @@ __MPC_DECLSPEC int  mpc_cmp         (mpc_srcptr, mpc_srcptr);
 __MPC_DECLSPEC int  mpc_cmp_si_si   (mpc_srcptr, long int, long int);
 __MPC_DECLSPEC int  mpc_cmp_abs     (mpc_srcptr, mpc_srcptr);
 __MPC_DECLSPEC int  mpc_exp         (mpc_ptr, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_expm1       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_log         (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_log10       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_log1p       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_sin         (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_cos         (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_sin_cos     (mpc_ptr, mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_rnd_t);
@@ -205,14 +263,45 @@ __MPC_DECLSPEC int  mpc_asinh       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_acosh       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_atanh       (mpc_ptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_rootofunity (mpc_ptr, unsigned long int, unsigned long int, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_agm         (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC void mpc_clear       (mpc_ptr);
 __MPC_DECLSPEC int  mpc_urandom     (mpc_ptr, gmp_randstate_t);
 __MPC_DECLSPEC void mpc_init2       (mpc_ptr, mpfr_prec_t);
 __MPC_DECLSPEC void mpc_init3       (mpc_ptr, mpfr_prec_t, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_init2_single (mpc_ptr, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_clear_single (mpc_ptr);
 __MPC_DECLSPEC mpfr_prec_t mpc_get_prec (mpc_srcptr x);
 __MPC_DECLSPEC void mpc_get_prec2   (mpfr_prec_t *pr, mpfr_prec_t *pi, mpc_srcptr x);
 __MPC_DECLSPEC void mpc_set_prec    (mpc_ptr, mpfr_prec_t);
 __MPC_DECLSPEC const char * mpc_get_version (void);
+__MPC_DECLSPEC void mpc_get_pool_stats (unsigned long *, unsigned long *);
+__MPC_DECLSPEC void mpc_reset_pool_stats (void);
+__MPC_DECLSPEC void mpc_free_pool   (void);
+__MPC_DECLSPEC void mpc_workspace_init  (mpc_workspace_ptr, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_workspace_clear (mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_mul_ws      (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_div_ws      (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_exp_ws      (mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_sin_cos_ws  (mpc_ptr, mpc_ptr, mpc_srcptr, mpc_rnd_t, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_pow_ws      (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_pow_ui_ws   (mpc_ptr, mpc_srcptr, unsigned long, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_pow_si_ws   (mpc_ptr, mpc_srcptr, long, mpc_rnd_t, mpc_workspace_ptr);
+__MPC_DECLSPEC int  mpc_dot_ws      (mpc_ptr, const mpc_ptr *, const mpc_ptr *, unsigned long, mpc_rnd_t, mpc_workspace_ptr);
+
+__MPC_DECLSPEC void mpc_vec_add     (mpc_ptr, mpc_srcptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_sub     (mpc_ptr, mpc_srcptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_mul     (mpc_ptr, mpc_srcptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_sqr     (mpc_ptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_fma     (mpc_ptr, mpc_srcptr, mpc_srcptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_div     (mpc_ptr, mpc_srcptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_exp     (mpc_ptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_sin_cos (mpc_ptr, mpc_ptr, mpc_srcptr, unsigned long, int *, mpc_rnd_t, mpc_rnd_t);
+__MPC_DECLSPEC void mpc_vec_init2   (mpc_vec_ptr, unsigned long, mpfr_prec_t);
+__MPC_DECLSPEC void mpc_vec_clear   (mpc_vec_ptr);
+__MPC_DECLSPEC void mpc_vec_view    (mpc_ptr, mpc_vec_srcptr, unsigned long, unsigned long);
+__MPC_DECLSPEC void mpc_vec_store   (mpc_vec_ptr, unsigned long, mpc_srcptr, unsigned long);
+__MPC_DECLSPEC int  mpc_vec_get     (mpc_ptr, mpc_vec_srcptr, unsigned long, mpc_rnd_t);
+__MPC_DECLSPEC int  mpc_vec_set     (mpc_vec_ptr, unsigned long, mpc_srcptr, mpc_rnd_t);
 
 __MPC_DECLSPEC int  mpc_strtoc      (mpc_ptr, const char *, char **, int, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_set_str     (mpc_ptr, const char *, int, mpc_rnd_t);
@@ -232,6 +321,74 @@ __MPC_DECLSPEC int  mpc_set_dc      (mpc_ptr, double _Complex, mpc_rnd_t);
 __MPC_DECLSPEC int  mpc_set_ldc     (mpc_ptr, long double _Complex, mpc_rnd_t);
 __MPC_DECLSPEC double _Complex mpc_get_dc (mpc_srcptr, mpc_rnd_t);
 __MPC_DECLSPEC long double _Complex mpc_get_ldc (mpc_srcptr, mpc_rnd_t);
+
+/* correctly rounded replacements of the functions of <complex.h> */
+__MPC_DECLSPEC float _Complex mpc_cr_csqrtf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_cexpf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_clogf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_cpowf (float _Complex, float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_csinf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_ccosf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_ctanf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_csinhf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_ccoshf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_ctanhf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_casinf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_cacosf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_catanf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_casinhf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_cacoshf (float _Complex);
+__MPC_DECLSPEC float _Complex mpc_cr_catanhf (float _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_csqrt (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_cexp (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_clog (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_cpow (double _Complex, double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_csin (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_ccos (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_ctan (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_csinh (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_ccosh (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_ctanh (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_casin (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_cacos (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_catan (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_casinh (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_cacosh (double _Complex);
+__MPC_DECLSPEC double _Complex mpc_cr_catanh (double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_csqrtl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_cexpl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_clogl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_cpowl (long double _Complex, long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_csinl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_ccosl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_ctanl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_csinhl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_ccoshl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_ctanhl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_casinl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_cacosl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_catanl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_casinhl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_cacoshl (long double _Complex);
+__MPC_DECLSPEC long double _Complex mpc_cr_catanhl (long double _Complex);
+#ifdef MPFR_WANT_FLOAT128
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_csqrtf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_cexpf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_clogf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_cpowf128 (_Float128 _Complex, _Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_csinf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_ccosf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_ctanf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_csinhf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_ccoshf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_ctanhf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_casinf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_cacosf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_catanf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_casinhf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_cacoshf128 (_Float128 _Complex);
+__MPC_DECLSPEC _Float128 _Complex mpc_cr_catanhf128 (_Float128 _Complex);
+#endif
 #endif
 
 #ifdef _GMP_H_HAVE_FILE
@@ -267,4 +424,17 @@ __MPC_DECLSPEC size_t mpc_out_str (FILE *, int, size_t, mpc_srcptr, mpc_rnd_t);
     return MPC_INEX (_inex_re, _inex_im);                               \
   }
 
+/*
+   Declare and initialize a local variable z of precision p for both parts,
+   set to NaN, whose significands are stored in the variable itself, like
+   MPFR_DECL_INIT; p must be a constant expression unless variable length
+   arrays are supported. Such a variable can be used with all functions, but
+   must not be passed to mpc_clear, mpc_set_prec or mpc_swap.
+*/
+#define MPC_DECL_INIT(z, p)                                             \
+  MPFR_DECL_INIT (__gmpc_local_re_ ## z, p);                            \
+  MPFR_DECL_INIT (__gmpc_local_im_ ## z, p);                            \
+  mpc_t z = {{ { __gmpc_local_re_ ## z [0] },                           \
+               { __gmpc_local_im_ ## z [0] } }}
+
 #endif /* ifndef __MPC_H */
@@ -0,0 +1,337 @@
+/* mpc_pool -- Pool of limb buffers for temporary variables.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* The temporary variables of the Ziv loops take their significands from
+   a per-thread pool instead of calling the GMP memory functions each time
+   their precision changes. A buffer of size class c holds 2^c limbs; the
+   class of a variable is recovered from its precision, so that nothing
+   needs to be stored besides the mpfr structure itself.
+   Released buffers of class less than MPC_POOL_CLASSES are kept in a stack
+   of depth MPC_POOL_DEPTH for their class, as long as the pool holds at most
+   MPC_POOL_MAX_LIMBS limbs in total; larger buffers, and buffers released
+   when the stack of their class or the pool is full, are given back to GMP.
+   This bounds the memory that a thread keeps until mpc_free_pool, and that
+   is lost if the thread terminates without calling it.
+   Variables obtained in this way use the MPFR custom interface, so they
+   must not be passed to mpfr_set_prec, mpfr_prec_round or mpfr_clear, and
+   must not be swapped with variables allocated by mpfr_init2. */
+
+#define MPC_POOL_CLASSES 16 /* keep buffers of up to 32768 limbs */
+#define MPC_POOL_DEPTH   16
+#define MPC_POOL_WARM    8  /* buffers allocated per class by a workspace */
+#define MPC_POOL_MAX_LIMBS 65536 /* 512 KB with 64-bit limbs */
+
+typedef struct {
+  mp_limb_t *stack [MPC_POOL_CLASSES][MPC_POOL_DEPTH];
+  int size [MPC_POOL_CLASSES];
+  size_t limbs; /* total number of limbs of the buffers in the stacks */
+} mpc_pool_struct;
+
+#ifdef MPC_THREAD_ATTR
+/* Without thread-local storage, the pool is disabled and every buffer is
+   obtained from GMP. Buffers are taken from the workspace installed by
+   mpc_workspace_enter if any, and from the default pool otherwise. */
+static MPC_THREAD_ATTR mpc_pool_struct mpc_pool;
+static MPC_THREAD_ATTR mpc_pool_struct *mpc_pool_current;
+static MPC_THREAD_ATTR unsigned long mpc_pool_hits, mpc_pool_misses;
+
+#define MPC_POOL (mpc_pool_current != NULL ? mpc_pool_current : &mpc_pool)
+#endif
+
+/* return the size class of a buffer holding n limbs */
+static int
+pool_class_limbs (mp_size_t n)
+{
+  int c = 0;
+
+  while (((mp_size_t) 1 << c) < n)
+    c++;
+  return c;
+}
+
+/* return the size class of a buffer holding p bits */
+static int
+pool_class (mpfr_prec_t p)
+{
+  return pool_class_limbs ((mp_size_t) ((p - 1) / BITS_PER_MP_LIMB + 1));
+}
+
+static mp_limb_t *
+pool_alloc (int c)
+{
+  void * (*allocfunc) (size_t);
+
+  mp_get_memory_functions (&allocfunc, NULL, NULL);
+  return (mp_limb_t *) (*allocfunc) (((size_t) 1 << c) * sizeof (mp_limb_t));
+}
+
+static void
+pool_free (mp_limb_t *m, int c)
+{
+  void (*freefunc) (void *, size_t);
+
+  mp_get_memory_functions (NULL, NULL, &freefunc);
+  (*freefunc) (m, ((size_t) 1 << c) * sizeof (mp_limb_t));
+}
+
+static mp_limb_t *
+pool_get (int c)
+{
+#ifdef MPC_THREAD_ATTR
+  mpc_pool_struct *pool = MPC_POOL;
+
+  if (c < MPC_POOL_CLASSES && pool->size [c] > 0)
+    {
+      mpc_pool_hits++;
+      pool->limbs -= (size_t) 1 << c;
+      return pool->stack [c][--pool->size [c]];
+    }
+  mpc_pool_misses++;
+#endif
+  return pool_alloc (c);
+}
+
+static void
+pool_put (mp_limb_t *m, int c)
+{
+#ifdef MPC_THREAD_ATTR
+  mpc_pool_struct *pool = MPC_POOL;
+
+  if (c < MPC_POOL_CLASSES && pool->size [c] < MPC_POOL_DEPTH
+      && pool->limbs + ((size_t) 1 << c) <= MPC_POOL_MAX_LIMBS)
+    {
+      pool->stack [c][pool->size [c]++] = m;
+      pool->limbs += (size_t) 1 << c;
+      return;
+    }
+#endif
+  pool_free (m, c);
+}
+
+static void
+pool_empty (mpc_pool_struct *pool)
+{
+  int c;
+
+  for (c = 0; c < MPC_POOL_CLASSES; c++)
+    while (pool->size [c] > 0)
+      pool_free (pool->stack [c][--pool->size [c]], c);
+  pool->limbs = 0;
+}
+
+/* return a block of at least n bytes, to be given back by mpc_pool_free */
+void *
+mpc_pool_alloc (size_t n)
+{
+  return pool_get (pool_class_limbs ((mp_size_t)
+                   ((n + sizeof (mp_limb_t) - 1) / sizeof (mp_limb_t))));
+}
+
+void
+mpc_pool_free (void *m, size_t n)
+{
+  pool_put ((mp_limb_t *) m, pool_class_limbs ((mp_size_t)
+            ((n + sizeof (mp_limb_t) - 1) / sizeof (mp_limb_t))));
+}
+
+/* like mpfr_init2 */
+void
+mpc_pool_fr_init2 (mpfr_ptr x, mpfr_prec_t p)
+{
+  mp_limb_t *m = pool_get (pool_class (p));
+
+  mpfr_custom_init (m, p);
+  mpfr_custom_init_set (x, MPFR_NAN_KIND, 0, p, m);
+}
+
+/* like mpfr_set_prec: the value of x is lost and x is set to NaN */
+void
+mpc_pool_fr_set_prec (mpfr_ptr x, mpfr_prec_t p)
+{
+  mp_limb_t *m = (mp_limb_t *) mpfr_custom_get_significand (x);
+  int c = pool_class (p), c_old = pool_class (mpfr_get_prec (x));
+
+  if (c != c_old)
+    {
+      pool_put (m, c_old);
+      m = pool_get (c);
+    }
+  mpfr_custom_init (m, p);
+  mpfr_custom_init_set (x, MPFR_NAN_KIND, 0, p, m);
+}
+
+/* like mpfr_clear */
+void
+mpc_pool_fr_clear (mpfr_ptr x)
+{
+  pool_put ((mp_limb_t *) mpfr_custom_get_significand (x),
+            pool_class (mpfr_get_prec (x)));
+}
+
+void
+mpc_pool_init2 (mpc_ptr z, mpfr_prec_t p)
+{
+  mpc_pool_fr_init2 (mpc_realref (z), p);
+  mpc_pool_fr_init2 (mpc_imagref (z), p);
+}
+
+void
+mpc_pool_init3 (mpc_ptr z, mpfr_prec_t pr, mpfr_prec_t pi)
+{
+  mpc_pool_fr_init2 (mpc_realref (z), pr);
+  mpc_pool_fr_init2 (mpc_imagref (z), pi);
+}
+
+void
+mpc_pool_set_prec (mpc_ptr z, mpfr_prec_t p)
+{
+  mpc_pool_fr_set_prec (mpc_realref (z), p);
+  mpc_pool_fr_set_prec (mpc_imagref (z), p);
+}
+
+void
+mpc_pool_clear (mpc_ptr z)
+{
+  mpc_pool_fr_clear (mpc_realref (z));
+  mpc_pool_fr_clear (mpc_imagref (z));
+}
+
+/* like mpfr_prec_round, for a variable obtained from the pool */
+int
+mpc_pool_fr_prec_round (mpfr_ptr x, mpfr_prec_t p, mpfr_rnd_t rnd)
+{
+  mpfr_t y;
+  int inex;
+
+  mpc_pool_fr_init2 (y, p);
+  inex = mpfr_set (y, x, rnd);
+  mpc_pool_fr_clear (x);
+  x [0] = y [0];
+  return inex;
+}
+
+void
+mpc_get_pool_stats (unsigned long *hits, unsigned long *misses)
+{
+#ifdef MPC_THREAD_ATTR
+  if (hits != NULL)
+    *hits = mpc_pool_hits;
+  if (misses != NULL)
+    *misses = mpc_pool_misses;
+#else
+  if (hits != NULL)
+    *hits = 0;
+  if (misses != NULL)
+    *misses = 0;
+#endif
+}
+
+void
+mpc_reset_pool_stats (void)
+{
+#ifdef MPC_THREAD_ATTR
+  mpc_pool_hits = 0;
+  mpc_pool_misses = 0;
+#endif
+}
+
+/* give all buffers kept in the pool of the current thread back to GMP */
+void
+mpc_free_pool (void)
+{
+#ifdef MPC_THREAD_ATTR
+  pool_empty (&mpc_pool);
+#endif
+}
+
+/* allocate up to MPC_POOL_WARM buffers of class c in pool */
+static void
+pool_warm (mpc_pool_struct *pool, int c)
+{
+  int k;
+
+  for (k = 0; k < MPC_POOL_WARM
+              && pool->limbs + ((size_t) 1 << c) <= MPC_POOL_MAX_LIMBS; k++)
+    {
+      pool->stack [c][pool->size [c]++] = pool_alloc (c);
+      pool->limbs += (size_t) 1 << c;
+    }
+}
+
+/* Create a pool of its own for ws, with buffers for the working precisions
+   of functions called with precision around prec. */
+void
+mpc_workspace_init (mpc_workspace_ptr ws, mpfr_prec_t prec)
+{
+  void * (*allocfunc) (size_t);
+  mpc_pool_struct *pool;
+  int c, c_max;
+
+  mp_get_memory_functions (&allocfunc, NULL, NULL);
+  pool = (mpc_pool_struct *) (*allocfunc) (sizeof (mpc_pool_struct));
+  for (c = 0; c < MPC_POOL_CLASSES; c++)
+    pool->size [c] = 0;
+  pool->limbs = 0;
+  ws->pool = pool;
+
+  /* the Ziv loops start with 2-bit variables, and work at up to about
+     twice the target precision plus some guard bits; the buffers of the
+     largest classes are only allocated within the limit of the pool */
+  if (pool_class (prec) > 0)
+    pool_warm (pool, 0);
+  c_max = pool_class (2 * prec + 2 * BITS_PER_MP_LIMB);
+  for (c = pool_class (prec); c <= c_max && c < MPC_POOL_CLASSES; c++)
+    pool_warm (pool, c);
+}
+
+void
+mpc_workspace_clear (mpc_workspace_ptr ws)
+{
+  void (*freefunc) (void *, size_t);
+
+  pool_empty ((mpc_pool_struct *) ws->pool);
+  mp_get_memory_functions (NULL, NULL, &freefunc);
+  (*freefunc) (ws->pool, sizeof (mpc_pool_struct));
+}
+
+/* Make the buffers of ws the ones used by the current thread, and return
+   the previous state to be passed to mpc_workspace_leave. */
+void *
+mpc_workspace_enter (mpc_workspace_ptr ws)
+{
+#ifdef MPC_THREAD_ATTR
+  mpc_pool_struct *old = mpc_pool_current;
+
+  mpc_pool_current = (mpc_pool_struct *) ws->pool;
+  return old;
+#else
+  return NULL;
+#endif
+}
+
+void
+mpc_workspace_leave (void *old)
+{
+#ifdef MPC_THREAD_ATTR
+  mpc_pool_current = (mpc_pool_struct *) old;
+#endif
+}
@@ -476,12 +476,75 @@ is_odd (mpfr_srcptr y, mpfr_exp_t k)
   return 1;
 }
 
+/* Set u to an approximation of x^y for y real, finite and non-zero, and x
+   finite and not a positive real number, computed in polar form as
+   exp(y*log|x|) * (cos(y*arg(x)) + i*sin(y*arg(x))) with real functions
+   at the precision p of u and t, where t is a temporary variable.
+   Return 0 if the result overflows or underflows, or if a part of u is
+   zero, in which case the error analysis does not apply; otherwise, set
+   kr and ki such that the errors on the real and imaginary parts of u
+   are bounded by 2^kr ulp(Re(u)) and 2^ki ulp(Im(u)), see algorithms.tex.
+   The computation must be done in the extended exponent range. */
+static int
+pow_polar (mpc_ptr u, mpfr_exp_t *kr, mpfr_exp_t *ki, mpc_srcptr x,
+           mpfr_srcptr y, mpc_ptr t)
+{
+  mpfr_ptr r = mpc_realref (t), theta = mpc_imagref (t);
+  mpfr_prec_t p = mpfr_get_prec (r);
+  mpfr_exp_t ky = mpfr_get_exp (y), er, et, em, ec;
+
+  /* |r - y*log|x|| <= 2^(er-p) */
+  mpfr_hypot (r, mpc_realref (x), mpc_imagref (x), MPFR_RNDN);
+  mpfr_log (r, r, MPFR_RNDN);
+  er = ky + 1 + (mpfr_zero_p (r) ? 1 : MPC_MAX (mpfr_get_exp (r), 1));
+  mpfr_mul (r, r, y, MPFR_RNDN);
+  if (!mpfr_zero_p (r))
+    er = MPC_MAX (er, mpfr_get_exp (r) - 1);
+  er++;
+
+  /* |theta - y*arg(x)| <= 2^(et-p) */
+  mpfr_atan2 (theta, mpc_imagref (x), mpc_realref (x), MPFR_RNDN);
+  mpfr_mul (theta, theta, y, MPFR_RNDN);
+  et = ky + 1;
+  if (!mpfr_zero_p (theta))
+    et = MPC_MAX (et, mpfr_get_exp (theta) - 1);
+  et++;
+
+  if (er + 3 >= p)
+    {
+      /* the error analysis of the exponential needs |r - y*log|x|| <= 1/2
+         and a relative error of exp(r) of at most 1/2; ask for more
+         precision */
+      *kr = *ki = p;
+      return 1;
+    }
+
+  mpfr_sin_cos (mpc_imagref (u), mpc_realref (u), theta, MPFR_RNDN);
+  mpfr_exp (r, r, MPFR_RNDN);
+  if (!mpfr_regular_p (r))
+    return 0;
+  mpfr_mul (mpc_realref (u), mpc_realref (u), r, MPFR_RNDN);
+  mpfr_mul (mpc_imagref (u), mpc_imagref (u), r, MPFR_RNDN);
+  if (!mpfr_regular_p (mpc_realref (u)) || !mpfr_regular_p (mpc_imagref (u)))
+    return 0;
+
+  /* the relative error of r = exp(r) is at most 2^(em-p), and the
+     absolute errors of the cosine and the sine are at most 2^(ec-p) */
+  em = MPC_MAX (er + 1, 1) + 1;
+  ec = MPC_MAX (et, 0) + 1;
+  *kr = mpfr_get_exp (r) - mpfr_get_exp (mpc_realref (u))
+    + MPC_MAX (ec, em + 1) + 2;
+  *ki = mpfr_get_exp (r) - mpfr_get_exp (mpc_imagref (u))
+    + MPC_MAX (ec, em + 1) + 2;
+  return 1;
+}
+
 /* Put in z the value of x^y, rounded according to 'rnd'.
    Return the inexact flag in [0, 10]. */
 int
 mpc_pow (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
 {
-  int ret = -2, loop, x_real, x_imag, y_real, z_real = 0, z_imag = 0;
+  int ret = -2, loop, x_real, x_imag, y_real, z_real = 0, z_imag = 0, polar;
   mpc_t t, u;
   mpfr_prec_t p, pr, pi, maxprec;
   int saved_underflow, saved_overflow;
@@ -658,18 +721,51 @@ mpc_pow (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
               Ziv's strategy; probably wrong now since q is not computed */
   if (p < 64)
     p = 64;
-  mpc_init2 (u, p);
-  mpc_init2 (t, p);
+  /* for y real, the errors of pow_polar are of about 2^(EXP(y)+8) ulps */
+  polar = y_real;
+  if (polar && p < MPC_MAX_PREC (z) + mpfr_get_exp (mpc_realref (y)) + 20)
+    p = MPC_MAX_PREC (z) + mpfr_get_exp (mpc_realref (y)) + 20;
+  mpc_pool_init2 (u, p);
+  mpc_pool_init2 (t, p);
   pr += MPC_RND_RE(rnd) == MPFR_RNDN;
   pi += MPC_RND_IM(rnd) == MPFR_RNDN;
   maxprec = MPC_MAX_PREC (z);
   x_imag = mpfr_zero_p (mpc_realref(x));
+  /* for y real, compute x^y in polar form with real functions, and use
+     the complex logarithm and exponential only if this fails */
   for (loop = 0;; loop++)
     {
       int ret_exp;
       mpfr_exp_t dr, di;
       mpfr_prec_t q;
 
+      if (polar)
+        {
+          mpfr_exp_t kr, ki;
+
+          if (pow_polar (u, &kr, &ki, x, mpc_realref (y), t))
+            {
+              /* a part which is known to be zero needs no approximation */
+              if (z_imag)
+                kr = 0;
+              if (z_real)
+                ki = 0;
+              if (p < MPC_MAX_PREC (z) + MPC_MAX (kr, ki) + 8)
+                {
+                  p = MPC_MAX_PREC (z) + MPC_MAX (kr, ki) + 16;
+                  goto try_again;
+                }
+              if ((z_imag || mpfr_can_round (mpc_realref (u), p - kr,
+                                             MPFR_RNDN, MPFR_RNDZ, pr))
+                  && (z_real || mpfr_can_round (mpc_imagref (u), p - ki,
+                                                MPFR_RNDN, MPFR_RNDZ, pi)))
+                break;
+              dr = di = 0;
+              goto failed;
+            }
+          polar = 0;
+        }
+
       mpc_log (t, x, MPC_RNDNN);
       mpc_mul (t, t, y, MPC_RNDNN);
 
@@ -737,6 +833,7 @@ mpc_pow (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
           (z_real || (p > q + 3 + di && mpfr_can_round (mpc_imagref(u), p - q - 3 - di, MPFR_RNDN, MPFR_RNDZ, pi))))
         break;
 
+    failed:
       /* if Re(u) is not known to be zero, assume it is a normal number, i.e.,
          neither zero, Inf or NaN, otherwise we might enter an infinite loop */
       MPC_ASSERT (z_imag || mpfr_number_p (mpc_realref(u)));
@@ -759,8 +856,8 @@ mpc_pow (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
       else
         p += p / 2;
     try_again:
-      mpc_set_prec (t, p);
-      mpc_set_prec (u, p);
+      mpc_pool_set_prec (t, p);
+      mpc_pool_set_prec (u, p);
     }
 
   if (z_real)
@@ -841,8 +938,8 @@ mpc_pow (mpc_ptr z, mpc_srcptr x, mpc_srcptr y, mpc_rnd_t rnd)
   else
     ret = mpc_set (z, u, rnd);
  exact:
-  mpc_clear (t);
-  mpc_clear (u);
+  mpc_pool_clear (t);
+  mpc_pool_clear (u);
 
   /* restore underflow and overflow flags from MPFR */
   if (saved_underflow)
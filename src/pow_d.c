@@ -1,6 +1,6 @@
 /* mpc_pow_d -- Raise a complex number to a double-precision power.
 
-Copyright (C) 2009 INRIA
+Copyright (C) 2009, 2020 INRIA
 
 This file is part of GNU MPC.
 
@@ -29,10 +29,10 @@ mpc_pow_d (mpc_ptr z, mpc_srcptr x, double y, mpc_rnd_t rnd)
   int inex;
   
   MPC_ASSERT(FLT_RADIX == 2);
-  mpc_init3 (yy, DBL_MANT_DIG, MPFR_PREC_MIN);
+  mpc_pool_init3 (yy, DBL_MANT_DIG, MPFR_PREC_MIN);
   mpc_set_d (yy, y, MPC_RNDNN);   /* exact */
   inex = mpc_pow (z, x, yy, rnd);
-  mpc_clear (yy);
+  mpc_pool_clear (yy);
   return inex;
 }
 
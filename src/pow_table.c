@@ -0,0 +1,130 @@
+/* mpc_pow_table -- Compute all powers of a complex number up to a given
+   exponent.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* Return non-zero if t, an approximation of x^i obtained by an addition
+   chain at precision p with i < 2^l, can be rounded to z according to rnd;
+   the parts of t are regular. The error bounds are those of mpc_pow_usi,
+   see algorithms.tex. */
+static int
+can_round (mpc_srcptr t, mpfr_prec_t p, mpfr_prec_t l, mpc_srcptr z,
+   mpc_rnd_t rnd)
+{
+   mpfr_exp_t diff;
+   mpfr_prec_t er, ei;
+
+   diff = mpfr_get_exp (mpc_realref (t)) - mpfr_get_exp (mpc_imagref (t));
+   er = (diff >= 1) ? l + 3 : l + (-diff) + 3;
+   ei = (diff <= -1) ? l + 3 : l + diff + 3;
+   return er < p && ei < p
+      && mpfr_can_round (mpc_realref (t), p - er, MPFR_RNDN, MPFR_RNDZ,
+                         MPC_PREC_RE (z) + (MPC_RND_RE (rnd) == MPFR_RNDN))
+      && mpfr_can_round (mpc_imagref (t), p - ei, MPFR_RNDN, MPFR_RNDZ,
+                         MPC_PREC_IM (z) + (MPC_RND_IM (rnd) == MPFR_RNDN));
+}
+
+/* Set rop[i] to op^i for 0 <= i <= n, each rounded according to rnd, and
+   store the ternary values into inex[i] when inex is not NULL.
+   The powers x^i for i >= 3 are computed one after the other as
+   x^(i-1) * x at a common precision p, each of them after i-1
+   multiplications, so that the error analysis of mpc_pow_ui applies with
+   i < 2^l, where 2^l > n: the l additional bits of p keep the error of
+   all entries small. An entry is rounded directly when its approximation
+   is exact or passes the rounding test, and is otherwise computed by
+   mpc_pow_ui; so is the whole table when op has a zero or non-finite
+   part. op may be an element of rop. */
+void
+mpc_pow_table (mpc_ptr rop, mpc_srcptr op, unsigned long n, int *inex,
+   mpc_rnd_t rnd)
+{
+   mpc_t x, t;
+   mpfr_prec_t p, l;
+   mpfr_exp_t saved_emin, saved_emax;
+   unsigned long i, u;
+   int inex_i, inex_t, exact, stop, ok;
+
+   /* copy op exactly, since it may be overwritten */
+   mpc_pool_init3 (x, MPC_PREC_RE (op), MPC_PREC_IM (op));
+   mpc_set (x, op, MPC_RNDNN);
+
+   stop = !mpc_fin_p (x)
+      || mpfr_zero_p (mpc_realref (x)) || mpfr_zero_p (mpc_imagref (x));
+
+   for (l = 0, u = n; u != 0; l++, u >>= 1);
+   p = MPFR_PREC_MIN;
+   for (i = 3; i <= n; i++)
+      p = MPC_MAX (p, MPC_MAX_PREC (rop + i));
+   p += l + 32;
+   mpc_pool_init2 (t, p);
+
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+
+   exact = 1;
+   for (i = 0; i <= n; i++) {
+      if (i == 0 || stop)
+         inex_i = mpc_pow_ui (rop + i, x, i, rnd);
+      else if (i == 1)
+         inex_i = mpc_set (rop + i, x, rnd);
+      else if (i == 2)
+         inex_i = mpc_sqr (rop + i, x, rnd);
+      else {
+         /* the computation is done in the extended exponent range, as in
+            mpc_pow_usi */
+         mpfr_set_emin (mpfr_get_emin_min ());
+         mpfr_set_emax (mpfr_get_emax_max ());
+         if (i == 3)
+            inex_t = mpc_sqr (t, x, MPC_RNDNN);
+         else
+            inex_t = 0;
+         inex_t |= mpc_mul (t, t, x, MPC_RNDNN);
+         exact = exact && inex_t == 0;
+         if (!mpc_fin_p (t))
+            stop = 1;
+         /* the sign of a zero part is left to mpc_pow_ui, even for an
+            exact power */
+         ok = !stop && mpfr_regular_p (mpc_realref (t))
+            && mpfr_regular_p (mpc_imagref (t))
+            && (exact || can_round (t, p, l, rop + i, rnd));
+         if (ok)
+            inex_i = mpc_set (rop + i, t, rnd);
+         mpfr_set_emin (saved_emin);
+         mpfr_set_emax (saved_emax);
+         if (ok) {
+            int inex_re, inex_im;
+
+            inex_re = mpfr_check_range (mpc_realref (rop + i),
+                                        MPC_INEX_RE (inex_i), MPC_RND_RE (rnd));
+            inex_im = mpfr_check_range (mpc_imagref (rop + i),
+                                        MPC_INEX_IM (inex_i), MPC_RND_IM (rnd));
+            inex_i = MPC_INEX (inex_re, inex_im);
+         }
+         else
+            inex_i = mpc_pow_ui (rop + i, x, i, rnd);
+      }
+      if (inex != NULL)
+         inex [i] = inex_i;
+   }
+
+   mpc_pool_clear (t);
+   mpc_pool_clear (x);
+}
@@ -1,6 +1,6 @@
 /* mpc_pow_ui -- Raise a complex number to an integer power.
 
-Copyright (C) 2009, 2010, 2011, 2012 INRIA
+Copyright (C) 2009, 2010, 2011, 2012, 2020 INRIA
 
 This file is part of GNU MPC.
 
@@ -21,101 +21,238 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 #include <limits.h> /* for CHAR_BIT */
 #include "mpc-impl.h"
 
+/* The exponent y of the functions below is given by the unsigned long y
+   if yz is NULL, and by the non-negative integer yz otherwise. */
+#define YBIT(y,yz,i) \
+   (((yz) != NULL) ? mpz_tstbit ((yz), (i)) : (int) (((y) >> (i)) & 1))
+
 static int
-mpc_pow_usi_naive (mpc_ptr z, mpc_srcptr x, unsigned long y, int sign,
-   mpc_rnd_t rnd)
+mpc_pow_usi_naive (mpc_ptr z, mpc_srcptr x, unsigned long y, mpz_srcptr yz,
+   int sign, mpc_rnd_t rnd)
 {
    int inex;
    mpc_t t;
 
-   mpc_init3 (t, sizeof (unsigned long) * CHAR_BIT, MPFR_PREC_MIN);
-   if (sign > 0)
+   if (yz != NULL) {
+      mpfr_prec_t n = (mpfr_prec_t) mpz_sizeinbase (yz, 2);
+      mpc_pool_init3 (t, MPC_MAX (n, MPFR_PREC_MIN), MPFR_PREC_MIN);
+      mpc_set_z (t, yz, MPC_RNDNN); /* exact */
+      if (sign < 0) /* the imaginary part stays +0, as for mpc_set_si */
+         mpfr_neg (mpc_realref (t), mpc_realref (t), MPFR_RNDN);
+   }
+   else {
+      mpc_pool_init3 (t, sizeof (unsigned long) * CHAR_BIT, MPFR_PREC_MIN);
       mpc_set_ui (t, y, MPC_RNDNN); /* exact */
-   else
-      mpc_set_si (t, - (signed long) y, MPC_RNDNN);
+      if (sign < 0)
+         /* y may exceed LONG_MAX when called from mpc_pow_z, so that
+            -y need not fit in a long */
+         mpfr_neg (mpc_realref (t), mpc_realref (t), MPFR_RNDN);
+   }
    inex = mpc_pow (z, x, t, rnd);
-   mpc_clear (t);
+   mpc_pool_clear (t);
 
    return inex;
 }
 
 
-int
-mpc_pow_usi (mpc_ptr z, mpc_srcptr x, unsigned long y, int sign,
+/* Return the size k of the windows for an exponent of nbits bits: with a
+   table of the 2^(k-1) odd powers x, x^3, ..., x^(2^k-1), which costs
+   2^(k-1) multiplications, left-to-right sliding-window exponentiation
+   needs about nbits/(k+1) other multiplications besides the squarings,
+   against nbits/2 for plain binary exponentiation, which is k = 1. */
+static int
+pow_window_size (mpfr_prec_t nbits)
+{
+   return (nbits <= 6) ? 1 : (nbits <= 24) ? 2 : (nbits <= 80) ? 3 : 4;
+}
+
+/* Set t to x^y by sliding-window exponentiation with windows of k bits,
+   where y, given by y or yz, has nbits bits, rounding each operation to
+   nearest at the precision of the variables; tab is an array of 2^(k-1) variables for
+   the odd powers of x, and x2 a variable for x^2, used if k > 1.
+   This is an addition chain, to which the error analysis of
+   algorithms.tex applies. */
+static void
+pow_window (mpc_ptr t, mpc_srcptr x, unsigned long y, mpz_srcptr yz,
+   mpfr_prec_t nbits, int k, mpc_ptr tab, mpc_ptr x2)
+{
+   long i, j, m;
+   unsigned long w;
+   mpc_srcptr s = NULL; /* current value, x^0 at the start */
+
+   if (k > 1) {
+      mpc_sqr (x2, x, MPC_RNDNN);
+      mpc_mul (tab + 1, x, x2, MPC_RNDNN);
+      for (j = 2; j < (1L << (k - 1)); j++)
+         mpc_mul (tab + j, tab + (j - 1), x2, MPC_RNDNN);
+   }
+
+   /* x and the table entries are read in place instead of being copied
+      into t, so that x is not rounded to the working precision */
+   for (i = (long) nbits - 1; i >= 0; ) {
+      if (YBIT (y, yz, i) == 0) {
+         mpc_sqr (t, s, MPC_RNDNN); /* s is not x^0 since bit nbits-1 is set */
+         s = t;
+         i--;
+         continue;
+      }
+      /* the window is made of the bits i down to j, with bit j set */
+      j = (i - k + 1 > 0) ? i - k + 1 : 0;
+      while (YBIT (y, yz, j) == 0)
+         j++;
+      for (w = 0, m = i; m >= j; m--)
+         w = 2 * w + YBIT (y, yz, m);
+      if (s == NULL)
+         s = (w == 1) ? x : tab + (w >> 1);
+      else {
+         for (m = i; m >= j; m--) {
+            mpc_sqr (t, s, MPC_RNDNN);
+            s = t;
+         }
+         mpc_mul (t, t, (w == 1) ? x : tab + (w >> 1), MPC_RNDNN);
+      }
+      i = j - 1;
+   }
+   if (s != t)
+      mpc_set (t, s, MPC_RNDNN); /* y is a single window of the table */
+}
+
+static int
+pow_usz (mpc_ptr z, mpc_srcptr x, unsigned long y, mpz_srcptr yz, int sign,
    mpc_rnd_t rnd)
-   /* computes z = x^(sign*y) */
+   /* computes z = x^(sign*y), where yz, if not NULL, does not fit in an
+      unsigned long */
 {
    int inex;
-   mpc_t t, x3;
-   mpfr_prec_t p, l, l0;
+   mpc_t t, x2, *tab;
+   mpfr_prec_t p, l0, pexact;
+   mpfr_exp_t emax, lsb;
    long unsigned int u;
-   int has3; /* non-zero if y has '11' in its binary representation */
-   int loop, done;
+   mpfr_exp_t saved_emin, saved_emax;
+   int k, n_tab, j, loop, done, exact, naive, inex_re, inex_im;
 
    /* let mpc_pow deal with special values */
    if (!mpc_fin_p (x) || mpfr_zero_p (mpc_realref (x)) || mpfr_zero_p (mpc_imagref(x))
-       || y == 0)
-      return mpc_pow_usi_naive (z, x, y, sign, rnd);
+       || (yz == NULL && y == 0))
+      return mpc_pow_usi_naive (z, x, y, yz, sign, rnd);
    /* easy special cases */
-   else if (y == 1) {
+   else if (yz == NULL && y == 1) {
       if (sign > 0)
          return mpc_set (z, x, rnd);
       else
-         return mpc_ui_div (z, 1ul, x, rnd);
+         return mpc_inv (z, x, rnd);
    }
-   else if (y == 2 && sign > 0)
+   else if (yz == NULL && y == 2 && sign > 0)
       return mpc_sqr (z, x, rnd);
-   /* let mpc_pow treat potential over- and underflows */
-   else {
+   /* let mpc_pow treat potential over- and underflows in the extended
+      exponent range used below; results out of the current range are
+      handled by mpfr_check_range */
+   else if (yz == NULL) {
       mpfr_exp_t exp_r = mpfr_get_exp (mpc_realref (x)),
                  exp_i = mpfr_get_exp (mpc_imagref (x));
-      if (   MPC_MAX (exp_r, exp_i) > mpfr_get_emax () / (mpfr_exp_t) y
+      if (   MPC_MAX (exp_r, exp_i) > mpfr_get_emax_max () / (mpfr_exp_t) y
              /* heuristic for overflow */
-          || MPC_MAX (-exp_r, -exp_i) > (-mpfr_get_emin ()) / (mpfr_exp_t) y
+          || MPC_MAX (-exp_r, -exp_i)
+             > (-mpfr_get_emin_min ()) / (mpfr_exp_t) y
              /* heuristic for underflow */
          )
-         return mpc_pow_usi_naive (z, x, y, sign, rnd);
+         return mpc_pow_usi_naive (z, x, y, yz, sign, rnd);
+   }
+   else {
+      /* Since y > 2^(CHAR_BIT*sizeof(long)-1) exceeds the exponent range,
+         x^y certainly overflows if |x| >= 2, that is if a part of x has an
+         exponent of at least 2, and underflows if |x| < 2^(-1/2), in
+         particular if both exponents are negative. Otherwise, the parts of
+         x are multiples of 2^lsb with lsb <= 0, and so is |x|^2 with
+         2^(2*lsb), and |x|^2 <> 1 since a sum of two non-zero squares is
+         not a power of 4; so ||x|^2-1| >= 2^(2*lsb), which implies
+         |log2(|x|^2)| >= 2^(2*lsb-3) as 1/4 <= |x|^2 < 8, and
+         |log2(|x^y|)| >= 2^(l0-1) * 2^(2*lsb-4), where y has l0 bits.
+         This certainly exceeds the exponent range if l0 + 2*lsb - 5 is
+         at least the number of value bits of mpfr_exp_t, in which case
+         mpc_pow is faster, as the exponentiation would need a precision
+         larger than l0. Smaller overflows and underflows are detected
+         during the computation. */
+      mpfr_exp_t exp_r = mpfr_get_exp (mpc_realref (x)),
+                 exp_i = mpfr_get_exp (mpc_imagref (x));
+      mpfr_exp_t e = MPC_MAX (exp_r, exp_i);
+      mpfr_exp_t l = MPC_MIN (exp_r - (mpfr_exp_t) MPC_PREC_RE (x),
+                              exp_i - (mpfr_exp_t) MPC_PREC_IM (x));
+      if (e >= 2 || e <= -1
+          || (mpfr_exp_t) mpz_sizeinbase (yz, 2) + 2 * l - 5
+             >= (mpfr_exp_t) (sizeof (mpfr_exp_t) * CHAR_BIT - 1))
+         return mpc_pow_usi_naive (z, x, y, yz, sign, rnd);
    }
 
-   has3 = (y & (y >> 1)) != 0;
-   for (l = 0, u = y; u > 3; l ++, u >>= 1);
-   /* l>0 is the number of bits of y, minus 2, thus y has bits:
-      y_{l+1} y_l y_{l-1} ... y_1 y_0 */
-   l0 = l + 2;
+   if (yz != NULL)
+      l0 = (mpfr_prec_t) mpz_sizeinbase (yz, 2);
+   else
+      for (l0 = 0, u = y; u != 0; l0++, u >>= 1);
+   /* l0 is the number of bits of y, so that y < 2^l0 */
+   k = pow_window_size (l0);
+   n_tab = 1 << (k - 1);
    p = MPC_MAX_PREC(z) + l0 + 32; /* l0 ensures that y*2^{-p} <= 1 below */
-   mpc_init2 (t, p);
-   if (has3)
-      mpc_init2 (x3, p);
+
+   /* The parts of x are multiples of 2^lsb less than 2^emax in absolute
+      value, so that those of x^m are multiples of 2^(m*lsb) less than
+      2^(m*(emax+1/2)): they have at most pexact = y*(emax-lsb+1) bits for
+      m <= y, and the computation is exact at this precision. We use it
+      directly if it is not larger than p, and after a failed first trial
+      if it is not too large; this settles in particular the results
+      representable in the target precision, which cannot be rounded from
+      an approximation. pexact = 0 means that it is too large. */
+   emax = MPC_MAX (mpfr_get_exp (mpc_realref (x)),
+                   mpfr_get_exp (mpc_imagref (x)));
+   lsb = MPC_MIN (
+      mpfr_get_exp (mpc_realref (x)) - (mpfr_exp_t) MPC_PREC_RE (x),
+      mpfr_get_exp (mpc_imagref (x)) - (mpfr_exp_t) MPC_PREC_IM (x));
+   if (yz == NULL
+       && (unsigned long) (emax - lsb + 1) <= (unsigned long) (4 * p) / y)
+      pexact = (mpfr_prec_t) ((unsigned long) (emax - lsb + 1) * y);
+   else
+      pexact = 0;
+   exact = (pexact != 0 && pexact <= p);
+   if (exact)
+      p = pexact;
+
+   mpc_pool_init2 (t, p);
+   tab = NULL;
+   if (k > 1) {
+      mpc_pool_init2 (x2, p);
+      tab = (mpc_t *) mpc_pool_alloc (n_tab * sizeof (mpc_t));
+      for (j = 1; j < n_tab; j++)
+         mpc_pool_init2 (tab[j], p);
+   }
+
+   /* the computation is done in the extended exponent range, so that no
+      intermediate underflow or overflow invalidates the error analysis */
+   saved_emin = mpfr_get_emin ();
+   saved_emax = mpfr_get_emax ();
+   mpfr_set_emin (mpfr_get_emin_min ());
+   mpfr_set_emax (mpfr_get_emax_max ());
 
    loop = 0;
    done = 0;
+   naive = 0;
    while (!done) {
       loop++;
 
-      mpc_sqr (t, x, MPC_RNDNN);
-      if (has3) {
-         mpc_mul (x3, t, x, MPC_RNDNN);
-         if ((y >> l) & 1) /* y starts with 11... */
-            mpc_set (t, x3, MPC_RNDNN);
-      }
-      while (l-- > 0) {
-         mpc_sqr (t, t, MPC_RNDNN);
-         if ((y >> l) & 1) {
-            if ((l > 0) && ((y >> (l-1)) & 1)) /* implies has3 <> 0 */ {
-               l--;
-               mpc_sqr (t, t, MPC_RNDNN);
-               mpc_mul (t, t, x3, MPC_RNDNN);
-            }
-            else
-               mpc_mul (t, t, x, MPC_RNDNN);
-         }
+      /* tab[0] is never used, since x^1 is read from x */
+      pow_window (t, x, y, yz, l0, k, (mpc_ptr) tab, x2);
+
+      if (exact) {
+         inex = (sign > 0) ? mpc_set (z, t, rnd) : mpc_inv (z, t, rnd);
+         done = 1;
+         continue;
       }
+
       if (sign < 0)
-         mpc_ui_div (t, 1ul, t, MPC_RNDNN);
+         mpc_inv (t, t, MPC_RNDNN);
 
-      if (mpfr_zero_p (mpc_realref(t)) || mpfr_zero_p (mpc_imagref(t))) {
-         inex = mpc_pow_usi_naive (z, x, y, sign, rnd);
-            /* since mpfr_get_exp() is not defined for zero */
+      if (!mpc_fin_p (t)
+          || mpfr_zero_p (mpc_realref(t)) || mpfr_zero_p (mpc_imagref(t))) {
+         /* an overflow or underflow, or mpfr_get_exp() is not defined */
+         naive = 1;
          done = 1;
       }
       else {
@@ -138,29 +275,71 @@ mpc_pow_usi (mpc_ptr z, mpc_srcptr x, unsigned long y, int sign,
             inex = mpc_set (z, t, rnd);
             done = 1;
          }
-         else if (loop == 1 && SAFE_ABS(mpfr_prec_t, diff) < MPC_MAX_PREC(z)) {
-            /* common case, make a second trial at higher precision */
-            p += MPC_MAX_PREC(x);
-            mpc_set_prec (t, p);
-            if (has3)
-               mpc_set_prec (x3, p);
-            l = l0 - 2;
+         else if (loop == 1
+                  && (pexact != 0 || SAFE_ABS(mpfr_prec_t, diff) < p)) {
+            /* Make a second trial, exactly if possible, otherwise
+               compensating the loss of |diff| bits in the smaller part
+               and with half as many more bits for the hard cases of
+               rounding. */
+            if (pexact != 0) {
+               p = pexact;
+               exact = 1;
+            }
+            else
+               p += SAFE_ABS(mpfr_prec_t, diff) + p / 2;
+            mpc_pool_set_prec (t, p);
+            if (k > 1) {
+               mpc_pool_set_prec (x2, p);
+               for (j = 1; j < n_tab; j++)
+                  mpc_pool_set_prec (tab[j], p);
+            }
          }
          else {
             /* stop the loop and use mpc_pow */
-            inex = mpc_pow_usi_naive (z, x, y, sign, rnd);
+            naive = 1;
             done = 1;
          }
       }
    }
 
-   mpc_clear (t);
-   if (has3)
-      mpc_clear (x3);
+   mpfr_set_emin (saved_emin);
+   mpfr_set_emax (saved_emax);
+   if (naive)
+      inex = mpc_pow_usi_naive (z, x, y, yz, sign, rnd);
+   else {
+      inex_re = mpfr_check_range (mpc_realref (z), MPC_INEX_RE (inex),
+                                  MPC_RND_RE (rnd));
+      inex_im = mpfr_check_range (mpc_imagref (z), MPC_INEX_IM (inex),
+                                  MPC_RND_IM (rnd));
+      inex = MPC_INEX (inex_re, inex_im);
+   }
+
+   mpc_pool_clear (t);
+   if (k > 1) {
+      mpc_pool_clear (x2);
+      for (j = 1; j < n_tab; j++)
+         mpc_pool_clear (tab[j]);
+      mpc_pool_free (tab, n_tab * sizeof (mpc_t));
+   }
 
    return inex;
 }
 
+int
+mpc_pow_usi (mpc_ptr z, mpc_srcptr x, unsigned long y, int sign,
+   mpc_rnd_t rnd)
+   /* computes z = x^(sign*y) */
+{
+   return pow_usz (z, x, y, NULL, sign, rnd);
+}
+
+int
+mpc_pow_usz (mpc_ptr z, mpc_srcptr x, mpz_srcptr y, int sign, mpc_rnd_t rnd)
+   /* computes z = x^(sign*y) for y > 0 not fitting in an unsigned long */
+{
+   return pow_usz (z, x, 0, y, sign, rnd);
+}
+
 
 int
 mpc_pow_ui (mpc_ptr z, mpc_srcptr x, unsigned long y, mpc_rnd_t rnd)
@@ -23,25 +23,28 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 int
 mpc_pow_z (mpc_ptr z, mpc_srcptr x, mpz_srcptr y, mpc_rnd_t rnd)
 {
-   mpc_t yy;
+   mpz_t ay;
    int inex;
-   mpfr_prec_t n = (mpfr_prec_t) mpz_sizeinbase (y, 2);
 
    /* if y fits in an unsigned long or long, call the corresponding functions,
       which are supposed to be more efficient */
    if (mpz_cmp_ui (y, 0ul) >= 0) {
       if (mpz_fits_ulong_p (y))
          return mpc_pow_usi (z, x, mpz_get_ui (y), 1, rnd);
+      else
+         return mpc_pow_usz (z, x, y, 1, rnd);
    }
    else {
       if (mpz_fits_slong_p (y))
          return mpc_pow_usi (z, x, (unsigned long) (-mpz_get_si (y)), -1, rnd);
    }
 
-   mpc_init3 (yy, (n < MPFR_PREC_MIN) ? MPFR_PREC_MIN : n, MPFR_PREC_MIN);
-   mpc_set_z (yy, y, MPC_RNDNN);   /* exact */
-   inex = mpc_pow (z, x, yy, rnd);
-   mpc_clear (yy);
+   mpz_init (ay);
+   mpz_neg (ay, y);
+   if (mpz_fits_ulong_p (ay))
+      inex = mpc_pow_usi (z, x, mpz_get_ui (ay), -1, rnd);
+   else
+      inex = mpc_pow_usz (z, x, ay, -1, rnd);
+   mpz_clear (ay);
    return inex;
 }
-
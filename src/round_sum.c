@@ -0,0 +1,81 @@
+/* mpc_round_sum -- Round a sum of exact numbers and an approximation.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* Let s = tab[0] + ... + tab[n-1] + c' with n <= 3 exact numbers tab[i]
+   and an unknown number c' such that |c - c'| <= 2^err.
+   If the rounding of s in the precision of rop and the direction rnd is
+   determined by this information, put it into rop, its ternary value
+   into *inex, and return 1; otherwise return 0 and leave rop unchanged.
+   Unlike mpfr_can_round, this also works when s is extremely close to a
+   number that is representable in the precision of rop, as long as the
+   difference is determined by c, and it does not depend on the exponent
+   differences between the terms. rop may be one of tab[i] or c. */
+int
+mpc_round_sum (mpfr_ptr rop, mpfr_srcptr *tab, unsigned long n,
+               mpfr_srcptr c, mpfr_exp_t err, mpfr_rnd_t rnd, int *inex)
+{
+  mpfr_t eps, lo, hi, r1, r2;
+  mpfr_ptr t [4];
+  unsigned long i;
+  int inex1, inex2, ok;
+
+  MPC_ASSERT (n <= 3);
+
+  mpc_pool_fr_init2 (eps, MPFR_PREC_MIN);
+  mpc_pool_fr_init2 (lo, mpfr_get_prec (c));
+  mpc_pool_fr_init2 (hi, mpfr_get_prec (c));
+  mpc_pool_fr_init2 (r1, mpfr_get_prec (rop));
+  mpc_pool_fr_init2 (r2, mpfr_get_prec (rop));
+
+  /* lo <= c' <= hi */
+  mpfr_set_ui_2exp (eps, 1, err, MPFR_RNDN);
+  mpfr_sub (lo, c, eps, MPFR_RNDD);
+  mpfr_add (hi, c, eps, MPFR_RNDU);
+
+  for (i = 0; i < n; i++)
+    t [i] = (mpfr_ptr) tab [i];
+  t [n] = lo;
+  inex1 = mpfr_sum (r1, t, n + 1, rnd);
+  t [n] = hi;
+  inex2 = mpfr_sum (r2, t, n + 1, rnd);
+
+  /* Both bounds round to the same number, and this number does not lie
+     between them, since they are on the same side of it; then s, which
+     lies between the bounds, rounds to the same number with the same
+     ternary value. */
+  ok = mpfr_equal_p (r1, r2)
+    && ((inex1 < 0 && inex2 < 0) || (inex1 > 0 && inex2 > 0));
+  if (ok)
+    {
+      mpfr_set (rop, r1, MPFR_RNDN);
+      *inex = inex1;
+    }
+
+  mpc_pool_fr_clear (eps);
+  mpc_pool_fr_clear (lo);
+  mpc_pool_fr_clear (hi);
+  mpc_pool_fr_clear (r1);
+  mpc_pool_fr_clear (r2);
+
+  return ok;
+}
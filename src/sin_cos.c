@@ -310,6 +310,140 @@ mpc_fix_zero (mpfr_t x, mpfr_rnd_t rnd)
     }
 }
 
+/* Compute sin(op) into rop_sin and cos(op) into rop_cos, one of which may
+   be NULL, when both parts of op are regular numbers, using the six pooled
+   temporaries t[0] to t[5], whose precision is changed.
+   The caller must have extended the exponent range; the returned ternary
+   value has not been checked against the original exponent range. */
+int
+mpc_sin_cos_regular (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
+   mpc_rnd_t rnd_sin, mpc_rnd_t rnd_cos, mpfr_t *t)
+{
+   /* let op = a + i*b, then sin(op) = sin(a)*cosh(b) + i*cos(a)*sinh(b)
+                        and  cos(op) = cos(a)*cosh(b) - i*sin(a)*sinh(b).
+
+      For Re(sin(op)) (and analogously, the other parts), we use the
+      following algorithm, with rounding to nearest for all operations
+      and working precision w:
+
+      (1) x = o(sin(a))
+      (2) y = o(cosh(b))
+      (3) r = o(x*y)
+      then the error on r is at most 4 ulps, since we can write
+      r = sin(a)*cosh(b)*(1+t)^3 with |t| <= 2^(-w),
+      thus for w >= 2, r = sin(a)*cosh(b)*(1+4*t) with |t| <= 2^(-w),
+      thus the relative error is bounded by 4*2^(-w) <= 4*ulp(r).
+   */
+   mpfr_ptr s = t [0], c = t [1], sh = t [2], ch = t [3], sch = t [4],
+      csh = t [5];
+   mpfr_prec_t prec;
+   int ok;
+   int inex_re, inex_im, inex_sin, inex_cos, loop = 0;
+
+   prec = 2;
+   if (rop_sin != NULL)
+     {
+       mp_prec_t er, ei;
+       prec = MPC_MAX (prec, MPC_MAX_PREC (rop_sin));
+       /* since the Taylor expansion of sin(x) at x=0 is x - x^3/6 + O(x^5),
+          if x <= 2^(-p), then the second term/x is about 2^(-2p)/6, thus we
+          need at least 2p+3 bits of precision. This is true only when x is
+          exactly representable in the target precision. */
+       if (MPC_MAX_PREC (op) <= prec)
+         {
+           er = mpfr_get_exp (mpc_realref (op));
+           ei = mpfr_get_exp (mpc_imagref (op));
+           /* consider the maximal exponent only */
+           er = (er < ei) ? ei : er;
+           if (er < 0)
+             if (prec < 2 * (mp_prec_t) (-er) + 3)
+               prec = 2 * (mp_prec_t) (-er) + 3;
+         }
+     }
+   if (rop_cos != NULL)
+      prec = MPC_MAX (prec, MPC_MAX_PREC (rop_cos));
+
+   do {
+      loop ++;
+      prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
+
+      mpc_pool_fr_set_prec (s, prec);
+      mpc_pool_fr_set_prec (c, prec);
+      mpc_pool_fr_set_prec (sh, prec);
+      mpc_pool_fr_set_prec (ch, prec);
+      mpc_pool_fr_set_prec (sch, prec);
+      mpc_pool_fr_set_prec (csh, prec);
+
+      mpfr_sin_cos (s, c, mpc_realref(op), MPFR_RNDN);
+      mpfr_sinh_cosh (sh, ch, mpc_imagref(op), MPFR_RNDN);
+
+      ok = 1;
+
+      if (rop_sin != NULL) {
+         /* real part of sine */
+         mpfr_mul (sch, s, ch, MPFR_RNDN);
+         ok = (!mpfr_number_p (sch))
+               || mpfr_can_round (sch, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                     MPC_PREC_RE (rop_sin)
+                     + (MPC_RND_RE (rnd_sin) == MPFR_RNDN));
+
+         if (ok) {
+            /* imaginary part of sine */
+            mpfr_mul (csh, c, sh, MPFR_RNDN);
+            ok = (!mpfr_number_p (csh))
+                  || mpfr_can_round (csh, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                        MPC_PREC_IM (rop_sin)
+                        + (MPC_RND_IM (rnd_sin) == MPFR_RNDN));
+         }
+      }
+
+      if (rop_cos != NULL && ok) {
+         /* real part of cosine */
+         mpfr_mul (c, c, ch, MPFR_RNDN);
+         ok = (!mpfr_number_p (c))
+               || mpfr_can_round (c, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                     MPC_PREC_RE (rop_cos)
+                     + (MPC_RND_RE (rnd_cos) == MPFR_RNDN));
+
+         if (ok) {
+            /* imaginary part of cosine */
+            mpfr_mul (s, s, sh, MPFR_RNDN);
+            mpfr_neg (s, s, MPFR_RNDN);
+            ok = (!mpfr_number_p (s))
+                  || mpfr_can_round (s, prec - 2, MPFR_RNDN, MPFR_RNDZ,
+                        MPC_PREC_IM (rop_cos)
+                        + (MPC_RND_IM (rnd_cos) == MPFR_RNDN));
+         }
+      }
+   } while (ok == 0);
+
+   if (rop_sin != NULL) {
+      inex_re = mpfr_set (mpc_realref (rop_sin), sch, MPC_RND_RE (rnd_sin));
+      if (mpfr_inf_p (sch))
+        inex_re = mpc_fix_inf (mpc_realref (rop_sin), MPC_RND_RE (rnd_sin));
+      inex_im = mpfr_set (mpc_imagref (rop_sin), csh, MPC_RND_IM (rnd_sin));
+      if (mpfr_inf_p (csh))
+        inex_im = mpc_fix_inf (mpc_imagref (rop_sin), MPC_RND_IM (rnd_sin));
+      inex_sin = MPC_INEX (inex_re, inex_im);
+   }
+   else
+      inex_sin = MPC_INEX (0,0); /* return exact if not computed */
+
+   if (rop_cos != NULL) {
+      inex_re = mpfr_set (mpc_realref (rop_cos), c, MPC_RND_RE (rnd_cos));
+      if (mpfr_inf_p (c))
+        inex_re = mpc_fix_inf (mpc_realref (rop_cos), MPC_RND_RE (rnd_cos));
+      inex_im = mpfr_set (mpc_imagref (rop_cos), s, MPC_RND_IM (rnd_cos));
+      if (mpfr_inf_p (s))
+        inex_im = mpc_fix_inf (mpc_imagref (rop_cos), MPC_RND_IM (rnd_cos));
+      inex_cos = MPC_INEX (inex_re, inex_im);
+   }
+   else
+      inex_cos = MPC_INEX (0,0); /* return exact if not computed */
+
+   return MPC_INEX12 (inex_sin, inex_cos);
+}
+
 int
 mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
    mpc_rnd_t rnd_sin, mpc_rnd_t rnd_cos)
@@ -324,25 +458,8 @@ mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
    else if (mpfr_zero_p (mpc_realref (op)))
       return mpc_sin_cos_imag (rop_sin, rop_cos, op, rnd_sin, rnd_cos);
    else {
-      /* let op = a + i*b, then sin(op) = sin(a)*cosh(b) + i*cos(a)*sinh(b)
-                           and  cos(op) = cos(a)*cosh(b) - i*sin(a)*sinh(b).
-
-         For Re(sin(op)) (and analogously, the other parts), we use the
-         following algorithm, with rounding to nearest for all operations
-         and working precision w:
-
-         (1) x = o(sin(a))
-         (2) y = o(cosh(b))
-         (3) r = o(x*y)
-         then the error on r is at most 4 ulps, since we can write
-         r = sin(a)*cosh(b)*(1+t)^3 with |t| <= 2^(-w),
-         thus for w >= 2, r = sin(a)*cosh(b)*(1+4*t) with |t| <= 2^(-w),
-         thus the relative error is bounded by 4*2^(-w) <= 4*ulp(r).
-      */
-      mpfr_t s, c, sh, ch, sch, csh;
-      mpfr_prec_t prec;
-      int ok;
-      int inex_re, inex_im, inex_sin, inex_cos, loop = 0;
+      mpfr_t t [6];
+      int inex_re, inex_im, inex, inex_sin, inex_cos, i;
       mpfr_exp_t saved_emin, saved_emax;
 
       saved_emin = mpfr_get_emin ();
@@ -350,120 +467,13 @@ mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
       mpfr_set_emin (mpfr_get_emin_min ());
       mpfr_set_emax (mpfr_get_emax_max ());
 
-      prec = 2;
-      if (rop_sin != NULL)
-        {
-          mp_prec_t er, ei;
-          prec = MPC_MAX (prec, MPC_MAX_PREC (rop_sin));
-          /* since the Taylor expansion of sin(x) at x=0 is x - x^3/6 + O(x^5),
-             if x <= 2^(-p), then the second term/x is about 2^(-2p)/6, thus we
-             need at least 2p+3 bits of precision. This is true only when x is
-             exactly representable in the target precision. */
-          if (MPC_MAX_PREC (op) <= prec)
-            {
-              er = mpfr_get_exp (mpc_realref (op));
-              ei = mpfr_get_exp (mpc_imagref (op));
-              /* consider the maximal exponent only */
-              er = (er < ei) ? ei : er;
-              if (er < 0)
-                if (prec < 2 * (mp_prec_t) (-er) + 3)
-                  prec = 2 * (mp_prec_t) (-er) + 3;
-            }
-        }
-      if (rop_cos != NULL)
-         prec = MPC_MAX (prec, MPC_MAX_PREC (rop_cos));
-
-      mpfr_init2 (s, 2);
-      mpfr_init2 (c, 2);
-      mpfr_init2 (sh, 2);
-      mpfr_init2 (ch, 2);
-      mpfr_init2 (sch, 2);
-      mpfr_init2 (csh, 2);
-
-      do {
-         loop ++;
-         prec += (loop <= 2) ? mpc_ceil_log2 (prec) + 5 : prec / 2;
-
-         mpfr_set_prec (s, prec);
-         mpfr_set_prec (c, prec);
-         mpfr_set_prec (sh, prec);
-         mpfr_set_prec (ch, prec);
-         mpfr_set_prec (sch, prec);
-         mpfr_set_prec (csh, prec);
-
-         mpfr_sin_cos (s, c, mpc_realref(op), MPFR_RNDN);
-         mpfr_sinh_cosh (sh, ch, mpc_imagref(op), MPFR_RNDN);
-
-         ok = 1;
-
-         if (rop_sin != NULL) {
-            /* real part of sine */
-            mpfr_mul (sch, s, ch, MPFR_RNDN);
-            ok = (!mpfr_number_p (sch))
-                  || mpfr_can_round (sch, prec - 2, MPFR_RNDN, MPFR_RNDZ,
-                        MPC_PREC_RE (rop_sin)
-                        + (MPC_RND_RE (rnd_sin) == MPFR_RNDN));
-
-            if (ok) {
-               /* imaginary part of sine */
-               mpfr_mul (csh, c, sh, MPFR_RNDN);
-               ok = (!mpfr_number_p (csh))
-                     || mpfr_can_round (csh, prec - 2, MPFR_RNDN, MPFR_RNDZ,
-                           MPC_PREC_IM (rop_sin)
-                           + (MPC_RND_IM (rnd_sin) == MPFR_RNDN));
-            }
-         }
-
-         if (rop_cos != NULL && ok) {
-            /* real part of cosine */
-            mpfr_mul (c, c, ch, MPFR_RNDN);
-            ok = (!mpfr_number_p (c))
-                  || mpfr_can_round (c, prec - 2, MPFR_RNDN, MPFR_RNDZ,
-                        MPC_PREC_RE (rop_cos)
-                        + (MPC_RND_RE (rnd_cos) == MPFR_RNDN));
-
-            if (ok) {
-               /* imaginary part of cosine */
-               mpfr_mul (s, s, sh, MPFR_RNDN);
-               mpfr_neg (s, s, MPFR_RNDN);
-               ok = (!mpfr_number_p (s))
-                     || mpfr_can_round (s, prec - 2, MPFR_RNDN, MPFR_RNDZ,
-                           MPC_PREC_IM (rop_cos)
-                           + (MPC_RND_IM (rnd_cos) == MPFR_RNDN));
-            }
-         }
-      } while (ok == 0);
-
-      if (rop_sin != NULL) {
-         inex_re = mpfr_set (mpc_realref (rop_sin), sch, MPC_RND_RE (rnd_sin));
-         if (mpfr_inf_p (sch))
-           inex_re = mpc_fix_inf (mpc_realref (rop_sin), MPC_RND_RE (rnd_sin));
-         inex_im = mpfr_set (mpc_imagref (rop_sin), csh, MPC_RND_IM (rnd_sin));
-         if (mpfr_inf_p (csh))
-           inex_im = mpc_fix_inf (mpc_imagref (rop_sin), MPC_RND_IM (rnd_sin));
-         inex_sin = MPC_INEX (inex_re, inex_im);
-      }
-      else
-         inex_sin = MPC_INEX (0,0); /* return exact if not computed */
-
-      if (rop_cos != NULL) {
-         inex_re = mpfr_set (mpc_realref (rop_cos), c, MPC_RND_RE (rnd_cos));
-         if (mpfr_inf_p (c))
-           inex_re = mpc_fix_inf (mpc_realref (rop_cos), MPC_RND_RE (rnd_cos));
-         inex_im = mpfr_set (mpc_imagref (rop_cos), s, MPC_RND_IM (rnd_cos));
-         if (mpfr_inf_p (s))
-           inex_im = mpc_fix_inf (mpc_imagref (rop_cos), MPC_RND_IM (rnd_cos));
-         inex_cos = MPC_INEX (inex_re, inex_im);
-      }
-      else
-         inex_cos = MPC_INEX (0,0); /* return exact if not computed */
-
-      mpfr_clear (s);
-      mpfr_clear (c);
-      mpfr_clear (sh);
-      mpfr_clear (ch);
-      mpfr_clear (sch);
-      mpfr_clear (csh);
+      for (i = 0; i < 6; i++)
+         mpc_pool_fr_init2 (t [i], 2);
+      inex = mpc_sin_cos_regular (rop_sin, rop_cos, op, rnd_sin, rnd_cos, t);
+      inex_sin = MPC_INEX1 (inex);
+      inex_cos = MPC_INEX2 (inex);
+      for (i = 0; i < 6; i++)
+         mpc_pool_fr_clear (t [i]);
 
       /* restore the exponent range, and check the range of results */
       mpfr_set_emin (saved_emin);
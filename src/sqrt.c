@@ -172,6 +172,11 @@ mpc_sqrt (mpc_ptr a, mpc_srcptr b, mpc_rnd_t rnd)
       return MPC_INEX (inex_w, inex_t);
     }
 
+  /* small precisions: try a double-double evaluation first */
+  if (MPC_MAX_PREC (a) <= MPC_FP_PREC && MPC_MAX_PREC (b) <= MPC_FP_PREC
+      && mpc_sqrt_fp (a, b, rnd, &inex_w))
+    return inex_w;
+
   prec = MPC_MAX_PREC(a);
 
   mpfr_init (w);
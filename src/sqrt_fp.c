@@ -0,0 +1,363 @@
+/* mpc_sqrt_fp -- Floating-point filter for the square root.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <float.h>
+#include <math.h>
+#include "mpc-impl.h"
+
+/* For operands and results of at most MPC_FP_PREC = 53 bits, the square
+   root is first evaluated in double-double arithmetic, that is, with
+   unevaluated sums hi + lo of two IEEE 754 binary64 numbers. This needs
+   binary64 operations rounded to nearest without extended precision for
+   intermediate results; the arithmetic is then accurate to about 2^-104,
+   and the result is rounded to the target precision when mpfr_can_round
+   succeeds on it, which only fails for exactly representable results and
+   hard-to-round cases. In all other cases, the caller falls back to the
+   Ziv loop.
+
+   The transcendental functions are not filtered in this way, since the
+   elementary functions of the C library come without a guaranteed error
+   bound. */
+
+#if defined (FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0 \
+    && FLT_RADIX == 2 && DBL_MANT_DIG == 53 && GMP_NUMB_BITS == 64
+#define MPC_HAVE_DD 1
+#endif
+
+#ifdef MPC_HAVE_DD
+
+/* The error-free transformations below need each product to be rounded
+   separately: the contraction of a product and a sum into a fused
+   multiply-add, which GCC does by default in GNU mode on processors that
+   have one, would break split, two_prod and the correction steps. */
+#if defined (__GNUC__) && !defined (__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#else
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+/* bound on the absolute value of the exponents of the operands; it
+   ensures that no intermediate result overflows and that no error term
+   is subnormal */
+#define FP_EMAX 400
+
+/* The algorithm below computes w and t with relative errors bounded by a
+   few times 2^-104 each; we use the safe bound 2^-90 on the relative
+   error, to which the conversion to MPFR adds 2^-115. */
+#define FP_ERR 88
+
+typedef struct {
+  double hi, lo;
+} dd_t;
+
+/* return non-zero if binary64 operations round to nearest */
+static int
+fp_round_to_nearest (void)
+{
+  volatile double one = 1.0, tiny = 1.0 / 1152921504606846976.0; /* 2^-60 */
+
+  return one + tiny == one && one - tiny == one;
+}
+
+/* error-free sum a + b */
+static dd_t
+two_sum (double a, double b)
+{
+  dd_t r;
+  double bb;
+
+  r.hi = a + b;
+  bb = r.hi - a;
+  r.lo = (a - (r.hi - bb)) + (b - bb);
+  return r;
+}
+
+/* error-free sum a + b for |a| >= |b| */
+static dd_t
+fast_two_sum (double a, double b)
+{
+  dd_t r;
+
+  r.hi = a + b;
+  r.lo = b - (r.hi - a);
+  return r;
+}
+
+/* Veltkamp splitting of a into two halves of 26 bits */
+static void
+split (double a, double *hi, double *lo)
+{
+  double c = 134217729.0 * a; /* 2^27 + 1 */
+
+  *hi = c - (c - a);
+  *lo = a - *hi;
+}
+
+/* error-free product a * b, by Dekker's algorithm */
+static dd_t
+two_prod (double a, double b)
+{
+  dd_t r;
+  double ah, al, bh, bl;
+
+  r.hi = a * b;
+  split (a, &ah, &al);
+  split (b, &bh, &bl);
+  r.lo = ((ah * bh - r.hi) + ah * bl + al * bh) + al * bl;
+  return r;
+}
+
+/* a + b, for a, b >= 0 */
+static dd_t
+dd_add (dd_t a, dd_t b)
+{
+  dd_t s = two_sum (a.hi, b.hi);
+
+  s.lo += a.lo + b.lo;
+  return fast_two_sum (s.hi, s.lo);
+}
+
+/* sqrt(a), for a > 0, with one Newton step from the binary64 square root */
+static dd_t
+dd_sqrt (dd_t a)
+{
+  double s = sqrt (a.hi);
+  dd_t p = two_prod (s, s);
+
+  return fast_two_sum (s, (((a.hi - p.hi) - p.lo) + a.lo) / (2.0 * s));
+}
+
+/* y / w, with one correction step from the binary64 quotient */
+static dd_t
+dd_div (double y, dd_t w)
+{
+  double q = y / w.hi;
+  dd_t p = two_prod (q, w.hi);
+
+  return fast_two_sum (q, (((y - p.hi) - p.lo) - q * w.lo) / w.hi);
+}
+
+/* return the regular number x of at most 53 bits as a double */
+static double
+fr_get_d (mpfr_srcptr x)
+{
+  mp_limb_t m = ((mp_limb_t *) mpfr_custom_get_significand (x)) [0];
+  double d = ldexp ((double) (m >> 11), (int) mpfr_get_exp (x) - 53);
+
+  return mpfr_signbit (x) ? -d : d;
+}
+
+/* Set v, with significand in the two limbs of buf, to a, for a != 0, up to
+   a relative error of 2^-115. The mpfr_set_d and mpfr_add_d functions
+   would do the same, but several times slower. */
+static void
+dd_get_fr (mpfr_ptr v, mp_limb_t *buf, dd_t a)
+{
+  int e, sh, s = 1;
+  mp_limb_t hi, lo;
+  double l;
+
+  if (a.hi < 0)
+    {
+      a.hi = -a.hi;
+      a.lo = -a.lo;
+      s = -1;
+    }
+  /* a = (hi * 2^64 +/- lo) * 2^(e-117), where hi < 2^53 and lo <= 2^63 */
+  hi = (mp_limb_t) ldexp (frexp (a.hi, &e), 53);
+  l = ldexp (a.lo, 117 - e);
+  if (l >= 0)
+    lo = (mp_limb_t) l;
+  else
+    {
+      lo = (mp_limb_t) -l;
+      if (lo != 0)
+        {
+          hi--;
+          lo = -lo;
+        }
+    }
+  /* normalize; hi >= 2^51 since |a.lo| <= ulp(a.hi)/2 */
+  for (sh = 0; (hi >> (63 - sh)) == 0; sh++);
+  buf [1] = (hi << sh) | (lo >> (64 - sh));
+  buf [0] = lo << sh;
+  mpfr_custom_init_set (v, s * MPFR_REGULAR_KIND, e + 11 - sh, 128, buf);
+}
+
+/* return non-zero if the correct rounding of the number approximated by
+   v can be determined for the precision of rop and the rounding mode rnd */
+static int
+fp_can_round (mpfr_srcptr v, mpfr_srcptr rop, mpfr_rnd_t rnd)
+{
+  return mpfr_can_round (v, FP_ERR, MPFR_RNDN, MPFR_RNDZ,
+                         mpfr_get_prec (rop) + (rnd == MPFR_RNDN));
+}
+
+/* Set re and im to approximations of the real and imaginary parts of
+   sqrt (x + i*y), for x, y non-zero with exponents in [-FP_EMAX, FP_EMAX],
+   with relative errors less than 2^-90 */
+static void
+fp_sqrt (dd_t *re, dd_t *im, double x, double y)
+{
+  dd_t w, t;
+
+  /* w = sqrt ((|x| + sqrt (x^2 + y^2)) / 2), t = y / (2w), as in mpc_sqrt;
+     the divisions by 2 are exact */
+  w = dd_sqrt (dd_add (two_prod (x, x), two_prod (y, y)));
+  t.hi = (x < 0) ? -x : x;
+  t.lo = 0.0;
+  w = dd_add (w, t);
+  w.hi /= 2.0;
+  w.lo /= 2.0;
+  w = dd_sqrt (w);
+  t = dd_div (y, w);
+  t.hi /= 2.0;
+  t.lo /= 2.0;
+
+  if (x > 0)
+    {
+      *re = w;
+      *im = t;
+    }
+  else
+    {
+      /* re = |t|, im = sign(y) w */
+      if (y < 0)
+        {
+          t.hi = -t.hi;
+          t.lo = -t.lo;
+          w.hi = -w.hi;
+          w.lo = -w.lo;
+        }
+      *re = t;
+      *im = w;
+    }
+}
+
+/* Return non-zero if the approximation a of a number z, with a relative
+   error less than 2^-90 and |a.lo| <= ulp(a.hi)/2, determines the rounding
+   to nearest of z to a normal binary32 (p = 24) or binary64 (p = 53)
+   number, and set *r to it in that case. */
+static int
+fp_round_native (double *r, dd_t a, int p)
+{
+  double res, next, gap, ar;
+
+  if (p == 53)
+    {
+      *r = a.hi;
+      res = a.lo;
+      if (a.hi < DBL_MIN && a.hi > -DBL_MIN)
+        return 0;
+      next = nextafter (*r, (res < 0) ? -DBL_MAX : DBL_MAX);
+    }
+  else
+    {
+      *r = (double) (float) a.hi;
+      /* a.hi - *r is exact, and the addition of a.lo is accurate to
+         2^-53 relatively */
+      res = (a.hi - *r) + a.lo;
+      if (*r < FLT_MIN && *r > -FLT_MIN)
+        return 0;
+      if (*r > FLT_MAX || *r < -FLT_MAX)
+        return 0;
+      next = (double) nextafterf ((float) *r, (res < 0) ? -FLT_MAX : FLT_MAX);
+    }
+  /* the neighbours of *r are at a distance at least gap, and the error on
+     res is less than 2^-88 |*r| */
+  gap = (next > *r) ? next - *r : *r - next;
+  ar = (*r < 0) ? -*r : *r;
+  if (res < 0)
+    res = -res;
+  return res + ar / 309485009821345068724781056.0 /* 2^88 */ < gap / 2.0;
+}
+
+#endif /* MPC_HAVE_DD */
+
+/* Try to compute sqrt(op) in double-double arithmetic, where both parts
+   of op are non-zero numbers of at most MPC_FP_PREC bits, and both parts of
+   rop have at most MPC_FP_PREC bits. In case of success, set rop, store
+   the ternary value into *inex and return non-zero; otherwise, return 0
+   and leave rop unchanged. */
+int
+mpc_sqrt_fp (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, int *inex)
+{
+#ifdef MPC_HAVE_DD
+  double x, y;
+  dd_t re, im;
+  int inex_re, inex_im;
+  mpfr_exp_t ex = mpfr_get_exp (mpc_realref (op)),
+             ey = mpfr_get_exp (mpc_imagref (op));
+  mpfr_t u, v;
+  mp_limb_t ud [2], vd [2];
+
+  /* the results are less than 2^(FP_EMAX/2+1) and at least
+     2^(-3*FP_EMAX/2-4) in absolute value */
+  if (ex < -FP_EMAX || ex > FP_EMAX || ey < -FP_EMAX || ey > FP_EMAX
+      || mpfr_get_emin () >= -2 * FP_EMAX || mpfr_get_emax () <= FP_EMAX
+      || !fp_round_to_nearest ())
+    return 0;
+
+  x = fr_get_d (mpc_realref (op));
+  y = fr_get_d (mpc_imagref (op));
+  fp_sqrt (&re, &im, x, y);
+
+  dd_get_fr (u, ud, re);
+  dd_get_fr (v, vd, im);
+  if (!fp_can_round (u, mpc_realref (rop), MPC_RND_RE (rnd))
+      || !fp_can_round (v, mpc_imagref (rop), MPC_RND_IM (rnd)))
+    return 0;
+
+  inex_re = mpfr_set (mpc_realref (rop), u, MPC_RND_RE (rnd));
+  inex_im = mpfr_set (mpc_imagref (rop), v, MPC_RND_IM (rnd));
+  *inex = MPC_INEX (inex_re, inex_im);
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+/* Try to compute the rounding to nearest of sqrt (x + i*y) to binary32
+   (p = 24) or binary64 (p = 53) numbers using only floating-point
+   arithmetic, for x and y representable in that format. In case of
+   success, store the result into *re and *im and return non-zero;
+   otherwise, return 0. */
+int
+mpc_sqrt_native (double *re, double *im, double x, double y, int p)
+{
+#ifdef MPC_HAVE_DD
+  dd_t u, v;
+  int ex, ey;
+
+  /* x - x is NaN for infinities and NaN */
+  if (x == 0 || y == 0 || x - x != 0 || y - y != 0)
+    return 0;
+  frexp (x, &ex);
+  frexp (y, &ey);
+  if (ex < -FP_EMAX || ex > FP_EMAX || ey < -FP_EMAX || ey > FP_EMAX
+      || !fp_round_to_nearest ())
+    return 0;
+
+  fp_sqrt (&u, &v, x, y);
+  return fp_round_native (re, u, p) && fp_round_native (im, v, p);
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,274 @@
+/* mpc_sum_mt, mpc_dot_mt -- Sum and dot product of long arrays of complex
+   numbers on several threads.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+/* The array is cut into k chunks, and the sum of each chunk is computed
+   by mpc_sum or mpc_dot on its own thread, correctly rounded to a working
+   precision w, in the largest exponent range. The k partial sums are then
+   added by mpfr_sum:
+   - if all partial sums of a part are exact, or one of them is not a
+     finite number, their sum rounded to the target is the correct
+     rounding of the whole sum;
+   - otherwise, each inexact partial sum s[j] has an error less than
+     ulp(s[j]) = 2^(EXP(s[j])-w), and their sum t rounded to nearest at
+     precision w an error at most ulp(t)/2, so that the total error is
+     less than (k+1)*2^(e-w), with e the largest exponent among t and the
+     inexact s[j]; if this does not allow to round t, we try again with
+     twice the working precision, then fall back to mpc_sum or mpc_dot.
+   Either way the result is the correct rounding of the exact sum, and
+   the ternary value is the one of the sequential functions, so that both
+   are the same for any number of threads. */
+
+typedef struct {
+  mpc_ptr s;            /* partial sum */
+  const mpc_ptr *x;
+  const mpc_ptr *y;     /* NULL for a sum */
+  unsigned long n;
+  mpc_rnd_t rnd;
+  int inex;
+} mt_chunk;
+
+static void
+chunk_eval (mt_chunk *c)
+{
+  c->inex = (c->y == NULL) ? mpc_sum (c->s, c->x, c->n, c->rnd)
+    : mpc_dot (c->s, c->x, c->y, c->n, c->rnd);
+}
+
+#ifdef HAVE_PTHREAD
+static void *
+chunk_thread (void *arg)
+{
+  /* the exponent range of MPFR is a per-thread setting */
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+  chunk_eval ((mt_chunk *) arg);
+  /* the pool of this thread would be lost when it terminates */
+  mpc_free_pool ();
+  return NULL;
+}
+#endif
+
+/* Set r to the correct rounding of the sum of the k partial sums s[j] of
+   precision w, with ternary values inex_s[j], using the variable t of
+   precision w. Return 1 and store the ternary value in *inex, or return 0
+   if the error bound does not allow rounding; then r is not modified. */
+static int
+mt_round (mpfr_ptr r, mpfr_ptr *s, const int *inex_s, unsigned int k,
+          mpfr_ptr t, mpfr_prec_t w, mpfr_rnd_t rnd, int *inex)
+{
+  mpfr_exp_t e;
+  mpfr_prec_t err;
+  unsigned int j;
+  int exact = 1;
+
+  for (j = 0; j < k; j++)
+    {
+      if (!mpfr_number_p (s[j]))
+        break;
+      if (inex_s[j] != 0)
+        exact = 0;
+    }
+  if (j < k || exact)
+    {
+      *inex = mpfr_sum (r, s, k, rnd);
+      return 1;
+    }
+
+  mpfr_sum (t, s, k, MPFR_RNDN);
+  if (mpfr_zero_p (t))
+    return 0;
+  e = mpfr_get_exp (t);
+  for (j = 0; j < k; j++)
+    if (inex_s[j] != 0 && mpfr_get_exp (s[j]) > e)
+      e = mpfr_get_exp (s[j]);
+  err = w - mpc_ceil_log2 ((mpfr_prec_t) k + 1) - (e - mpfr_get_exp (t));
+  if (err <= 0
+      || !mpfr_can_round (t, err, MPFR_RNDN, MPFR_RNDZ,
+                          mpfr_get_prec (r) + (rnd == MPFR_RNDN)))
+    return 0;
+  *inex = mpfr_set (r, t, rnd);
+  return 1;
+}
+
+/* res <- x[0]*y[0] + ... + x[n-1]*y[n-1], or x[0] + ... + x[n-1] if y is
+   NULL, on at most 'threads' threads */
+static int
+mt_eval (mpc_ptr res, const mpc_ptr *x, const mpc_ptr *y, unsigned long n,
+         mpc_rnd_t rnd, unsigned int threads)
+{
+  mt_chunk *c;
+  mpc_ptr s;
+  mpfr_ptr *s_re, *s_im;
+  int *inex_re, *inex_im;
+#ifdef HAVE_PTHREAD
+  pthread_t *tid;
+  int *started;
+#endif
+  mpc_t r, t;
+  mpfr_prec_t wre, wim;
+  mpfr_exp_t saved_emin, saved_emax;
+  unsigned int k, j;
+  unsigned long start;
+  int loop, done_re = 0, done_im = 0, ire = 0, iim = 0, inex;
+
+  k = threads;
+  if ((unsigned long) k > n / MPC_MT_CHUNK_MIN)
+    k = (unsigned int) (n / MPC_MT_CHUNK_MIN);
+#ifdef HAVE_PTHREAD
+  if (!mpfr_buildopt_tls_p ())
+    k = 1;
+#else
+  k = 1;
+#endif
+  if (k <= 1)
+    return (y == NULL) ? mpc_sum (res, x, n, rnd) : mpc_dot (res, x, y, n, rnd);
+
+  c = (mt_chunk *) malloc (k * sizeof (mt_chunk));
+  s = (mpc_ptr) malloc (k * sizeof (mpc_t));
+  s_re = (mpfr_ptr *) malloc (2 * k * sizeof (mpfr_ptr));
+  inex_re = (int *) malloc (2 * k * sizeof (int));
+  MPC_ASSERT (c != NULL && s != NULL && s_re != NULL && inex_re != NULL);
+  s_im = s_re + k;
+  inex_im = inex_re + k;
+#ifdef HAVE_PTHREAD
+  tid = (pthread_t *) malloc (k * sizeof (pthread_t));
+  started = (int *) malloc (k * sizeof (int));
+  MPC_ASSERT (tid != NULL && started != NULL);
+#endif
+
+  wre = mpfr_get_prec (mpc_realref (res));
+  wim = mpfr_get_prec (mpc_imagref (res));
+  mpc_init3 (r, wre, wim);
+  wre += mpc_ceil_log2 ((mpfr_prec_t) k + 1) + 32;
+  wim += mpc_ceil_log2 ((mpfr_prec_t) k + 1) + 32;
+  mpc_init3 (t, wre, wim);
+  for (j = 0, start = 0; j < k; j++)
+    {
+      mpc_init3 (s + j, wre, wim);
+      c[j].s = s + j;
+      c[j].x = x + start;
+      c[j].y = (y == NULL) ? NULL : y + start;
+      c[j].n = n / k + (j < n % k);
+      c[j].rnd = rnd;
+      start += c[j].n;
+      s_re[j] = mpc_realref (s + j);
+      s_im[j] = mpc_imagref (s + j);
+    }
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  for (loop = 0; loop < 2 && !(done_re && done_im); loop++)
+    {
+      if (loop > 0)
+        {
+          wre *= 2;
+          wim *= 2;
+          mpfr_set_prec (mpc_realref (t), wre);
+          mpfr_set_prec (mpc_imagref (t), wim);
+          for (j = 0; j < k; j++)
+            {
+              mpfr_set_prec (s_re[j], wre);
+              mpfr_set_prec (s_im[j], wim);
+            }
+        }
+
+      /* chunk 0 is computed by the calling thread, and so are the
+         chunks for which no thread could be created */
+#ifdef HAVE_PTHREAD
+      for (j = 1; j < k; j++)
+        started[j] = (pthread_create (&tid[j], NULL, chunk_thread, &c[j]) == 0);
+#endif
+      chunk_eval (&c[0]);
+      for (j = 1; j < k; j++)
+        {
+#ifdef HAVE_PTHREAD
+          if (started[j])
+            {
+              pthread_join (tid[j], NULL);
+              continue;
+            }
+#endif
+          chunk_eval (&c[j]);
+        }
+
+      for (j = 0; j < k; j++)
+        {
+          inex_re[j] = MPC_INEX_RE (c[j].inex);
+          inex_im[j] = MPC_INEX_IM (c[j].inex);
+        }
+      if (!done_re)
+        done_re = mt_round (mpc_realref (r), s_re, inex_re, k,
+                            mpc_realref (t), wre, MPC_RND_RE (rnd), &ire);
+      if (!done_im)
+        done_im = mt_round (mpc_imagref (r), s_im, inex_im, k,
+                            mpc_imagref (t), wim, MPC_RND_IM (rnd), &iim);
+    }
+
+  if (done_re && done_im)
+    mpc_set (res, r, MPC_RNDNN); /* exact */
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+  if (done_re && done_im)
+    {
+      ire = mpfr_check_range (mpc_realref (res), ire, MPC_RND_RE (rnd));
+      iim = mpfr_check_range (mpc_imagref (res), iim, MPC_RND_IM (rnd));
+      inex = MPC_INEX (ire, iim);
+    }
+  else
+    inex = (y == NULL) ? mpc_sum (res, x, n, rnd) : mpc_dot (res, x, y, n, rnd);
+
+  for (j = 0; j < k; j++)
+    mpc_clear (s + j);
+  mpc_clear (r);
+  mpc_clear (t);
+  free (c);
+  free (s);
+  free (s_re);
+  free (inex_re);
+#ifdef HAVE_PTHREAD
+  free (tid);
+  free (started);
+#endif
+  return inex;
+}
+
+int
+mpc_sum_mt (mpc_ptr sum, const mpc_ptr *z, unsigned long n, mpc_rnd_t rnd,
+            unsigned int threads)
+{
+  return mt_eval (sum, z, NULL, n, rnd, threads);
+}
+
+int
+mpc_dot_mt (mpc_ptr res, const mpc_ptr *x, const mpc_ptr *y,
+            unsigned long n, mpc_rnd_t rnd, unsigned int threads)
+{
+  return mt_eval (res, x, y, n, rnd, threads);
+}
@@ -18,7 +18,6 @@ You should have received a copy of the GNU Lesser General Public License
 along with this program. If not, see http://www.gnu.org/licenses/ .
 */
 
-#include <stdio.h>    /* for MPC_ASSERT */
 #include <limits.h>
 #include "mpc-impl.h"
 
@@ -56,41 +55,12 @@ tan_im_cmp_one (mpc_srcptr op)
   return ret;
 }
 
-/* special case where the real part of tan(op) underflows to 0:
-   return 1 if 0 < Re(tan(op)) < 2^(emin-2),
-   -1 if -2^(emin-2) < Re(tan(op))| < 0, and 0 if we can't decide.
-   The real part is sin(2*x)/(cos(2*x) + cosh(2*y)) where op = (x,y),
-   thus has the sign of sin(2*x).
-*/
-static int
-tan_re_cmp_zero (mpc_srcptr op, mpfr_exp_t emin)
-{
-  mpfr_t x, s, c;
-  int ret = 0;
-
-  mpfr_init2 (x, mpfr_get_prec (mpc_realref (op)));
-  mpfr_mul_2exp (x, mpc_realref (op), 1, MPFR_RNDN);
-  mpfr_init2 (s, 32);
-  mpfr_init2 (c, 32);
-  mpfr_sin (s, x, MPFR_RNDA);
-  mpfr_mul_2exp (x, mpc_imagref (op), 1, MPFR_RNDN);
-  mpfr_cosh (c, x, MPFR_RNDZ);
-  mpfr_sub_ui (c, c, 1, MPFR_RNDZ);
-  mpfr_div (s, s, c, MPFR_RNDA);
-  if (mpfr_zero_p (s) || mpfr_get_exp (s) <= emin - 2)
-    ret = mpfr_sgn (s);
-  mpfr_clear (s);
-  mpfr_clear (c);
-  mpfr_clear (x);
-  return ret;
-}
-
 int
 mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 {
   mpc_t x, y;
+  mpfr_t d;
   mpfr_prec_t prec;
-  mpfr_exp_t err;
   int ok;
   int inex, inex_re, inex_im;
   mpfr_exp_t saved_emin, saved_emax;
@@ -217,81 +187,84 @@ mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
 
   /* ordinary (non-zero) numbers */
 
-  /* tan(op) = sin(op) / cos(op).
+  /* With op = a + i*b, we use the formula of glibc
+
+     tan(op) = (sin(a)*cos(a) + i*sinh(b)*cosh(b)) / (cos(a)^2 + sinh(b)^2),
 
-     We use the following algorithm with rounding away from 0 for all
-     operations, and working precision w:
+     whose denominator is a sum of non-negative terms, so that no
+     cancellation occurs. With all operations rounded to nearest at
+     working precision w:
 
-     (1) x = A(sin(op))
-     (2) y = A(cos(op))
-     (3) z = A(x/y)
+     (1) s = o(sin(a)), c = o(cos(a)), sh = o(sinh(b)), ch = o(cosh(b))
+     (2) d = o(c*c + sh*sh)
+     (3) Re(x) = o(o(s*c) / d), Im(x) = o(o(sh*ch) / d)
 
-     the error on Im(z) is at most 81 ulp,
-     the error on Re(z) is at most
-     7 ulp if k < 2,
-     8 ulp if k = 2,
-     else 5+k ulp, where
-     k = Exp(Re(x))+Exp(Re(y))-2min{Exp(Re(y)), Exp(Im(y))}-Exp(Re(x/y))
-     see proof in algorithms.tex.
-  */
+     each part of x has an error of at most 2^4 ulp, see
+     algorithms.tex. Since a and b are non-zero, none of sin(a), cos(a),
+     sinh(b) and cosh(b) is zero. */
 
   prec = MPC_MAX_PREC(rop);
 
-  mpc_init2 (x, 2);
-  mpc_init2 (y, 2);
+  mpc_pool_init2 (x, 2);
+  mpc_pool_init2 (y, 2);
+  mpc_pool_fr_init2 (d, 2);
 
-  err = 7;
+  prec += mpc_ceil_log2 (prec) + 6;
 
   do
     {
-      mpfr_exp_t k, exr, eyr, eyi, ezr;
-
-      ok = 0;
-
-      /* FIXME: prevent addition overflow */
-      prec += mpc_ceil_log2 (prec) + err;
-      mpc_set_prec (x, prec);
-      mpc_set_prec (y, prec);
-
-      /* rounding away from zero: except in the cases x=0 or y=0 (processed
-         above), sin x and cos y are never exact, so rounding away from 0 is
-         rounding towards 0 and adding one ulp to the absolute value */
-      mpc_sin_cos (x, y, op, MPC_RNDZZ, MPC_RNDZZ);
-      MPFR_ADD_ONE_ULP (mpc_realref (x));
-      MPFR_ADD_ONE_ULP (mpc_imagref (x));
-      MPFR_ADD_ONE_ULP (mpc_realref (y));
-      MPFR_ADD_ONE_ULP (mpc_imagref (y));
-
-
-      if (   mpfr_inf_p (mpc_realref (x)) || mpfr_inf_p (mpc_imagref (x))
-          || mpfr_inf_p (mpc_realref (y)) || mpfr_inf_p (mpc_imagref (y))) {
-         /* If the real or imaginary part of x is infinite, it means that
-            Im(op) was large, in which case the result is
+      mpc_pool_set_prec (x, prec);
+      mpc_pool_set_prec (y, prec);
+      mpc_pool_fr_set_prec (d, prec);
+
+      mpfr_sin_cos (mpc_realref (x), mpc_imagref (x), mpc_realref (op),
+                    MPFR_RNDN);
+      mpfr_sinh_cosh (mpc_realref (y), mpc_imagref (y), mpc_imagref (op),
+                      MPFR_RNDN);
+      mpfr_fmma (d, mpc_imagref (x), mpc_imagref (x),
+                 mpc_realref (y), mpc_realref (y), MPFR_RNDN);
+
+      if (mpfr_inf_p (d)) {
+         /* Then |Im(op)| > 2^60, in which case the result is
             sign(tan(Re(op)))*0 + sign(Im(op))*I,
-            where sign(tan(Re(op))) = sign(Re(x))*sign(Re(y)). */
+            where sign(tan(Re(op))) = sign(sin(Re(op)))*sign(cos(Re(op))).
+            The imaginary part is +/-1 up to exp(-2|Im(op)|), on the side
+            given by tan_im_cmp_one; op is read before rop is written,
+            since they may be the same variable. */
+          ok = tan_im_cmp_one (op);
+          inex_im = mpfr_sgn (mpc_imagref (op));
           mpfr_set_ui (mpc_realref (rop), 0, MPFR_RNDN);
-          if (mpfr_sgn (mpc_realref (x)) * mpfr_sgn (mpc_realref (y)) < 0)
+          if (mpfr_sgn (mpc_realref (x)) * mpfr_sgn (mpc_imagref (x)) < 0)
             {
               mpfr_neg (mpc_realref (rop), mpc_realref (rop), MPFR_RNDN);
               inex_re = 1;
             }
           else
             inex_re = -1; /* +0 is rounded down */
-          if (mpfr_sgn (mpc_imagref (op)) > 0)
+          mpfr_set_si (mpc_imagref (rop), inex_im, MPFR_RNDN);
+          if (ok < 0)
             {
-              mpfr_set_ui (mpc_imagref (rop), 1, MPFR_RNDN);
-              inex_im = 1;
+              /* |Im(tan(op))| < 1: fix the imaginary part if rounding is
+                 toward zero */
+              if (MPC_IS_LIKE_RNDZ(MPC_RND_IM(rnd),
+                                   MPFR_SIGNBIT(mpc_imagref (rop))))
+                {
+                  MPFR_SUB_ONE_ULP (mpc_imagref (rop));
+                  inex_im = -inex_im;
+                }
             }
           else
             {
-              mpfr_set_si (mpc_imagref (rop), -1, MPFR_RNDN);
-              inex_im = -1;
-            }
-          /* if rounding is toward zero, fix the imaginary part */
-          if (MPC_IS_LIKE_RNDZ(MPC_RND_IM(rnd), MPFR_SIGNBIT(mpc_imagref (rop))))
-            {
-              mpfr_nexttoward (mpc_imagref (rop), mpc_realref (rop));
+              /* |Im(tan(op))| > 1: fix the imaginary part if rounding is
+                 away from zero */
               inex_im = -inex_im;
+              if (MPC_RND_IM(rnd) != MPFR_RNDN
+                  && !MPC_IS_LIKE_RNDZ(MPC_RND_IM(rnd),
+                                       MPFR_SIGNBIT(mpc_imagref (rop))))
+                {
+                  MPFR_ADD_ONE_ULP (mpc_imagref (rop));
+                  inex_im = -inex_im;
+                }
             }
           if (mpfr_zero_p (mpc_realref (rop)))
             inex_re = mpc_fix_zero (mpc_realref (rop), MPC_RND_RE(rnd));
@@ -301,58 +274,20 @@ mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
           goto end;
         }
 
-      exr = mpfr_get_exp (mpc_realref (x));
-      eyr = mpfr_get_exp (mpc_realref (y));
-      eyi = mpfr_get_exp (mpc_imagref (y));
-
-      /* some parts of the quotient may be exact */
-      inex = mpc_div (x, x, y, MPC_RNDZZ);
-      /* OP is no pure real nor pure imaginary, so in theory the real and
-         imaginary parts of its tangent cannot be null. However due to
-         rounding errors this might happen. Consider for example
-         tan(1+14*I) = 1.26e-10 + 1.00*I. For small precision sin(op) and
-         cos(op) differ only by a factor I, thus after mpc_div x = I and
-         its real part is zero. */
-      if (mpfr_zero_p (mpc_realref (x)))
-        {
-          /* since we use an extended exponent range, if real(x) is zero,
-             this means the real part underflows, and we assume we can round */
-          ok = tan_re_cmp_zero (op, saved_emin);
-          if (ok > 0)
-            MPFR_ADD_ONE_ULP (mpc_realref (x));
-          else
-            MPFR_SUB_ONE_ULP (mpc_realref (x));
-        }
-      else
-        {
-          if (MPC_INEX_RE (inex))
-            MPFR_ADD_ONE_ULP (mpc_realref (x));
-          MPC_ASSERT (mpfr_zero_p (mpc_realref (x)) == 0);
-          ezr = mpfr_get_exp (mpc_realref (x));
-
-          /* FIXME: compute
-             k = Exp(Re(x))+Exp(Re(y))-2min{Exp(Re(y)), Exp(Im(y))}-Exp(Re(x/y))
-             avoiding overflow */
-          k = exr - ezr + MPC_MAX(-eyr, eyr - 2 * eyi);
-          err = k < 2 ? 7 : (k == 2 ? 8 : (5 + k));
-
-          /* Can the real part be rounded? */
-          ok = (!mpfr_number_p (mpc_realref (x)))
-            || mpfr_can_round (mpc_realref(x), prec - err, MPFR_RNDN, MPFR_RNDZ,
-                               MPC_PREC_RE(rop) + (MPC_RND_RE(rnd) == MPFR_RNDN));
-        }
+      mpfr_mul (mpc_realref (x), mpc_realref (x), mpc_imagref (x), MPFR_RNDN);
+      mpfr_div (mpc_realref (x), mpc_realref (x), d, MPFR_RNDN);
+      mpfr_mul (mpc_imagref (x), mpc_realref (y), mpc_imagref (y), MPFR_RNDN);
+      mpfr_div (mpc_imagref (x), mpc_imagref (x), d, MPFR_RNDN);
 
+      ok = mpfr_can_round (mpc_realref (x), prec - 4, MPFR_RNDN, MPFR_RNDZ,
+                           MPC_PREC_RE(rop) + (MPC_RND_RE(rnd) == MPFR_RNDN));
       if (ok)
         {
-          if (MPC_INEX_IM (inex))
-            MPFR_ADD_ONE_ULP (mpc_imagref (x));
-
-          /* Can the imaginary part be rounded? */
-          ok = (!mpfr_number_p (mpc_imagref (x)))
-            || mpfr_can_round (mpc_imagref(x), prec - 6, MPFR_RNDN, MPFR_RNDZ,
-                            MPC_PREC_IM(rop) + (MPC_RND_IM(rnd) == MPFR_RNDN));
+          ok = mpfr_can_round (mpc_imagref (x), prec - 4, MPFR_RNDN,
+                               MPFR_RNDZ, MPC_PREC_IM(rop)
+                               + (MPC_RND_IM(rnd) == MPFR_RNDN));
 
-          /* Special case when Im(x) = +/- 1:
+          /* Special case when Im(tan(op)) is near +/- 1:
              tan z = [sin(2x)+i*sinh(2y)] / [cos(2x) + cosh(2y)]
              (formula 4.3.57 of Abramowitz and Stegun) thus for y large
              in absolute value the imaginary part is near -1 or +1.
@@ -363,15 +298,18 @@ mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
              Since |tanh(2y)| = (1-exp(-4|y|))/(1+exp(-4|y|)),
              we have 1-|tanh(2y)| < 2*exp(-4|y|).
              Thus |im(z)-1| < 2/exp|2y| + 2/exp|4y| < 4/exp|2y| < 4/2^|2y|.
-             If 2^EXP(y) >= p+2, then im(z) rounds to -1 or 1. */
-          if (ok == 0 && (mpfr_cmp_ui (mpc_imagref(x), 1) == 0 ||
-                          mpfr_cmp_si (mpc_imagref(x), -1) == 0) &&
-              mpfr_get_exp (mpc_imagref(op)) >= 0 &&
+             If 2^EXP(y) >= p+2, then im(z) rounds to -1 or 1, or to the
+             neighbour of -1 or 1 of smaller absolute value, and the
+             comparison of |im(z)| with 1 decides. */
+          if (ok == 0 && mpfr_get_exp (mpc_imagref(op)) >= 0 &&
               ((size_t) mpfr_get_exp (mpc_imagref(op)) >= 8 * sizeof (mpfr_prec_t) ||
                ((mpfr_prec_t) 1) << mpfr_get_exp (mpc_imagref(op)) >= mpfr_get_prec (mpc_imagref (rop)) + 2))
             {
-              /* subtract one ulp, so that we get the correct inexact flag */
+              /* replace Im(x) by +/-1 shifted by one ulp towards Im(z),
+                 so that we get the correct inexact flag */
               ok = tan_im_cmp_one (op);
+              mpfr_set_si (mpc_imagref (x), mpfr_sgn (mpc_imagref (op)),
+                           MPFR_RNDN);
               if (ok < 0)
                 MPFR_SUB_ONE_ULP (mpc_imagref(x));
               else if (ok > 0)
@@ -387,8 +325,9 @@ mpc_tan (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd)
   inex = mpc_set (rop, x, rnd);
 
  end:
-  mpc_clear (x);
-  mpc_clear (y);
+  mpc_pool_clear (x);
+  mpc_pool_clear (y);
+  mpc_pool_fr_clear (d);
 
   /* restore the exponent range, and check the range of results */
   mpfr_set_emin (saved_emin);
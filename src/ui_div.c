@@ -1,6 +1,6 @@
 /* mpc_ui_div -- Divide an unsigned long int by a complex number.
 
-Copyright (C) 2002, 2009 INRIA
+Copyright (C) 2002, 2009, 2020 INRIA
 
 This file is part of GNU MPC.
 
@@ -27,6 +27,9 @@ mpc_ui_div (mpc_ptr a, unsigned long int b, mpc_srcptr c, mpc_rnd_t rnd)
   int inex;
   mpc_t bb;
 
+  if (b == 1)
+    return mpc_inv (a, c, rnd);
+
   mpc_init2 (bb, sizeof(unsigned long int) * CHAR_BIT);
   mpc_set_ui (bb, b, rnd); /* exact */
   inex = mpc_div (a, bb, c, rnd);
@@ -0,0 +1,290 @@
+/* mpc_vec -- Elementwise functions on arrays of complex numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+/* The functions in this file apply a function to the n elements
+   rop + i, op + i of arrays of mpc_t, and store the ternary value of
+   element i into inex [i] when inex is not NULL. An element of rop may be
+   the same variable as the element of the same index of an operand, but
+   must not overlap with any other element of the operands.
+
+   For the arithmetic functions, the scalar code has no setup that can be
+   shared between elements, and the loop merely saves the function calls
+   of the user. For the transcendental functions, the exponent range is
+   extended and the temporaries are obtained once for the whole array; the
+   ranges of the results are checked in a second sweep, after the exponent
+   range has been restored. */
+
+#define MPC_VEC_SPECIAL (-1) /* marks elements left for the second sweep */
+
+void
+mpc_vec_add (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, unsigned long n,
+             int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  int inex_i;
+
+  for (i = 0; i < n; i++)
+    {
+      inex_i = mpc_add (rop + i, op1 + i, op2 + i, rnd);
+      if (inex != NULL)
+        inex [i] = inex_i;
+    }
+}
+
+void
+mpc_vec_sub (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, unsigned long n,
+             int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  int inex_i;
+
+  for (i = 0; i < n; i++)
+    {
+      inex_i = mpc_sub (rop + i, op1 + i, op2 + i, rnd);
+      if (inex != NULL)
+        inex [i] = inex_i;
+    }
+}
+
+void
+mpc_vec_mul (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, unsigned long n,
+             int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  int inex_i;
+
+  for (i = 0; i < n; i++)
+    {
+      inex_i = mpc_mul (rop + i, op1 + i, op2 + i, rnd);
+      if (inex != NULL)
+        inex [i] = inex_i;
+    }
+}
+
+void
+mpc_vec_sqr (mpc_ptr rop, mpc_srcptr op, unsigned long n, int *inex,
+             mpc_rnd_t rnd)
+{
+  unsigned long i;
+  int inex_i;
+
+  for (i = 0; i < n; i++)
+    {
+      inex_i = mpc_sqr (rop + i, op + i, rnd);
+      if (inex != NULL)
+        inex [i] = inex_i;
+    }
+}
+
+void
+mpc_vec_fma (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_srcptr op3,
+             unsigned long n, int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  int inex_i;
+
+  for (i = 0; i < n; i++)
+    {
+      inex_i = mpc_fma (rop + i, op1 + i, op2 + i, op3 + i, rnd);
+      if (inex != NULL)
+        inex [i] = inex_i;
+    }
+}
+
+void
+mpc_vec_div (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, unsigned long n,
+             int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  int inex_i;
+
+  for (i = 0; i < n; i++)
+    {
+      inex_i = mpc_div (rop + i, op1 + i, op2 + i, rnd);
+      if (inex != NULL)
+        inex [i] = inex_i;
+    }
+}
+
+/* return an array for the ternary values of n elements: inex itself if it
+   is not NULL, a temporary block otherwise */
+static int *
+vec_inex_get (int *inex, unsigned long n)
+{
+  if (inex != NULL)
+    return inex;
+  return (int *) mpc_pool_alloc (n * sizeof (int));
+}
+
+static void
+vec_inex_put (int *t, int *inex, unsigned long n)
+{
+  if (t != inex)
+    mpc_pool_free (t, n * sizeof (int));
+}
+
+void
+mpc_vec_exp (mpc_ptr rop, mpc_srcptr op, unsigned long n, int *inex,
+             mpc_rnd_t rnd)
+{
+  mpfr_t x, y, z;
+  int *t;
+  int inex_re, inex_im;
+  int underflow, overflow;
+  mpfr_exp_t saved_emin, saved_emax;
+  unsigned long i;
+
+  if (n == 0)
+    return;
+  t = vec_inex_get (inex, n);
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  mpc_pool_fr_init2 (x, 2);
+  mpc_pool_fr_init2 (y, 2);
+  mpc_pool_fr_init2 (z, 2);
+
+  /* mpc_exp_regular overwrites the underflow and overflow flags, so
+     accumulate them over the elements */
+  underflow = mpfr_underflow_p ();
+  overflow = mpfr_overflow_p ();
+
+  for (i = 0; i < n; i++)
+    if (mpfr_regular_p (mpc_realref (op + i))
+        && mpfr_regular_p (mpc_imagref (op + i)))
+      {
+        t [i] = mpc_exp_regular (rop + i, op + i, rnd, x, y, z);
+        underflow |= mpfr_underflow_p ();
+        overflow |= mpfr_overflow_p ();
+      }
+    else
+      t [i] = MPC_VEC_SPECIAL;
+
+  mpc_pool_fr_clear (x);
+  mpc_pool_fr_clear (y);
+  mpc_pool_fr_clear (z);
+
+  if (underflow)
+    mpfr_set_underflow ();
+  if (overflow)
+    mpfr_set_overflow ();
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+
+  for (i = 0; i < n; i++)
+    if (t [i] == MPC_VEC_SPECIAL)
+      t [i] = mpc_exp (rop + i, op + i, rnd);
+    else
+      {
+        inex_re = mpfr_check_range (mpc_realref (rop + i), MPC_INEX_RE (t [i]),
+                                    MPC_RND_RE (rnd));
+        inex_im = mpfr_check_range (mpc_imagref (rop + i), MPC_INEX_IM (t [i]),
+                                    MPC_RND_IM (rnd));
+        t [i] = MPC_INEX (inex_re, inex_im);
+      }
+
+  vec_inex_put (t, inex, n);
+}
+
+/* Compute sin(op + i) into rop_sin + i and cos(op + i) into rop_cos + i;
+   the ternary values are stored as for mpc_sin_cos. As for mpc_sin_cos,
+   one of rop_sin and rop_cos may be NULL. */
+void
+mpc_vec_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
+                 unsigned long n, int *inex,
+                 mpc_rnd_t rnd_sin, mpc_rnd_t rnd_cos)
+{
+  mpfr_t tmp [6];
+  int *t;
+  int inex_re, inex_im, inex_sin, inex_cos, k;
+  mpc_ptr s, c;
+  mpfr_exp_t saved_emin, saved_emax;
+  unsigned long i;
+
+  if (n == 0)
+    return;
+  t = vec_inex_get (inex, n);
+
+  saved_emin = mpfr_get_emin ();
+  saved_emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+
+  for (k = 0; k < 6; k++)
+    mpc_pool_fr_init2 (tmp [k], 2);
+
+  for (i = 0; i < n; i++)
+    if (mpfr_regular_p (mpc_realref (op + i))
+        && mpfr_regular_p (mpc_imagref (op + i)))
+      {
+        s = (rop_sin == NULL) ? NULL : rop_sin + i;
+        c = (rop_cos == NULL) ? NULL : rop_cos + i;
+        t [i] = mpc_sin_cos_regular (s, c, op + i, rnd_sin, rnd_cos, tmp);
+      }
+    else
+      t [i] = MPC_VEC_SPECIAL;
+
+  for (k = 0; k < 6; k++)
+    mpc_pool_fr_clear (tmp [k]);
+
+  mpfr_set_emin (saved_emin);
+  mpfr_set_emax (saved_emax);
+
+  for (i = 0; i < n; i++)
+    {
+      s = (rop_sin == NULL) ? NULL : rop_sin + i;
+      c = (rop_cos == NULL) ? NULL : rop_cos + i;
+      if (t [i] == MPC_VEC_SPECIAL)
+        t [i] = mpc_sin_cos (s, c, op + i, rnd_sin, rnd_cos);
+      else
+        {
+          inex_sin = MPC_INEX1 (t [i]);
+          inex_cos = MPC_INEX2 (t [i]);
+          if (s != NULL)
+            {
+              inex_re = mpfr_check_range (mpc_realref (s),
+                                          MPC_INEX_RE (inex_sin),
+                                          MPC_RND_RE (rnd_sin));
+              inex_im = mpfr_check_range (mpc_imagref (s),
+                                          MPC_INEX_IM (inex_sin),
+                                          MPC_RND_IM (rnd_sin));
+              inex_sin = MPC_INEX (inex_re, inex_im);
+            }
+          if (c != NULL)
+            {
+              inex_re = mpfr_check_range (mpc_realref (c),
+                                          MPC_INEX_RE (inex_cos),
+                                          MPC_RND_RE (rnd_cos));
+              inex_im = mpfr_check_range (mpc_imagref (c),
+                                          MPC_INEX_IM (inex_cos),
+                                          MPC_RND_IM (rnd_cos));
+              inex_cos = MPC_INEX (inex_re, inex_im);
+            }
+          t [i] = MPC_INEX12 (inex_sin, inex_cos);
+        }
+    }
+
+  vec_inex_put (t, inex, n);
+}
@@ -0,0 +1,67 @@
+/* mpc_vec_init2, mpc_vec_clear -- Initialize or free a vector of complex
+   numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+void
+mpc_vec_init2 (mpc_vec_ptr v, unsigned long n, mpfr_prec_t prec)
+{
+  void * (*allocfunc) (size_t);
+  size_t limbs = MPC_VEC_LIMBS (prec);
+  unsigned long i;
+
+  mp_get_memory_functions (&allocfunc, NULL, NULL);
+  v->size = n;
+  v->prec = prec;
+  if (n == 0)
+    n = 1; /* avoid allocating empty blocks */
+  v->re_d = (mp_limb_t *) (*allocfunc) (n * limbs * sizeof (mp_limb_t));
+  v->im_d = (mp_limb_t *) (*allocfunc) (n * limbs * sizeof (mp_limb_t));
+  v->re_exp = (mpfr_exp_t *) (*allocfunc) (n * sizeof (mpfr_exp_t));
+  v->im_exp = (mpfr_exp_t *) (*allocfunc) (n * sizeof (mpfr_exp_t));
+  v->re_kind = (signed char *) (*allocfunc) (n);
+  v->im_kind = (signed char *) (*allocfunc) (n);
+
+  /* as mpc_init2, set all elements to NaN */
+  for (i = 0; i < v->size; i++)
+    {
+      v->re_kind [i] = MPFR_NAN_KIND;
+      v->im_kind [i] = MPFR_NAN_KIND;
+      v->re_exp [i] = 0;
+      v->im_exp [i] = 0;
+    }
+}
+
+void
+mpc_vec_clear (mpc_vec_ptr v)
+{
+  void (*freefunc) (void *, size_t);
+  size_t limbs = MPC_VEC_LIMBS (v->prec);
+  unsigned long n = (v->size == 0) ? 1 : v->size;
+
+  mp_get_memory_functions (NULL, NULL, &freefunc);
+  (*freefunc) (v->re_d, n * limbs * sizeof (mp_limb_t));
+  (*freefunc) (v->im_d, n * limbs * sizeof (mp_limb_t));
+  (*freefunc) (v->re_exp, n * sizeof (mpfr_exp_t));
+  (*freefunc) (v->im_exp, n * sizeof (mpfr_exp_t));
+  (*freefunc) (v->re_kind, n);
+  (*freefunc) (v->im_kind, n);
+}
@@ -0,0 +1,201 @@
+/* mpc_vec_view, mpc_vec_store, mpc_vec_get, mpc_vec_set -- Access the
+   elements of a vector of complex numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdio.h> /* for MPC_ASSERT */
+#include "mpc-impl.h"
+
+/* A view of element i is an mpc_t whose parts are MPFR custom variables
+   pointing into the significand slabs of the vector. Operations on the view
+   write the significands in place; only the kinds and exponents, which
+   live in the mpfr structures of the view, need to be stored back. */
+
+static void
+vec_fr_store (mpc_vec_srcptr v, mp_limb_t *d, signed char *kind,
+              mpfr_exp_t *exp, mpfr_srcptr x)
+{
+  mpfr_t y;
+
+  if (mpfr_custom_get_significand (x) != (void *) d
+      || mpfr_get_prec (x) != v->prec)
+    /* not a view of this element: copy the value */
+    {
+      mpfr_custom_init_set (y, MPFR_NAN_KIND, 0, v->prec, d);
+      mpfr_set (y, x, MPFR_RNDN);
+      x = y;
+    }
+  *kind = (signed char) mpfr_custom_get_kind (x);
+  *exp = mpfr_regular_p (x) ? mpfr_custom_get_exp (x) : 0;
+}
+
+/* return non-zero if z is a view of element i of v whose parts have been
+   exchanged */
+static int
+vec_exchanged (mpc_vec_srcptr v, unsigned long i, mpc_srcptr z)
+{
+  size_t limbs = MPC_VEC_LIMBS (v->prec);
+
+  return mpfr_custom_get_significand (mpc_realref (z))
+         == (void *) (v->im_d + i * limbs)
+         && mpfr_custom_get_significand (mpc_imagref (z))
+            == (void *) (v->re_d + i * limbs)
+         && mpfr_get_prec (mpc_realref (z)) == v->prec
+         && mpfr_get_prec (mpc_imagref (z)) == v->prec;
+}
+
+/* return non-zero if the real part (j = 0) or imaginary part (j = 1) of z,
+   to be stored into element i of v, has its significand in one of the slabs
+   of v at another place, which may be overwritten before it is read; this
+   excludes views whose parts have been exchanged */
+static int
+vec_elsewhere (mpc_vec_srcptr v, unsigned long i, mpc_srcptr z, int j)
+{
+  size_t limbs = MPC_VEC_LIMBS (v->prec), len = v->size * limbs;
+  mpfr_srcptr x = (j == 0) ? mpc_realref (z) : mpc_imagref (z);
+  const mp_limb_t *p = (const mp_limb_t *) mpfr_custom_get_significand (x);
+  const mp_limb_t *d = ((j == 0) ? v->re_d : v->im_d) + i * limbs;
+
+  return p != d && !vec_exchanged (v, i, z)
+         && ((p >= v->re_d && p < v->re_d + len)
+             || (p >= v->im_d && p < v->im_d + len));
+}
+
+/* Make the n consecutive variables z, z + 1, ..., z + n - 1 views of the
+   elements i, i + 1, ..., i + n - 1 of v. */
+void
+mpc_vec_view (mpc_ptr z, mpc_vec_srcptr v, unsigned long i, unsigned long n)
+{
+  size_t limbs = MPC_VEC_LIMBS (v->prec);
+  unsigned long k;
+
+  MPC_ASSERT (i <= v->size && n <= v->size - i);
+  for (k = 0; k < n; k++, i++)
+    {
+      mpfr_custom_init_set (mpc_realref (z + k), v->re_kind [i],
+                            v->re_exp [i], v->prec, v->re_d + i * limbs);
+      mpfr_custom_init_set (mpc_imagref (z + k), v->im_kind [i],
+                            v->im_exp [i], v->prec, v->im_d + i * limbs);
+    }
+}
+
+/* Store z, z + 1, ..., z + n - 1 into the elements i, i + 1, ..., i + n - 1
+   of v. This is cheap when z + k is a view of element i + k; otherwise the
+   value of z + k is rounded to nearest to the precision of v. A part of
+   z + k may also be a view of another element, or of the other part of
+   element i + k, for instance when views are stored at shifted indices;
+   such parts are first copied into the temporaries t [2k] and t [2k + 1],
+   before any significand is overwritten. */
+void
+mpc_vec_store (mpc_vec_ptr v, unsigned long i, mpc_srcptr z, unsigned long n)
+{
+  size_t limbs = MPC_VEC_LIMBS (v->prec);
+  __mpfr_struct *t = NULL;
+  unsigned long k;
+  int j;
+
+  MPC_ASSERT (i <= v->size && n <= v->size - i);
+  for (k = 0; k < n && t == NULL; k++)
+    if (vec_elsewhere (v, i + k, z + k, 0)
+        || vec_elsewhere (v, i + k, z + k, 1))
+      {
+        void * (*allocfunc) (size_t);
+
+        mp_get_memory_functions (&allocfunc, NULL, NULL);
+        t = (__mpfr_struct *) (*allocfunc) (2 * n * sizeof (__mpfr_struct));
+      }
+  if (t != NULL)
+    for (k = 0; k < n; k++)
+      for (j = 0; j < 2; j++)
+        if (vec_elsewhere (v, i + k, z + k, j))
+          {
+            mpfr_srcptr x = (j == 0) ? mpc_realref (z + k)
+                                     : mpc_imagref (z + k);
+
+            mpfr_init2 (t + 2 * k + j, mpfr_get_prec (x));
+            mpfr_set (t + 2 * k + j, x, MPFR_RNDN);
+          }
+
+  for (k = 0; k < n; k++)
+    {
+      mp_limb_t *re_d = v->re_d + (i + k) * limbs;
+      mp_limb_t *im_d = v->im_d + (i + k) * limbs;
+      mpfr_srcptr x = mpc_realref (z + k), y = mpc_imagref (z + k);
+
+      if (vec_exchanged (v, i + k, z + k))
+        /* a view whose parts have been exchanged, for instance by mpc_mul_i
+           in place: exchange the significands in the slabs, and move the
+           parts of the view accordingly, which does not change its value */
+        {
+          size_t l;
+          mp_limb_t u;
+
+          for (l = 0; l < limbs; l++)
+            {
+              u = re_d [l];
+              re_d [l] = im_d [l];
+              im_d [l] = u;
+            }
+          mpfr_custom_move ((mpfr_ptr) x, re_d);
+          mpfr_custom_move ((mpfr_ptr) y, im_d);
+        }
+      else if (t != NULL)
+        {
+          if (vec_elsewhere (v, i + k, z + k, 0))
+            x = t + 2 * k;
+          if (vec_elsewhere (v, i + k, z + k, 1))
+            y = t + 2 * k + 1;
+        }
+      vec_fr_store (v, re_d, v->re_kind + i + k, v->re_exp + i + k, x);
+      vec_fr_store (v, im_d, v->im_kind + i + k, v->im_exp + i + k, y);
+    }
+
+  if (t != NULL)
+    {
+      void (*freefunc) (void *, size_t);
+
+      for (k = 0; k < n; k++)
+        for (j = 0; j < 2; j++)
+          if (vec_elsewhere (v, i + k, z + k, j))
+            mpfr_clear (t + 2 * k + j);
+      mp_get_memory_functions (NULL, NULL, &freefunc);
+      (*freefunc) (t, 2 * n * sizeof (__mpfr_struct));
+    }
+}
+
+int
+mpc_vec_get (mpc_ptr rop, mpc_vec_srcptr v, unsigned long i, mpc_rnd_t rnd)
+{
+  mpc_t z;
+
+  mpc_vec_view (z, v, i, 1);
+  return mpc_set (rop, z, rnd);
+}
+
+int
+mpc_vec_set (mpc_vec_ptr v, unsigned long i, mpc_srcptr op, mpc_rnd_t rnd)
+{
+  mpc_t z;
+  int inex;
+
+  mpc_vec_view (z, v, i, 1);
+  inex = mpc_set (z, op, rnd);
+  mpc_vec_store (v, i, z, 1);
+  return inex;
+}
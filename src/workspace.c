@@ -0,0 +1,108 @@
+/* mpc_*_ws -- Functions using the memory of a workspace for temporaries.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-impl.h"
+
+int
+mpc_mul_ws (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_rnd_t rnd,
+            mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_mul (rop, op1, op2, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_div_ws (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_rnd_t rnd,
+            mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_div (rop, op1, op2, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_exp_ws (mpc_ptr rop, mpc_srcptr op, mpc_rnd_t rnd, mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_exp (rop, op, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_sin_cos_ws (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
+                mpc_rnd_t rnd_sin, mpc_rnd_t rnd_cos, mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_sin_cos (rop_sin, rop_cos, op, rnd_sin, rnd_cos);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_pow_ws (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, mpc_rnd_t rnd,
+            mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_pow (rop, op1, op2, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_pow_ui_ws (mpc_ptr rop, mpc_srcptr op1, unsigned long op2, mpc_rnd_t rnd,
+               mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_pow_usi (rop, op1, op2, 1, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_pow_si_ws (mpc_ptr rop, mpc_srcptr op1, long op2, mpc_rnd_t rnd,
+               mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_pow_si (rop, op1, op2, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
+
+int
+mpc_dot_ws (mpc_ptr res, const mpc_ptr *x, const mpc_ptr *y,
+            unsigned long n, mpc_rnd_t rnd, mpc_workspace_ptr ws)
+{
+  void *old = mpc_workspace_enter (ws);
+  int inex = mpc_dot (res, x, y, n, rnd);
+
+  mpc_workspace_leave (old);
+  return inex;
+}
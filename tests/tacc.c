@@ -0,0 +1,282 @@
+/* tacc -- test file for mpc_acc_init, mpc_acc_add, mpc_acc_add_mul,
+   mpc_acc_merge and mpc_acc_get.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+#define N 1000
+
+static void
+check_value (mpc_ptr got, int inex, mpc_ptr ref, int inex_ref,
+             const char *what)
+{
+  known_signs_t ks = {1, 1};
+
+  if (inex != inex_ref || !same_mpc_value (got, ref, ks))
+    {
+      printf ("Error in %s\n", what);
+      MPC_OUT (ref);
+      MPC_OUT (got);
+      printf ("inex = %d, expected %d\n", inex, inex_ref);
+      exit (1);
+    }
+}
+
+static void
+check_special (void)
+{
+  mpc_t z, res;
+  mpc_acc_t acc;
+  int inex;
+
+  mpc_init2 (z, 17);
+  mpc_init2 (res, 17);
+  mpc_acc_init (acc);
+
+  /* the empty sum is +0 */
+  mpc_set_nan (res);
+  inex = mpc_acc_get (res, acc, MPC_RNDDD);
+  MPC_ASSERT (inex == 0);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && !mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && !mpfr_signbit (mpc_imagref (res)));
+
+  /* -0 + -0 = -0 */
+  mpc_set_si_si (z, 0, 0, MPC_RNDNN);
+  mpc_neg (z, z, MPC_RNDNN);
+  mpc_acc_add (acc, z);
+  mpc_acc_add (acc, z);
+  mpc_acc_get (res, acc, MPC_RNDNN);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && mpfr_signbit (mpc_imagref (res)));
+
+  /* 1 - 1 = +0 when rounding to nearest, -0 when rounding downwards */
+  mpc_set_si_si (z, 1, -1, MPC_RNDNN);
+  mpc_acc_add (acc, z);
+  mpc_neg (z, z, MPC_RNDNN);
+  mpc_acc_add (acc, z);
+  mpc_acc_get (res, acc, MPC_RNDND);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && !mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && mpfr_signbit (mpc_imagref (res)));
+
+  /* +Inf - Inf = NaN in the real part, the imaginary part is exact */
+  mpfr_set_inf (mpc_realref (z), +1);
+  mpfr_set_ui (mpc_imagref (z), 3, MPFR_RNDN);
+  mpc_acc_add (acc, z);
+  mpfr_set_inf (mpc_realref (z), -1);
+  mpc_acc_add (acc, z);
+  inex = mpc_acc_get (res, acc, MPC_RNDNN);
+  MPC_ASSERT (inex == 0);
+  MPC_ASSERT (mpfr_nan_p (mpc_realref (res)));
+  MPC_ASSERT (mpfr_cmp_ui (mpc_imagref (res), 6) == 0);
+
+  mpc_acc_clear (acc);
+  mpc_clear (z);
+  mpc_clear (res);
+}
+
+/* an exact cancellation gives -0 when rounding downwards, also after the
+   terms have been collected, and after a merge */
+static void
+check_zero_sign (void)
+{
+  mpc_t z, res;
+  mpc_acc_t a, b;
+  int i;
+
+  mpc_init2 (z, 17);
+  mpc_init2 (res, 17);
+  mpc_acc_init (a);
+  mpc_acc_init (b);
+
+  /* 1+i - (1+i), collected by the addition of N terms +0 */
+  mpc_set_ui_ui (z, 1, 1, MPC_RNDNN);
+  mpc_acc_add (a, z);
+  mpc_neg (z, z, MPC_RNDNN);
+  mpc_acc_add (a, z);
+  mpc_set_ui_ui (z, 0, 0, MPC_RNDNN);
+  for (i = 0; i < N; i++)
+    mpc_acc_add (a, z);
+  mpc_acc_get (res, a, MPC_RNDDN);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && !mpfr_signbit (mpc_imagref (res)));
+
+  /* the same after a merge into an empty accumulator */
+  mpc_acc_merge (b, a);
+  mpc_acc_get (res, b, MPC_RNDND);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && !mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && mpfr_signbit (mpc_imagref (res)));
+  mpc_acc_merge (b, b);
+  mpc_acc_get (res, b, MPC_RNDDD);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && mpfr_signbit (mpc_imagref (res)));
+  mpc_acc_clear (b);
+
+  /* {1+i, -1-i} merged without any other term */
+  mpc_acc_clear (a);
+  mpc_acc_init (a);
+  mpc_acc_init (b);
+  mpc_set_ui_ui (z, 1, 1, MPC_RNDNN);
+  mpc_acc_add (a, z);
+  mpc_neg (z, z, MPC_RNDNN);
+  mpc_acc_add (a, z);
+  mpc_acc_get (res, a, MPC_RNDDD);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && mpfr_signbit (mpc_imagref (res)));
+  mpc_acc_merge (b, a);
+  mpc_acc_get (res, b, MPC_RNDDD);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && mpfr_signbit (mpc_imagref (res)));
+  mpc_acc_get (res, b, MPC_RNDUN);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && !mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && !mpfr_signbit (mpc_imagref (res)));
+
+  /* collected -0 terms stay -0, collected +0 terms stay +0 */
+  mpc_acc_clear (a);
+  mpc_acc_init (a);
+  mpc_set_si_si (z, 0, 0, MPC_RNDNN);
+  mpfr_neg (mpc_realref (z), mpc_realref (z), MPFR_RNDN);
+  for (i = 0; i < N; i++)
+    mpc_acc_add (a, z);
+  mpc_acc_get (res, a, MPC_RNDNN);
+  MPC_ASSERT (mpfr_zero_p (mpc_realref (res)) && mpfr_signbit (mpc_realref (res)));
+  MPC_ASSERT (mpfr_zero_p (mpc_imagref (res)) && !mpfr_signbit (mpc_imagref (res)));
+
+  mpc_acc_clear (a);
+  mpc_acc_clear (b);
+  mpc_clear (z);
+  mpc_clear (res);
+}
+
+/* compare the accumulation of terms and products with mpc_sum and mpc_dot,
+   with terms of widely different magnitudes cancelling each other, so
+   that the exact sum spans many more bits than the terms, and with the
+   stream split between two accumulators which are merged */
+static void
+check_random (void)
+{
+  mpc_t z[N], res, ref;
+  mpc_ptr t[N], u[N];
+  mpc_acc_t acc, acc2;
+  mpfr_prec_t prec;
+  mpc_rnd_t rnd;
+  int i, r, split, inex, inex_ref;
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_init2 (z[i], 2);
+      t[i] = z[i];
+      u[i] = z[N - 1 - i];
+    }
+  for (prec = 2; prec <= 300; prec += 149)
+    {
+      mpc_init2 (res, prec);
+      mpc_init2 (ref, prec);
+      for (i = 0; i < N; i++)
+        {
+          mpc_set_prec (z[i], prec + (i % 7));
+          test_default_random (z[i], -200, 200, 128, 25);
+        }
+      /* a huge term and its opposite, far apart in the stream */
+      mpc_mul_2ui (z[3], z[3], 1000, MPC_RNDNN);
+      mpc_neg (z[N - 5], z[3], MPC_RNDNN);
+
+      for (r = 0; r < 4; r++)
+        {
+          rnd = MPC_RND (r, 3 - r);
+          for (split = 0; split <= N; split += N / 3 + 1)
+            {
+              mpc_acc_init (acc);
+              mpc_acc_init (acc2);
+              for (i = 0; i < N; i++)
+                mpc_acc_add ((i < split) ? acc2 : acc, z[i]);
+              mpc_acc_merge (acc, acc2);
+              inex_ref = mpc_sum (ref, t, N, rnd);
+              inex = mpc_acc_get (res, acc, rnd);
+              check_value (res, inex, ref, inex_ref, "mpc_acc_add");
+              mpc_acc_clear (acc);
+              mpc_acc_clear (acc2);
+
+              mpc_acc_init (acc);
+              mpc_acc_init (acc2);
+              for (i = 0; i < N; i++)
+                mpc_acc_add_mul ((i < split) ? acc2 : acc, z[i], z[N - 1 - i]);
+              mpc_acc_merge (acc2, acc);
+              inex_ref = mpc_dot (ref, t, u, N, rnd);
+              inex = mpc_acc_get (res, acc2, rnd);
+              check_value (res, inex, ref, inex_ref, "mpc_acc_add_mul");
+              /* merging an accumulator with itself doubles its value */
+              mpc_acc_merge (acc2, acc2);
+              mpc_mul_2ui (ref, ref, 1, MPC_RNDNN);
+              inex = mpc_acc_get (res, acc2, rnd);
+              check_value (res, inex, ref, inex_ref, "mpc_acc_merge");
+              mpc_acc_clear (acc);
+              mpc_acc_clear (acc2);
+            }
+        }
+      mpc_clear (res);
+      mpc_clear (ref);
+    }
+  for (i = 0; i < N; i++)
+    mpc_clear (z[i]);
+}
+
+/* a sum which overflows while terms are collected, but not in the end */
+static void
+check_range (void)
+{
+  mpc_t z, res;
+  mpc_acc_t acc;
+  mpfr_exp_t emax = mpfr_get_emax ();
+  int i, inex;
+
+  mpfr_set_emax (10);
+  mpc_init2 (z, 10);
+  mpc_init2 (res, 10);
+  mpc_acc_init (acc);
+  mpc_set_ui_ui (z, 1000, 1000, MPC_RNDNN);
+  for (i = 0; i < 1000; i++)
+    mpc_acc_add (acc, z);
+  mpc_set_si_si (z, -1000, -999, MPC_RNDNN);
+  for (i = 0; i < 1000; i++)
+    mpc_acc_add (acc, z);
+  inex = mpc_acc_get (res, acc, MPC_RNDNN);
+  MPC_ASSERT (inex == 0);
+  MPC_ASSERT (mpfr_cmp_ui (mpc_realref (res), 0) == 0);
+  MPC_ASSERT (mpfr_cmp_ui (mpc_imagref (res), 1000) == 0);
+  mpc_acc_clear (acc);
+  mpc_clear (z);
+  mpc_clear (res);
+  mpfr_set_emax (emax);
+}
+
+int
+main (void)
+{
+  test_start ();
+
+  check_special ();
+  check_zero_sign ();
+  check_random ();
+  check_range ();
+
+  test_end ();
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+/* tagm -- test file for mpc_agm.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+/* Check that AGM(a,b) = AGM(b,a) for random a and b; the arguments are
+   swapped inside mpc_agm so as to divide by the one of larger absolute
+   value, which must not have any effect on the result. */
+static void
+check_symmetry (void)
+{
+   mpc_t a, b, z1, z2;
+   mpfr_prec_t prec;
+   int i, inex1, inex2;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (z1, 2);
+   mpc_init2 (z2, 2);
+   for (prec = 2; prec <= 200; prec += 11)
+      for (i = 0; i < 10; i++) {
+         mpc_set_prec (a, prec);
+         mpc_set_prec (b, prec);
+         mpc_set_prec (z1, prec);
+         mpc_set_prec (z2, prec);
+         test_default_random (a, -20, 20, 128, 25);
+         test_default_random (b, -20, 20, 128, 25);
+         inex1 = mpc_agm (z1, a, b, MPC_RNDNN);
+         inex2 = mpc_agm (z2, b, a, MPC_RNDNN);
+         if (inex1 != inex2 || mpc_cmp (z1, z2) != 0) {
+            printf ("Error in mpc_agm: result not symmetric for\n");
+            MPC_OUT (a);
+            MPC_OUT (b);
+            MPC_OUT (z1);
+            MPC_OUT (z2);
+            exit (1);
+         }
+      }
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (z1);
+   mpc_clear (z2);
+}
+
+#define MPC_FUNCTION_CALL                                               \
+  P[0].mpc_inex = mpc_agm (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP1                                     \
+  P[0].mpc_inex = mpc_agm (P[1].mpc, P[1].mpc, P[3].mpc, P[4].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP2                                     \
+  P[0].mpc_inex = mpc_agm (P[1].mpc, P[2].mpc, P[1].mpc, P[4].mpc_rnd)
+
+#include "data_check.tpl"
+#include "tgeneric.tpl"
+
+int
+main (void)
+{
+  test_start ();
+
+  check_symmetry ();
+
+  data_check_template ("agm.dsc", "agm.dat");
+
+  tgeneric_template ("agm.dsc", 2, 1024, 7, 128);
+
+  test_end ();
+
+  return 0;
+}
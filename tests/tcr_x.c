@@ -0,0 +1,332 @@
+/* tcr_x -- Test file for the correctly rounded functions on C complex
+   numbers.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "config.h"
+#include <float.h>
+#include <math.h> /* for signbit */
+
+#ifdef HAVE_COMPLEX_H
+# include <complex.h>
+#endif
+
+#ifdef HAVE_MPFR_FLOAT128
+# define MPFR_WANT_FLOAT128
+#endif
+
+#include "mpc-tests.h"
+
+#ifdef HAVE_COMPLEX_H
+
+#define RE(T, z) (((T *) &(z)) [0])
+#define IM(T, z) (((T *) &(z)) [1])
+
+#ifdef HAVE_MPFR_FLOAT128
+#define FUN_F128(name) , mpc_cr_c ## name ## f128
+#else
+#define FUN_F128(name)
+#endif
+
+#define FUN(name)                                                       \
+  { #name, mpc_ ## name, mpc_cr_c ## name ## f, mpc_cr_c ## name,      \
+      mpc_cr_c ## name ## l FUN_F128 (name) }
+
+static struct {
+  const char *name;
+  int (*f) (mpc_ptr, mpc_srcptr, mpc_rnd_t);
+  float _Complex (*cr_f) (float _Complex);
+  double _Complex (*cr_d) (double _Complex);
+  long double _Complex (*cr_ld) (long double _Complex);
+#ifdef HAVE_MPFR_FLOAT128
+  _Float128 _Complex (*cr_f128) (_Float128 _Complex);
+#endif
+} funs [] = {
+  FUN (sqrt), FUN (exp), FUN (log), FUN (sin), FUN (cos), FUN (tan),
+  FUN (sinh), FUN (cosh), FUN (tanh), FUN (asin), FUN (acos), FUN (atan),
+  FUN (asinh), FUN (acosh), FUN (atanh)
+};
+
+#define NFUNS (sizeof (funs) / sizeof (funs [0]))
+
+/* return non-zero if the parts of ref are zero, infinite, NaN or normal
+   numbers of a format with exponents up to emax in absolute value */
+static int
+is_normal (mpc_srcptr ref, mpfr_exp_t emax)
+{
+  return (!mpfr_regular_p (mpc_realref (ref))
+          || (mpfr_get_exp (mpc_realref (ref)) > -emax
+              && mpfr_get_exp (mpc_realref (ref)) < emax))
+    && (!mpfr_regular_p (mpc_imagref (ref))
+        || (mpfr_get_exp (mpc_imagref (ref)) > -emax
+            && mpfr_get_exp (mpc_imagref (ref)) < emax));
+}
+
+static void
+check_result (const char *name, const char *type, mpc_ptr op,
+              mpc_ptr got, mpc_ptr ref)
+{
+  known_signs_t ks = {1, 1};
+
+  if (!same_mpc_value (got, ref, ks))
+    {
+      printf ("Error in mpc_cr_c%s for %s\n", name, type);
+      MPC_OUT (op);
+      MPC_OUT (got);
+      MPC_OUT (ref);
+      exit (1);
+    }
+}
+
+/* Compare the function of index i of funs on the C complex number of type
+   T converted from op, which has the precision of the format, with the
+   rounding of the corresponding GNU MPC function to nearest, when the
+   latter has normal parts. */
+#define CHECK_TYPE(T, type, cr, set, get, emax)                         \
+  {                                                                     \
+    T _Complex z, r;                                                    \
+    mpc_t got, ref;                                                     \
+                                                                        \
+    mpc_init2 (got, mpfr_get_prec (mpc_realref (op)));                  \
+    mpc_init2 (ref, mpfr_get_prec (mpc_realref (op)));                  \
+    RE (T, z) = get (mpc_realref (op), MPFR_RNDN);                      \
+    IM (T, z) = get (mpc_imagref (op), MPFR_RNDN);                      \
+    funs [i].f (ref, op, MPC_RNDNN);                                    \
+    if (is_normal (ref, emax))                                          \
+      {                                                                 \
+        r = funs [i].cr (z);                                            \
+        set (mpc_realref (got), RE (T, r), MPFR_RNDN);                  \
+        set (mpc_imagref (got), IM (T, r), MPFR_RNDN);                  \
+        check_result (funs [i].name, type, op, got, ref);               \
+      }                                                                 \
+    mpc_clear (got);                                                    \
+    mpc_clear (ref);                                                    \
+  }
+
+static void
+check_random (mpfr_prec_t prec, mpfr_exp_t exp_min, mpfr_exp_t exp_max,
+              unsigned int n)
+{
+  mpc_t op;
+  unsigned int i, k;
+
+  mpc_init2 (op, prec);
+  for (k = 0; k < n; k++)
+    {
+      test_default_random (op, exp_min, exp_max, 128, 16);
+      for (i = 0; i < NFUNS; i++)
+        {
+          if (prec == FLT_MANT_DIG)
+            CHECK_TYPE (float, "float", cr_f, mpfr_set_flt, mpfr_get_flt,
+                        FLT_MAX_EXP - 2);
+          if (prec == DBL_MANT_DIG)
+            CHECK_TYPE (double, "double", cr_d, mpfr_set_d, mpfr_get_d,
+                        DBL_MAX_EXP - 2);
+          if (prec == LDBL_MANT_DIG)
+            CHECK_TYPE (long double, "long double", cr_ld, mpfr_set_ld,
+                        mpfr_get_ld, LDBL_MAX_EXP - 2);
+#ifdef HAVE_MPFR_FLOAT128
+          if (prec == 113)
+            CHECK_TYPE (_Float128, "_Float128", cr_f128, mpfr_set_float128,
+                        mpfr_get_float128, 16382);
+#endif
+        }
+    }
+  mpc_clear (op);
+}
+
+/* check the square root on the operands of the double-double path */
+static void
+check_sqrt (void)
+{
+  mpc_t op, got, ref;
+  double _Complex z, r;
+  float _Complex zf, rf;
+  int k;
+
+  mpc_init2 (op, 53);
+  mpc_init2 (got, 53);
+  mpc_init2 (ref, 53);
+  for (k = 0; k < 10000; k++)
+    {
+      test_default_random (op, -300, 300, 128, 0);
+      RE (double, z) = mpfr_get_d (mpc_realref (op), MPFR_RNDN);
+      IM (double, z) = mpfr_get_d (mpc_imagref (op), MPFR_RNDN);
+      r = mpc_cr_csqrt (z);
+      mpc_sqrt (ref, op, MPC_RNDNN);
+      mpfr_set_d (mpc_realref (got), RE (double, r), MPFR_RNDN);
+      mpfr_set_d (mpc_imagref (got), IM (double, r), MPFR_RNDN);
+      check_result ("sqrt", "double", op, got, ref);
+    }
+
+  mpc_set_prec (op, 24);
+  mpc_set_prec (got, 24);
+  mpc_set_prec (ref, 24);
+  for (k = 0; k < 10000; k++)
+    {
+      test_default_random (op, -120, 120, 128, 0);
+      RE (float, zf) = mpfr_get_flt (mpc_realref (op), MPFR_RNDN);
+      IM (float, zf) = mpfr_get_flt (mpc_imagref (op), MPFR_RNDN);
+      rf = mpc_cr_csqrtf (zf);
+      mpc_sqrt (ref, op, MPC_RNDNN);
+      mpfr_set_flt (mpc_realref (got), RE (float, rf), MPFR_RNDN);
+      mpfr_set_flt (mpc_imagref (got), IM (float, rf), MPFR_RNDN);
+      if (is_normal (ref, FLT_MAX_EXP - 2))
+        check_result ("sqrt", "float", op, got, ref);
+    }
+
+  /* exact results */
+  RE (double, z) = 3.0;
+  IM (double, z) = 4.0;
+  r = mpc_cr_csqrt (z);
+  MPC_ASSERT (RE (double, r) == 2.0 && IM (double, r) == 1.0);
+  RE (double, z) = -4.0;
+  IM (double, z) = -0.0;
+  r = mpc_cr_csqrt (z);
+  MPC_ASSERT (RE (double, r) == 0.0 && !signbit (RE (double, r))
+              && IM (double, r) == -2.0);
+  RE (float, zf) = 3.0f;
+  IM (float, zf) = -4.0f;
+  rf = mpc_cr_csqrtf (zf);
+  MPC_ASSERT (RE (float, rf) == 2.0f && IM (float, rf) == -1.0f);
+
+  mpc_clear (op);
+  mpc_clear (got);
+  mpc_clear (ref);
+}
+
+/* check results in the subnormal and overflow ranges */
+static void
+check_range (void)
+{
+  mpfr_t x, y;
+  double _Complex z, r;
+  float _Complex zf, rf;
+  long double _Complex zl, rl;
+
+  mpfr_init2 (x, 200);
+  mpfr_init2 (y, 200);
+
+  /* exp (t) with t = (min_exp - mant_dig / 2) log(2) is subnormal, with
+     about half of the bits of the format; its correct rounding is that
+     of a 200-bit approximation, barring an unlikely hard case */
+  RE (double, z) = (DBL_MIN_EXP - DBL_MANT_DIG / 2) * 0.6931;
+  IM (double, z) = 0.0;
+  r = mpc_cr_cexp (z);
+  mpfr_set_d (x, RE (double, z), MPFR_RNDN);
+  mpfr_exp (y, x, MPFR_RNDN);
+  MPC_ASSERT (RE (double, r) == mpfr_get_d (y, MPFR_RNDN));
+  MPC_ASSERT (RE (double, r) < DBL_MIN && RE (double, r) > 0.0);
+  MPC_ASSERT (IM (double, r) == 0.0 && !signbit (IM (double, r)));
+
+  RE (float, zf) = (FLT_MIN_EXP - FLT_MANT_DIG / 2) * 0.6931f;
+  IM (float, zf) = 0.0f;
+  rf = mpc_cr_cexpf (zf);
+  mpfr_set_flt (x, RE (float, zf), MPFR_RNDN);
+  mpfr_exp (y, x, MPFR_RNDN);
+  MPC_ASSERT (RE (float, rf) == mpfr_get_flt (y, MPFR_RNDN));
+  MPC_ASSERT (RE (float, rf) < FLT_MIN && RE (float, rf) > 0.0f);
+
+  RE (long double, zl) = (LDBL_MIN_EXP - LDBL_MANT_DIG / 2) * 0.6931L;
+  IM (long double, zl) = 0.0L;
+  rl = mpc_cr_cexpl (zl);
+  mpfr_set_ld (x, RE (long double, zl), MPFR_RNDN);
+  mpfr_exp (y, x, MPFR_RNDN);
+  MPC_ASSERT (RE (long double, rl) == mpfr_get_ld (y, MPFR_RNDN));
+  MPC_ASSERT (RE (long double, rl) < LDBL_MIN && RE (long double, rl) > 0.0L);
+
+  /* overflow */
+  RE (double, z) = DBL_MAX_EXP * 0.7;
+  r = mpc_cr_cexp (z);
+  MPC_ASSERT (RE (double, r) > DBL_MAX && IM (double, r) == 0.0);
+  RE (float, zf) = FLT_MAX_EXP * 0.7f;
+  rf = mpc_cr_cexpf (zf);
+  MPC_ASSERT (RE (float, rf) > FLT_MAX && IM (float, rf) == 0.0f);
+
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+static void
+check_pow (void)
+{
+  mpc_t op1, op2, got, ref;
+  double _Complex z, w, r;
+  int k;
+
+  mpc_init2 (op1, 53);
+  mpc_init2 (op2, 53);
+  mpc_init2 (got, 53);
+  mpc_init2 (ref, 53);
+  for (k = 0; k < 100; k++)
+    {
+      test_default_random (op1, -5, 5, 128, 16);
+      test_default_random (op2, -5, 3, 128, 16);
+      RE (double, z) = mpfr_get_d (mpc_realref (op1), MPFR_RNDN);
+      IM (double, z) = mpfr_get_d (mpc_imagref (op1), MPFR_RNDN);
+      RE (double, w) = mpfr_get_d (mpc_realref (op2), MPFR_RNDN);
+      IM (double, w) = mpfr_get_d (mpc_imagref (op2), MPFR_RNDN);
+      mpc_pow (ref, op1, op2, MPC_RNDNN);
+      if (is_normal (ref, DBL_MAX_EXP - 2))
+        {
+          r = mpc_cr_cpow (z, w);
+          mpfr_set_d (mpc_realref (got), RE (double, r), MPFR_RNDN);
+          mpfr_set_d (mpc_imagref (got), IM (double, r), MPFR_RNDN);
+          check_result ("pow", "double", op1, got, ref);
+        }
+    }
+  mpc_clear (op1);
+  mpc_clear (op2);
+  mpc_clear (got);
+  mpc_clear (ref);
+}
+
+int
+main (void)
+{
+  mpfr_exp_t emin;
+
+  test_start ();
+
+  emin = mpfr_get_emin ();
+  check_random (FLT_MANT_DIG, -20, 5, 20);
+  check_random (DBL_MANT_DIG, -20, 5, 20);
+  check_random (LDBL_MANT_DIG, -20, 5, 20);
+#ifdef HAVE_MPFR_FLOAT128
+  check_random (113, -20, 5, 20);
+#endif
+  check_sqrt ();
+  check_range ();
+  check_pow ();
+  MPC_ASSERT (mpfr_get_emin () == emin);
+
+  test_end ();
+
+  return 0;
+}
+
+#else
+
+int
+main (void)
+{
+  return 77;
+}
+
+#endif /* HAVE_COMPLEX_H */
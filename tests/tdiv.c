@@ -68,12 +68,74 @@ bug20200206 (void)
   mpfr_set_emax (emax);
 }
 
+/* compare the exact kernel for operands of at most two limbs with the
+   generic code, used for the same operands with a larger precision */
+static void
+check_small (void)
+{
+  mpfr_prec_t prec;
+  mpc_t x, y, xl, yl, z, zr;
+  int i, rnd_re, rnd_im, inex, inex_r;
+  known_signs_t ks = {1, 1};
+
+  mpc_init2 (x, 2);
+  mpc_init2 (y, 2);
+  mpc_init2 (xl, 2 * GMP_NUMB_BITS + 1);
+  mpc_init2 (yl, 2 * GMP_NUMB_BITS + 1);
+  mpc_init2 (z, 2);
+  mpc_init2 (zr, 2);
+  for (prec = 2; prec <= 2 * GMP_NUMB_BITS; prec += 5)
+    {
+      mpc_set_prec (x, prec);
+      mpc_set_prec (y, prec);
+      mpc_set_prec (z, prec);
+      mpc_set_prec (zr, prec);
+      for (i = 0; i < 3; i++)
+        {
+          test_default_random (x, -200, 200, 128, 0);
+          test_default_random (y, -200, 200, 128, 0);
+          if (i == 2)
+            /* exact quotient */
+            mpc_mul (x, x, y, MPC_RNDNN);
+          mpc_set (xl, x, MPC_RNDNN);
+          mpc_set (yl, y, MPC_RNDNN);
+          for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+              {
+                inex = mpc_div (z, x, y, MPC_RND (rnd_re, rnd_im));
+                inex_r = mpc_div (zr, xl, yl, MPC_RND (rnd_re, rnd_im));
+                if (!same_mpc_value (z, zr, ks) || inex != inex_r)
+                  {
+                    printf ("Error in mpc_div for small precision and "
+                            "rnd=(%s,%s)\n",
+                            mpfr_print_rnd_mode (rnd_re),
+                            mpfr_print_rnd_mode (rnd_im));
+                    MPC_OUT (x);
+                    MPC_OUT (y);
+                    MPC_OUT (z);
+                    MPC_OUT (zr);
+                    printf ("inex got %s, expected %s\n", MPC_INEX_STR (inex),
+                            MPC_INEX_STR (inex_r));
+                    exit (1);
+                  }
+              }
+        }
+    }
+  mpc_clear (x);
+  mpc_clear (y);
+  mpc_clear (xl);
+  mpc_clear (yl);
+  mpc_clear (z);
+  mpc_clear (zr);
+}
+
 int
 main (void)
 {
   test_start ();
 
   bug20200206 ();
+  check_small ();
   data_check_template ("div.dsc", "div.dat");
 
   tgeneric_template ("div.dsc", 2, 1024, 7, 4096);
@@ -83,6 +83,153 @@ bug20200717 (void)
   mpc_clear (a);
 }
 
+/* compare mpc_dot_strided with mpc_dot on random arrays read with
+   strides 1, 2 and -1, in place in the last case */
+static void
+check_strided (void)
+{
+#define N 7
+  mpc_t z[2 * N], res, ref;
+  mpc_ptr x[N], y[N];
+  mpfr_prec_t prec;
+  int i, inex, inex_ref;
+
+  for (prec = 2; prec <= 300; prec += 49)
+    {
+      for (i = 0; i < 2 * N; i++)
+        {
+          mpc_init2 (z[i], prec + i);
+          test_default_random (z[i], -20, 20, 128, 16);
+        }
+      mpc_init2 (res, prec);
+      mpc_init2 (ref, prec);
+
+      for (i = 0; i < N; i++)
+        {
+          x[i] = z[i];
+          y[i] = z[N + i];
+        }
+      inex_ref = mpc_dot (ref, x, y, N, MPC_RNDNZ);
+      inex = mpc_dot_strided (res, z[0], 1, z[N], 1, N, MPC_RNDNZ);
+      if (inex != inex_ref || mpc_cmp (res, ref) != 0)
+        {
+          printf ("mpc_dot_strided differs from mpc_dot for strides 1\n");
+          exit (1);
+        }
+
+      for (i = 0; i < N; i++)
+        {
+          x[i] = z[2 * i];
+          y[i] = z[2 * N - 1 - i];
+        }
+      inex_ref = mpc_dot (ref, x, y, N, MPC_RNDDU);
+      inex = mpc_dot_strided (res, z[0], 2, z[2 * N - 1], -1, N, MPC_RNDDU);
+      if (inex != inex_ref || mpc_cmp (res, ref) != 0)
+        {
+          printf ("mpc_dot_strided differs from mpc_dot for strides 2, -1\n");
+          exit (1);
+        }
+
+      /* the result may be one of the operands */
+      mpc_set_prec (ref, mpfr_get_prec (mpc_realref (z[0])));
+      inex_ref = mpc_dot (ref, x, y, N, MPC_RNDZU);
+      inex = mpc_dot_strided (z[0], z[0], 2, z[2 * N - 1], -1, N, MPC_RNDZU);
+      if (inex != inex_ref || mpc_cmp (z[0], ref) != 0)
+        {
+          printf ("mpc_dot_strided differs from mpc_dot in place\n");
+          exit (1);
+        }
+
+      for (i = 0; i < 2 * N; i++)
+        mpc_clear (z[i]);
+      mpc_clear (res);
+      mpc_clear (ref);
+    }
+#undef N
+}
+
+/* compare mpc_dot_mt with mpc_dot on long arrays, for several numbers of
+   threads: random terms, products cancelling exactly, and random
+   products between two huge opposite ones, so that the partial sums of
+   the threads do not allow to round their sum */
+static void
+check_mt (void)
+{
+  /* N terms give MPC_MT_CHUNK_MIN = 1024 terms to each of 6 threads */
+#define N 6144
+  static mpc_t z[N], y[N];
+  static mpc_ptr t[N], u[N];
+  mpc_t res, ref;
+  known_signs_t ks = {1, 1};
+  mpfr_prec_t prec;
+  mpc_rnd_t rnd;
+  unsigned int threads;
+  int i, kind, r, inex, inex_ref;
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_init2 (z[i], 2);
+      mpc_init2 (y[i], 2);
+      t[i] = z[i];
+      u[i] = y[i];
+    }
+  for (prec = 2; prec <= 400; prec += 199)
+    for (kind = 0; kind < 3; kind++)
+      {
+        for (i = 0; i < N; i++)
+          {
+            mpc_set_prec (z[i], prec);
+            mpc_set_prec (y[i], prec);
+            if (kind == 1)
+              mpc_set_si_si (z[i], (i % 2) ? -i / 2 : i / 2,
+                             (i % 2) ? i / 2 : -i / 2, MPC_RNDNN);
+            else
+              {
+                test_default_random (z[i], -10, 10, 128, 0);
+                test_default_random (y[i], -10, 10, 128, 0);
+              }
+          }
+        if (kind == 1)
+          for (i = 0; i < N; i++)
+            mpc_set (y[i], z[N - 1 - i], MPC_RNDNN);
+        else if (kind == 2)
+          {
+            /* the first and last products are huge and opposite */
+            mpc_mul_2ui (z[0], z[0], 300, MPC_RNDNN);
+            mpc_set (z[N - 1], z[0], MPC_RNDNN);
+            mpc_neg (y[N - 1], y[0], MPC_RNDNN);
+          }
+        mpc_init2 (res, prec);
+        mpc_init2 (ref, prec);
+        for (r = 0; r < 4; r++)
+          {
+            rnd = MPC_RND (r, 3 - r);
+            inex_ref = mpc_dot (ref, t, u, N, rnd);
+            for (threads = 1; threads <= 6; threads++)
+              {
+                inex = mpc_dot_mt (res, t, u, N, rnd, threads);
+                if (inex != inex_ref || !same_mpc_value (res, ref, ks))
+                  {
+                    printf ("mpc_dot_mt differs from the sequential function "
+                            "for %u threads, kind %d, precision %lu\n",
+                            threads, kind, (unsigned long) prec);
+                    MPC_OUT (ref);
+                    MPC_OUT (res);
+                    exit (1);
+                  }
+              }
+          }
+        mpc_clear (res);
+        mpc_clear (ref);
+      }
+  for (i = 0; i < N; i++)
+    {
+      mpc_clear (z[i]);
+      mpc_clear (y[i]);
+    }
+#undef N
+}
+
 int
 main (void)
 {
@@ -90,6 +237,8 @@ main (void)
 
   bug20200717 ();
   check_special ();
+  check_mt ();
+  check_strided ();
 
   test_end ();
 
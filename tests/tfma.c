@@ -88,6 +88,142 @@ check_random (void)
    mpc_clear (c);
 }
 
+/* operands of at most two limbs, for which mpc_fma uses exact kernels,
+   with cancellation between a*b and c */
+static void
+check_small (void)
+{
+   mpfr_prec_t prec;
+   int rnd_re, rnd_im, i;
+   mpc_t a, b, c;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (c, 2);
+
+   for (prec = 2; prec <= 2 * GMP_NUMB_BITS; prec += 7) {
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      /* a*b fits in c for prec <= GMP_NUMB_BITS, otherwise c is a*b
+         rounded and the cancellation is partial */
+      mpc_set_prec (c, (prec <= GMP_NUMB_BITS) ? 2 * prec : 2 * GMP_NUMB_BITS);
+
+      for (i = 0; i < 3; i++) {
+         test_default_random (a, -300, 300, 128, 0);
+         test_default_random (b, -300, 300, 128, 0);
+         if (i == 0)
+            test_default_random (c, -300, 300, 128, 0);
+         else {
+            mpc_mul (c, a, b, MPC_RNDNN);
+            mpc_neg (c, c, MPC_RNDNN);
+            if (i == 2)
+               mpc_mul_2ui (c, c, 1, MPC_RNDNN);
+         }
+
+         for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+               cmpfma (a, b, c, MPC_RND (rnd_re, rnd_im));
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+}
+
+/* operands above MPC_FMMA_THRESHOLD limbs, for which mpc_fma first tries
+   a pass with rounded operations, with cancellation between a*b and c */
+static void
+check_large (void)
+{
+   mpfr_prec_t prec;
+   int rnd_re, rnd_im, i;
+   mpc_t a, b, c;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (c, 2);
+
+   for (prec = 1800; prec <= 3000; prec += 600) {
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      mpc_set_prec (c, prec + 100);
+
+      for (i = 0; i < 2; i++) {
+         test_default_random (a, -300, 300, 128, 0);
+         test_default_random (b, -300, 300, 128, 0);
+         if (i == 0)
+            test_default_random (c, -300, 300, 128, 0);
+         else {
+            mpc_mul (c, a, b, MPC_RNDNN);
+            mpc_neg (c, c, MPC_RNDNN);
+         }
+
+         for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+               cmpfma (a, b, c, MPC_RND (rnd_re, rnd_im));
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+}
+
+/* the rounded product a*b overflows, which used to go unnoticed for large
+   precisions since rounding towards zero yields a finite number */
+static void
+check_overflow (void)
+{
+   mpfr_exp_t emax = mpfr_get_emax ();
+   mpc_t a, b, c, r;
+   int inex;
+
+   mpfr_set_emax (100);
+   mpc_init2 (a, 3000);
+   mpc_init2 (b, 3000);
+   mpc_init2 (c, 3000);
+   mpc_init2 (r, 3000);
+
+   /* a*b = 2^40 + i*(2^121-2^40) and c = 3-2^40 + i */
+   mpc_set_ui_ui (a, 1, 1, MPC_RNDNN);
+   mpc_mul_2ui (a, a, 60, MPC_RNDNN);
+   mpc_set (b, a, MPC_RNDNN);
+   mpfr_set_ui_2exp (mpc_imagref (b), 1, -80, MPFR_RNDN);
+   mpfr_ui_sub (mpc_imagref (b), 1, mpc_imagref (b), MPFR_RNDN);
+   mpfr_mul_2ui (mpc_imagref (b), mpc_imagref (b), 60, MPFR_RNDN);
+   mpfr_set_ui_2exp (mpc_realref (c), 1, 40, MPFR_RNDN);
+   mpfr_ui_sub (mpc_realref (c), 3, mpc_realref (c), MPFR_RNDN);
+   mpfr_set_ui (mpc_imagref (c), 1, MPFR_RNDN);
+
+   inex = mpc_fma (r, a, b, c, MPC_RNDZZ);
+   if (mpfr_cmp_ui (mpc_realref (r), 3) != 0 || MPC_INEX_RE (inex) != 0
+       || !mpfr_regular_p (mpc_imagref (r))
+       || mpfr_get_exp (mpc_imagref (r)) != 100 || MPC_INEX_IM (inex) >= 0)
+     {
+       printf ("Error in mpc_fma for an overflow in a*b\n");
+       MPC_OUT (r);
+       printf ("inex = (%i, %i)\n", MPC_INEX_RE (inex), MPC_INEX_IM (inex));
+       exit (1);
+     }
+
+   inex = mpc_fma (r, a, b, c, MPC_RNDNN);
+   if (mpfr_cmp_ui (mpc_realref (r), 3) != 0 || MPC_INEX_RE (inex) != 0
+       || !mpfr_inf_p (mpc_imagref (r)) || MPC_INEX_IM (inex) <= 0)
+     {
+       printf ("Error in mpc_fma for an overflow in a*b\n");
+       MPC_OUT (r);
+       printf ("inex = (%i, %i)\n", MPC_INEX_RE (inex), MPC_INEX_IM (inex));
+       exit (1);
+     }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+   mpc_clear (r);
+   mpfr_set_emax (emax);
+}
+
 #define MPC_FUNCTION_CALL                                               \
   P[0].mpc_inex =                                                       \
     mpc_fma (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc, P[5].mpc_rnd)
@@ -110,6 +246,9 @@ main (void)
   test_start ();
 
   check_random (); /* Remove it? */
+  check_small ();
+  check_large ();
+  check_overflow ();
 
   data_check_template ("fma.dsc", "fma.dat");
 
@@ -0,0 +1,146 @@
+/* tfmma -- test file for mpc_fmma.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdlib.h>
+#include "mpc-tests.h"
+
+static void
+cmpdot (mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_srcptr d, mpc_rnd_t rnd)
+   /* computes a*b+c*d with mpc_fmma and with mpc_dot, which also
+      rounds the exact result once, and compares the results and return
+      values */
+{
+   mpc_t z, t;
+   mpc_ptr x[2], y[2];
+   int   inex_z, inex_t;
+
+   mpc_init2 (z, MPC_MAX_PREC (a));
+   mpc_init2 (t, MPC_MAX_PREC (a));
+
+   x[0] = (mpc_ptr) a;
+   x[1] = (mpc_ptr) c;
+   y[0] = (mpc_ptr) b;
+   y[1] = (mpc_ptr) d;
+   inex_z = mpc_fmma (z, a, b, c, d, rnd);
+   inex_t = mpc_dot (t, x, y, 2, rnd);
+
+   if (mpc_cmp (z, t) != 0 || inex_z != inex_t) {
+      fprintf (stderr, "mpc_fmma and mpc_dot differ for rnd=(%s,%s)\n",
+               mpfr_print_rnd_mode(MPC_RND_RE(rnd)),
+               mpfr_print_rnd_mode(MPC_RND_IM(rnd)));
+      MPC_OUT (a);
+      MPC_OUT (b);
+      MPC_OUT (c);
+      MPC_OUT (d);
+      MPC_OUT (z);
+      MPC_OUT (t);
+      if (inex_z != inex_t) {
+         fprintf (stderr, "inex (z): %s\n", MPC_INEX_STR (inex_z));
+         fprintf (stderr, "inex (t): %s\n", MPC_INEX_STR (inex_t));
+      }
+      exit (1);
+   }
+
+   mpc_clear (z);
+   mpc_clear (t);
+}
+
+/* random operands, including precisions above MPC_FMMA_THRESHOLD limbs,
+   for which mpc_fmma first tries a pass with rounded operations, and
+   cancellation between a*b and c*d */
+static void
+check_random (void)
+{
+   mpfr_prec_t prec;
+   int rnd_re, rnd_im, i;
+   mpc_t a, b, c, d;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (c, 2);
+   mpc_init2 (d, 2);
+
+   for (prec = 2; prec <= 3000; prec = (mpfr_prec_t) (prec * 1.5 + 1)) {
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      mpc_set_prec (c, prec);
+      mpc_set_prec (d, prec + 10);
+
+      for (i = 0; i < 3; i++) {
+         test_default_random (a, -300, 300, 128, 0);
+         test_default_random (b, -300, 300, 128, 0);
+         test_default_random (c, -300, 300, 128, 0);
+         if (i == 0)
+            test_default_random (d, -300, 300, 128, 0);
+         else {
+            /* c*d is close to -a*b */
+            mpc_div (d, a, c, MPC_RNDNN);
+            mpc_mul (d, d, b, MPC_RNDNN);
+            mpc_neg (d, d, MPC_RNDNN);
+            if (i == 2) {
+               /* exact cancellation */
+               mpc_set (c, a, MPC_RNDNN);
+               mpc_neg (d, b, MPC_RNDNN);
+            }
+         }
+
+         for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+               cmpdot (a, b, c, d, MPC_RND (rnd_re, rnd_im));
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+   mpc_clear (d);
+}
+
+#define MPC_FUNCTION_CALL                                               \
+  P[0].mpc_inex = mpc_fmma (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP1                                     \
+  P[0].mpc_inex = mpc_fmma (P[1].mpc, P[1].mpc, P[3].mpc, P[4].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP2                                     \
+  P[0].mpc_inex = mpc_fmma (P[1].mpc, P[2].mpc, P[1].mpc, P[4].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP3                                     \
+  P[0].mpc_inex = mpc_fmma (P[1].mpc, P[2].mpc, P[3].mpc, P[1].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP4                                     \
+  P[0].mpc_inex = mpc_fmma (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc, P[1].mpc, \
+                            P[6].mpc_rnd)
+
+#include "tgeneric.tpl"
+
+int
+main (void)
+{
+  test_start ();
+
+  check_random ();
+
+  tgeneric_template ("fmma.dsc", 2, 1024, 1, 256);
+
+  test_end ();
+
+  return 0;
+}
@@ -0,0 +1,201 @@
+/* tfmms -- test file for mpc_fmms.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdlib.h>
+#include "mpc-tests.h"
+
+/* The random checks of tfmma, which compare with mpc_dot, cover the code
+   shared with mpc_fmma; here we check what is specific to mpc_fmms: the
+   sign of a zero from exact cancellation, and the opposite of d, which is
+   formed without copying it. */
+
+/* if a*b = c*d exactly, a*b-c*d is +0 in both parts, except -0 when
+   rounding downwards */
+static void
+check_zero_sign (void)
+{
+   mpfr_prec_t prec;
+   int rnd_re, rnd_im, i;
+   mpc_t a, b, z;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (z, 2);
+
+   for (prec = 2; prec <= 3000; prec = (mpfr_prec_t) (prec * 1.5 + 1)) {
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      mpc_set_prec (z, prec);
+
+      for (i = 0; i < 3; i++) {
+         test_default_random (a, -300, 300, 128, 0);
+         test_default_random (b, -300, 300, 128, 0);
+         for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++) {
+               int inex = mpc_fmms (z, a, b, a, b, MPC_RND (rnd_re, rnd_im));
+
+               if (inex != 0
+                   || !mpfr_zero_p (mpc_realref (z))
+                   || !mpfr_zero_p (mpc_imagref (z))
+                   || !mpfr_signbit (mpc_realref (z))
+                      != (rnd_re != MPFR_RNDD)
+                   || !mpfr_signbit (mpc_imagref (z))
+                      != (rnd_im != MPFR_RNDD)) {
+                  fprintf (stderr, "mpc_fmms (a, b, a, b) is not an exact "
+                           "zero of the right sign for rnd=(%s,%s)\n",
+                           mpfr_print_rnd_mode ((mpfr_rnd_t) rnd_re),
+                           mpfr_print_rnd_mode ((mpfr_rnd_t) rnd_im));
+                  MPC_OUT (a);
+                  MPC_OUT (b);
+                  MPC_OUT (z);
+                  exit (1);
+               }
+            }
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (z);
+}
+
+/* mpc_fmms (a, b, c, d) is mpc_fmma (a, b, c, -d), also when the result is
+   d itself, and d is not modified otherwise, including the signs of zeros */
+static void
+check_opposite (void)
+{
+   mpfr_prec_t prec;
+   int rnd_re, rnd_im, i, inex_z, inex_t;
+   mpc_rnd_t rnd;
+   mpc_t a, b, c, d, e, z, t;
+   known_signs_t ks = {1, 1};
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (c, 2);
+   mpc_init2 (d, 2);
+   mpc_init2 (e, 2);
+   mpc_init2 (z, 2);
+   mpc_init2 (t, 2);
+
+   for (prec = 2; prec <= 3000; prec = (mpfr_prec_t) (prec * 1.5 + 1)) {
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      mpc_set_prec (c, prec);
+      mpc_set_prec (d, prec + 10);
+      mpc_set_prec (e, prec + 10);
+      mpc_set_prec (z, prec + 10);
+      mpc_set_prec (t, prec + 10);
+
+      for (i = 0; i < 4; i++) {
+         test_default_random (a, -300, 300, 128, 0);
+         test_default_random (b, -300, 300, 128, 0);
+         test_default_random (c, -300, 300, 128, 0);
+         if (i < 2) {
+            /* c*d is close to a*b */
+            mpc_div (d, a, c, MPC_RNDNN);
+            mpc_mul (d, d, b, MPC_RNDNN);
+         }
+         else
+            test_default_random (d, -300, 300, 128, 0);
+         if (i == 3)
+            mpfr_set_zero (mpc_imagref (d), -1);
+
+         for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++) {
+               rnd = MPC_RND (rnd_re, rnd_im);
+               mpc_neg (e, d, MPC_RNDNN);
+               inex_t = mpc_fmma (t, a, b, c, e, rnd);
+               mpc_neg (e, e, MPC_RNDNN);
+               inex_z = mpc_fmms (z, a, b, c, d, rnd);
+               if (inex_z != inex_t || !same_mpc_value (z, t, ks)
+                   || !same_mpc_value (d, e, ks)) {
+                  fprintf (stderr, "mpc_fmms (a, b, c, d) differs from "
+                           "mpc_fmma (a, b, c, -d) for rnd=(%s,%s)\n",
+                           mpfr_print_rnd_mode (MPC_RND_RE (rnd)),
+                           mpfr_print_rnd_mode (MPC_RND_IM (rnd)));
+                  MPC_OUT (a);
+                  MPC_OUT (b);
+                  MPC_OUT (c);
+                  MPC_OUT (d);
+                  MPC_OUT (z);
+                  MPC_OUT (t);
+                  exit (1);
+               }
+               inex_z = mpc_fmms (d, a, b, c, d, rnd);
+               if (inex_z != inex_t || !same_mpc_value (d, t, ks)) {
+                  fprintf (stderr, "mpc_fmms (d, a, b, c, d) differs from "
+                           "mpc_fmma (a, b, c, -d) for rnd=(%s,%s)\n",
+                           mpfr_print_rnd_mode (MPC_RND_RE (rnd)),
+                           mpfr_print_rnd_mode (MPC_RND_IM (rnd)));
+                  MPC_OUT (a);
+                  MPC_OUT (b);
+                  MPC_OUT (c);
+                  MPC_OUT (e);
+                  MPC_OUT (d);
+                  MPC_OUT (t);
+                  exit (1);
+               }
+               mpc_set (d, e, MPC_RNDNN);
+            }
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+   mpc_clear (d);
+   mpc_clear (e);
+   mpc_clear (z);
+   mpc_clear (t);
+}
+
+#define MPC_FUNCTION_CALL                                               \
+  P[0].mpc_inex = mpc_fmms (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP1                                     \
+  P[0].mpc_inex = mpc_fmms (P[1].mpc, P[1].mpc, P[3].mpc, P[4].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP2                                     \
+  P[0].mpc_inex = mpc_fmms (P[1].mpc, P[2].mpc, P[1].mpc, P[4].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP3                                     \
+  P[0].mpc_inex = mpc_fmms (P[1].mpc, P[2].mpc, P[3].mpc, P[1].mpc, P[5].mpc, \
+                            P[6].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP4                                     \
+  P[0].mpc_inex = mpc_fmms (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc, P[1].mpc, \
+                            P[6].mpc_rnd)
+
+#include "tgeneric.tpl"
+
+int
+main (void)
+{
+  test_start ();
+
+  check_zero_sign ();
+  check_opposite ();
+
+  tgeneric_template ("fmms.dsc", 2, 1024, 1, 256);
+
+  test_end ();
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+/* tfms -- test file for mpc_fms.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdlib.h>
+#include "mpc-tests.h"
+
+static void
+cmpfma (mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, mpc_rnd_t rnd)
+   /* computes a*b-c with mpc_fms and as a*b+(-c) with mpc_fma, and
+      compares the results and return values */
+{
+   mpc_t z, t, c_neg;
+   int   inex_z, inex_t;
+
+   mpc_init2 (z, MPC_MAX_PREC (a));
+   mpc_init2 (t, MPC_MAX_PREC (a));
+   mpc_init3 (c_neg, MPC_PREC_RE (c), MPC_PREC_IM (c));
+
+   mpc_neg (c_neg, c, MPC_RNDNN);
+   inex_z = mpc_fms (z, a, b, c, rnd);
+   inex_t = mpc_fma (t, a, b, c_neg, rnd);
+
+   if (mpc_cmp (z, t) != 0 || inex_z != inex_t) {
+      fprintf (stderr, "mpc_fms and mpc_fma differ for rnd=(%s,%s)\n",
+               mpfr_print_rnd_mode(MPC_RND_RE(rnd)),
+               mpfr_print_rnd_mode(MPC_RND_IM(rnd)));
+      MPC_OUT (a);
+      MPC_OUT (b);
+      MPC_OUT (c);
+      MPC_OUT (z);
+      MPC_OUT (t);
+      if (inex_z != inex_t) {
+         fprintf (stderr, "inex (z): %s\n", MPC_INEX_STR (inex_z));
+         fprintf (stderr, "inex (t): %s\n", MPC_INEX_STR (inex_t));
+      }
+      exit (1);
+   }
+
+   mpc_clear (z);
+   mpc_clear (t);
+   mpc_clear (c_neg);
+}
+
+/* random operands, with exact and partial cancellation between a*b and c,
+   including precisions for which mpc_fma uses the exact kernels and the
+   pass with rounded operations */
+static void
+check_random (void)
+{
+   mpfr_prec_t prec;
+   int rnd_re, rnd_im, i;
+   mpc_t a, b, c;
+
+   mpc_init2 (a, 2);
+   mpc_init2 (b, 2);
+   mpc_init2 (c, 2);
+
+   for (prec = 2; prec <= 3000; prec = (mpfr_prec_t) (prec * 1.5 + 1)) {
+      mpc_set_prec (a, prec);
+      mpc_set_prec (b, prec);
+      mpc_set_prec (c, 2 * prec);
+
+      for (i = 0; i < 3; i++) {
+         test_default_random (a, -300, 300, 128, 0);
+         test_default_random (b, -300, 300, 128, 0);
+         if (i == 0)
+            test_default_random (c, -300, 300, 128, 0);
+         else {
+            mpc_mul (c, a, b, MPC_RNDNN);
+            if (i == 2)
+               mpc_mul_2ui (c, c, 1, MPC_RNDNN);
+         }
+
+         for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+               cmpfma (a, b, c, MPC_RND (rnd_re, rnd_im));
+      }
+   }
+
+   mpc_clear (a);
+   mpc_clear (b);
+   mpc_clear (c);
+}
+
+#define MPC_FUNCTION_CALL                                               \
+  P[0].mpc_inex = mpc_fms (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc, P[5].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP1                                     \
+  P[0].mpc_inex = mpc_fms (P[1].mpc, P[1].mpc, P[3].mpc, P[4].mpc, P[5].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP2                                     \
+  P[0].mpc_inex = mpc_fms (P[1].mpc, P[2].mpc, P[1].mpc, P[4].mpc, P[5].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP3                                     \
+  P[0].mpc_inex = mpc_fms (P[1].mpc, P[2].mpc, P[3].mpc, P[1].mpc, P[5].mpc_rnd)
+
+#include "tgeneric.tpl"
+
+int
+main (void)
+{
+  test_start ();
+
+  check_random ();
+
+  tgeneric_template ("fms.dsc", 2, 1024, 1, 256);
+
+  test_end ();
+
+  return 0;
+}
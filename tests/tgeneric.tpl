@@ -149,6 +149,14 @@ check_against_quadruple_precision (mpc_fun_param_t *params,
         }
 #endif
 
+#ifdef MPC_FUNCTION_CALL_REUSE_OP4
+      if (copy_parameter (params, 1, 5) == 0)
+        {
+          MPC_FUNCTION_CALL_REUSE_OP4;
+          check_data (NULL, params, 5);
+        }
+#endif
+
       set_output_precision (params, 4 * prec);
     }
 }
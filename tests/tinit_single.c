@@ -0,0 +1,140 @@
+/* tinit_single -- Test file for MPC_DECL_INIT and mpc_init2_single.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+/* compute a few functions of z and w into a and b, which may share the
+   memory layout under test */
+static void
+compute (mpc_ptr a, mpc_ptr b, mpc_srcptr z, mpc_srcptr w)
+{
+  mpc_mul (a, z, w, MPC_RNDNN);
+  mpc_exp (b, a, MPC_RNDZU);
+  mpc_add (a, a, b, MPC_RNDDN);
+  mpc_sqrt (b, a, MPC_RNDNN);
+  mpc_div (a, b, z, MPC_RNDUU);
+  mpc_sin (b, a, MPC_RNDNN);
+  mpc_log (a, b, MPC_RNDNN);
+}
+
+static void
+check (mpc_ptr a, mpc_ptr b, mpc_ptr a_ref, mpc_ptr b_ref, const char *what)
+{
+  if (mpc_cmp (a, a_ref) != 0 || mpc_cmp (b, b_ref) != 0)
+    {
+      printf ("Error for %s\n", what);
+      MPC_OUT (a);
+      MPC_OUT (a_ref);
+      MPC_OUT (b);
+      MPC_OUT (b_ref);
+      exit (1);
+    }
+}
+
+static void
+check_decl_init (void)
+{
+  MPC_DECL_INIT (a, 128);
+  MPC_DECL_INIT (b, 128);
+  MPC_DECL_INIT (z, 64);
+  mpc_t w, a_ref, b_ref;
+
+  MPC_ASSERT (mpfr_nan_p (mpc_realref (a)) && mpfr_nan_p (mpc_imagref (a)));
+  MPC_ASSERT (mpfr_get_prec (mpc_realref (a)) == 128);
+  MPC_ASSERT (mpfr_get_prec (mpc_imagref (z)) == 64);
+
+  mpc_init2 (w, 64);
+  mpc_init2 (a_ref, 128);
+  mpc_init2 (b_ref, 128);
+  mpc_set_str (z, "(1.25 -0.75)", 10, MPC_RNDNN);
+  mpc_set_si_si (w, 3, 7, MPC_RNDNN);
+  mpc_div_ui (w, w, 11, MPC_RNDNN);
+
+  compute (a, b, z, w);
+  compute (a_ref, b_ref, z, w);
+  check (a, b, a_ref, b_ref, "MPC_DECL_INIT");
+
+  /* mpc_mul_i in place exchanges the parts with mpfr_swap */
+  mpc_mul_i (a, a, +1, MPC_RNDNN);
+  mpc_mul_i (a_ref, a_ref, +1, MPC_RNDNN);
+  mpc_sqr (a, a, MPC_RNDNN);
+  mpc_sqr (a_ref, a_ref, MPC_RNDNN);
+  check (a, b, a_ref, b_ref, "MPC_DECL_INIT after mpc_mul_i");
+
+  mpc_clear (w);
+  mpc_clear (a_ref);
+  mpc_clear (b_ref);
+}
+
+static void
+check_single (mpfr_prec_t prec)
+{
+  mpc_t a, b, z, w, a_ref, b_ref;
+
+  mpc_init2_single (a, prec);
+  mpc_init2_single (b, prec);
+  mpc_init2 (a_ref, prec);
+  mpc_init2 (b_ref, prec);
+  mpc_init2 (z, prec);
+  mpc_init2 (w, prec);
+  MPC_ASSERT (mpfr_nan_p (mpc_realref (a)) && mpfr_nan_p (mpc_imagref (a)));
+
+  test_default_random (z, -10, 10, 128, 0);
+  test_default_random (w, -10, 10, 128, 0);
+  compute (a, b, z, w);
+  compute (a_ref, b_ref, z, w);
+  check (a, b, a_ref, b_ref, "mpc_init2_single");
+
+  /* mpc_mul_i in place exchanges the parts with mpfr_swap, so that the
+     real part of a no longer starts the memory block when freed */
+  mpc_mul_i (a, a, +1, MPC_RNDNN);
+  mpc_mul_i (a_ref, a_ref, +1, MPC_RNDNN);
+  check (a, b, a_ref, b_ref, "mpc_init2_single after mpc_mul_i");
+  mpc_set (b, a, MPC_RNDNN);
+  mpc_set (b_ref, a_ref, MPC_RNDNN);
+  mpc_mul_i (b, b, -1, MPC_RNDNN);
+  mpc_mul_i (b_ref, b_ref, -1, MPC_RNDNN);
+  mpc_mul_i (b, b, -1, MPC_RNDNN);
+  mpc_mul_i (b_ref, b_ref, -1, MPC_RNDNN);
+  check (a, b, a_ref, b_ref, "mpc_init2_single after mpc_mul_i");
+
+  mpc_clear_single (a);
+  mpc_clear_single (b);
+  mpc_clear (a_ref);
+  mpc_clear (b_ref);
+  mpc_clear (z);
+  mpc_clear (w);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t prec;
+
+  test_start ();
+
+  check_decl_init ();
+  for (prec = 2; prec <= 1000; prec += prec / 2 + 1)
+    check_single (prec);
+
+  test_end ();
+
+  return 0;
+}
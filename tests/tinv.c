@@ -0,0 +1,133 @@
+/* tinv -- test file for mpc_inv.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include <stdlib.h>
+#include "mpc-tests.h"
+
+#define MPC_FUNCTION_CALL                                               \
+  P[0].mpc_inex = mpc_inv (P[1].mpc, P[2].mpc, P[3].mpc_rnd)
+#define MPC_FUNCTION_CALL_REUSE_OP1                                     \
+  P[0].mpc_inex = mpc_inv (P[1].mpc, P[1].mpc, P[3].mpc_rnd)
+
+#include "data_check.tpl"
+#include "tgeneric.tpl"
+
+/* round the part x of 1/z, computed at a higher precision towards zero
+   with ternary value inex_x, to the precision of r with rnd; return 0 if
+   the correct rounding cannot be determined, and set *inex to the ternary
+   value otherwise */
+static int
+round_part (mpfr_ptr r, mpfr_srcptr x, int inex_x, mpfr_rnd_t rnd, int *inex)
+{
+  mpfr_prec_t p = mpfr_get_prec (r);
+
+  if (inex_x != 0
+      && !mpfr_can_round (x, mpfr_get_prec (x) - 1, MPFR_RNDZ, MPFR_RNDZ,
+                          p + (rnd == MPFR_RNDN)))
+    return 0;
+  *inex = mpfr_set (r, x, rnd);
+  return 1;
+}
+
+/* compare mpc_inv with the division of 1 by z at a precision above
+   MPC_FMMA_PREC = 2048 bits, which uses the Ziv loop of mpc_div instead of
+   the exact computations shared with mpc_inv, rounded to the target
+   precision; the operands include ones with exact quotients and with norms
+   that need more than twice the working precision */
+static void
+check_div (void)
+{
+  mpfr_prec_t prec;
+  mpc_t z, one, r, s, t;
+  int i, rnd_re, rnd_im, inex_r, inex_t, inex_re, inex_im;
+  known_signs_t ks = {1, 1};
+
+  mpc_init2 (z, 2);
+  mpc_init2 (one, 2);
+  mpc_init2 (r, 2);
+  mpc_init2 (s, 2);
+  mpc_init2 (t, 2);
+  mpc_set_ui (one, 1, MPC_RNDNN);
+  for (prec = 2; prec <= 1000; prec += 37)
+    {
+      mpc_set_prec (z, prec);
+      mpc_set_prec (r, prec);
+      mpc_set_prec (s, prec);
+      mpc_set_prec (t, prec + 2100);
+      for (i = 0; i < 4; i++)
+        {
+          test_default_random (z, -300, 300, 128, 0);
+          if (i == 1)
+            /* the norm is a power of 2, so that the result is exact */
+            mpfr_set (mpc_imagref (z), mpc_realref (z), MPFR_RNDN);
+          else if (i == 2)
+            /* very different exponents, for which the norm is rounded */
+            mpfr_mul_2ui (mpc_imagref (z), mpc_realref (z), 4 * prec + 100,
+                          MPFR_RNDN);
+          inex_t = mpc_div (t, one, z, MPC_RNDZZ);
+          for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+              {
+                if (!round_part (mpc_realref (s), mpc_realref (t),
+                                 MPC_INEX_RE (inex_t), (mpfr_rnd_t) rnd_re,
+                                 &inex_re)
+                    || !round_part (mpc_imagref (s), mpc_imagref (t),
+                                    MPC_INEX_IM (inex_t), (mpfr_rnd_t) rnd_im,
+                                    &inex_im))
+                  continue;
+                inex_r = mpc_inv (r, z, MPC_RND (rnd_re, rnd_im));
+                if (!same_mpc_value (r, s, ks)
+                    || inex_r != MPC_INEX (inex_re, inex_im))
+                  {
+                    printf ("Error in mpc_inv for rnd=(%s,%s)\n",
+                            mpfr_print_rnd_mode (rnd_re),
+                            mpfr_print_rnd_mode (rnd_im));
+                    MPC_OUT (z);
+                    MPC_OUT (r);
+                    MPC_OUT (s);
+                    printf ("inex got %s, expected %s\n",
+                            MPC_INEX_STR (inex_r),
+                            MPC_INEX_STR (MPC_INEX (inex_re, inex_im)));
+                    exit (1);
+                  }
+              }
+        }
+    }
+  mpc_clear (z);
+  mpc_clear (one);
+  mpc_clear (r);
+  mpc_clear (s);
+  mpc_clear (t);
+}
+
+int
+main (void)
+{
+  test_start ();
+
+  check_div ();
+  data_check_template ("inv.dsc", "inv.dat");
+
+  tgeneric_template ("inv.dsc", 2, 1024, 7, 4096);
+
+  test_end ();
+
+  return 0;
+}
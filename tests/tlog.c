@@ -20,6 +20,53 @@ along with this program. If not, see http://www.gnu.org/licenses/ .
 
 #include "mpc-tests.h"
 
+/* Compare the logarithm through the AGM, used by mpc_log at large
+   precisions, with the generic algorithm, whenever the former succeeds. */
+static void
+check_agm (void)
+{
+   mpc_t z, x, y;
+   mpfr_prec_t prec;
+   mpc_rnd_t rnd;
+   int i, inex_x, inex_y, ok = 0;
+
+   mpc_init2 (z, 2);
+   mpc_init2 (x, 2);
+   mpc_init2 (y, 2);
+   for (prec = 2; prec <= 400; prec += 7)
+      for (i = 0; i < 20; i++) {
+         mpc_set_prec (z, prec);
+         mpfr_set_prec (mpc_realref (x), prec);
+         mpfr_set_prec (mpc_imagref (x), 2 + (prec * (i + 1)) % 300);
+         mpfr_set_prec (mpc_realref (y), mpfr_get_prec (mpc_realref (x)));
+         mpfr_set_prec (mpc_imagref (y), mpfr_get_prec (mpc_imagref (x)));
+         test_default_random (z, -20, 20, 128, 25);
+         if (mpfr_zero_p (mpc_realref (z)) || mpfr_zero_p (mpc_imagref (z)))
+            continue;
+         rnd = MPC_RND (i % 4, (i / 4) % 4);
+         inex_y = mpc_log (y, z, rnd);
+         if (mpc_log_agm (x, z, rnd, &inex_x)) {
+            ok++;
+            if (inex_x != inex_y || mpc_cmp (x, y) != 0) {
+               printf ("Error in mpc_log_agm for rnd=(%s,%s)\n",
+                       mpfr_print_rnd_mode (MPC_RND_RE (rnd)),
+                       mpfr_print_rnd_mode (MPC_RND_IM (rnd)));
+               MPC_OUT (z);
+               MPC_OUT (x);
+               MPC_OUT (y);
+               exit (1);
+            }
+         }
+      }
+   if (ok == 0) {
+      printf ("Error: mpc_log_agm never succeeded\n");
+      exit (1);
+   }
+   mpc_clear (z);
+   mpc_clear (x);
+   mpc_clear (y);
+}
+
 #define MPC_FUNCTION_CALL                                               \
   P[0].mpc_inex = mpc_log (P[1].mpc, P[2].mpc, P[3].mpc_rnd)
 #define MPC_FUNCTION_CALL_REUSE_OP1                                     \
@@ -33,6 +80,8 @@ main (void)
 {
   test_start ();
 
+  check_agm ();
+
   data_check_template ("log.dsc", "log.dat");
 
   tgeneric_template ("log.dsc", 2, 512, 7, 128);
@@ -206,6 +206,159 @@ timemul (void)
 }
 #endif
 
+static void
+cmpmul_small (mpc_srcptr x, mpc_srcptr y, mpfr_prec_t prec, mpc_rnd_t rnd)
+   /* compares mpc_mul, which uses the exact kernels for operands of at most
+      two limbs, with mpc_mul_naive, for a result of precision prec */
+{
+   mpc_t z, t;
+   int   inex_z, inex_t;
+   known_signs_t ks = {1, 1};
+
+   mpc_init2 (z, prec);
+   mpc_init2 (t, prec);
+
+   inex_z = mpc_mul_naive (z, x, y, rnd);
+   inex_t = mpc_mul (t, x, y, rnd);
+
+   if (!same_mpc_value (z, t, ks) || inex_z != inex_t) {
+      fprintf (stderr, "mul_naive and mul differ for rnd=(%s,%s)\n",
+               mpfr_print_rnd_mode(MPC_RND_RE(rnd)),
+               mpfr_print_rnd_mode(MPC_RND_IM(rnd)));
+      MPC_OUT (x);
+      MPC_OUT (y);
+      MPC_OUT (z);
+      MPC_OUT (t);
+      fprintf (stderr, "inex (z): %s\n", MPC_INEX_STR (inex_z));
+      fprintf (stderr, "inex (t): %s\n", MPC_INEX_STR (inex_t));
+      exit (1);
+   }
+
+   mpc_clear (z);
+   mpc_clear (t);
+}
+
+static void
+check_small (void)
+{
+   mpc_t x, y;
+   mpfr_prec_t px, py;
+   int rnd_re, rnd_im, i;
+
+   mpc_init2 (x, 2);
+   mpc_init2 (y, 2);
+
+   for (px = 2; px <= 2 * GMP_NUMB_BITS; px += 9)
+      for (py = 2; py <= 2 * GMP_NUMB_BITS; py += 13) {
+         mpc_set_prec (x, px);
+         mpc_set_prec (y, py);
+         for (i = 0; i < 4; i++) {
+            /* exponents far apart, close, and in a small range */
+            test_default_random (x, (i == 0) ? -600 : -20,
+                                 (i == 0) ? 600 : 20, 128, 0);
+            test_default_random (y, (i == 0) ? -600 : -20,
+                                 (i == 0) ? 600 : 20, 128, 0);
+            if (i == 3) {
+               /* exact cancellation in the real part */
+               mpc_set_prec (y, px);
+               mpfr_set (mpc_realref (y), mpc_imagref (x), MPFR_RNDN);
+               mpfr_set (mpc_imagref (y), mpc_realref (x), MPFR_RNDN);
+            }
+            for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+               for (rnd_im = 0; rnd_im < 4; rnd_im ++) {
+                  cmpmul_small (x, y, px, MPC_RND (rnd_re, rnd_im));
+                  cmpmul_small (x, y, 3 * px + 1, MPC_RND (rnd_re, rnd_im));
+               }
+         }
+      }
+
+   mpc_clear (x);
+   mpc_clear (y);
+}
+
+static void
+check_karatsuba (void)
+   /* checks mpc_mul_karatsuba on operands with parts of very different
+      exponents, on products with cancellation, in place and with a
+      reduced exponent range */
+{
+  mpc_t x, y, z, t;
+  mpfr_prec_t prec;
+  mpfr_exp_t emin, emax;
+  int rnd_re, rnd_im, inex_z, inex_t;
+
+  mpc_init2 (x, 2);
+  mpc_init2 (y, 2);
+  mpc_init2 (z, 2);
+  mpc_init2 (t, 2);
+  for (prec = 53; prec <= 5000; prec = prec * 3 + 1)
+    {
+      mpc_set_prec (x, prec);
+      mpc_set_prec (y, prec);
+      mpc_set_prec (z, prec);
+      mpc_set_prec (t, prec);
+
+      /* unbalanced operands */
+      test_default_random (x, -1, 1, 128, 0);
+      test_default_random (y, -1, 1, 128, 0);
+      mpfr_mul_2si (mpc_imagref (x), mpc_imagref (x), -2 * prec, MPFR_RNDN);
+      mpfr_mul_2si (mpc_realref (y), mpc_realref (y), -prec / 3, MPFR_RNDN);
+      for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+        for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+          cmpmul (x, y, MPC_RND (rnd_re, rnd_im));
+
+      /* y is close to conj(x), so that the imaginary part cancels */
+      test_default_random (x, -1, 1, 128, 0);
+      mpc_conj (y, x, MPC_RNDNN);
+      mpfr_nextabove (mpc_imagref (y));
+      for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+        for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+          cmpmul (x, y, MPC_RND (rnd_re, rnd_im));
+      /* the real part cancels, and the imaginary part is exactly 2 */
+      mpc_set_ui_ui (x, 1, 1, MPC_RNDNN);
+      mpc_set_ui_ui (y, 1, 1, MPC_RNDNN);
+      mpfr_nextabove (mpc_realref (y));
+      cmpmul (x, y, MPC_RNDDU);
+
+      /* in place */
+      test_default_random (x, -10, 10, 128, 0);
+      test_default_random (y, -10, 10, 128, 0);
+      inex_z = mpc_mul_naive (z, x, y, MPC_RNDZU);
+      mpc_set (t, x, MPC_RNDNN);
+      inex_t = mpc_mul_karatsuba (t, t, y, MPC_RNDZU);
+      if (mpc_cmp (z, t) != 0 || inex_z != inex_t)
+        {
+          fprintf (stderr, "mpc_mul_karatsuba in place differs from "
+                   "mpc_mul_naive\n");
+          MPC_OUT (x);
+          MPC_OUT (y);
+          MPC_OUT (z);
+          MPC_OUT (t);
+          exit (1);
+        }
+
+      /* overflow and underflow of the result */
+      emin = mpfr_get_emin ();
+      emax = mpfr_get_emax ();
+      test_default_random (x, 90, 100, 128, 0);
+      test_default_random (y, 90, 100, 128, 0);
+      mpfr_set_emax (150);
+      for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+        cmpmul (x, y, MPC_RND (rnd_re, 3 - rnd_re));
+      mpfr_set_emax (emax);
+      test_default_random (x, -100, -90, 128, 0);
+      test_default_random (y, -100, -90, 128, 0);
+      mpfr_set_emin (-150);
+      for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+        cmpmul (x, y, MPC_RND (rnd_re, 3 - rnd_re));
+      mpfr_set_emin (emin);
+    }
+  mpc_clear (x);
+  mpc_clear (y);
+  mpc_clear (z);
+  mpc_clear (t);
+}
+
 #define MPC_FUNCTION_CALL                                               \
   P[0].mpc_inex = mpc_mul (P[1].mpc, P[2].mpc, P[3].mpc, P[4].mpc_rnd)
 #define MPC_FUNCTION_CALL_SYMMETRIC                                     \
@@ -229,6 +382,8 @@ main (void)
 
   bug20200206 ();
   check_regular ();
+  check_small ();
+  check_karatsuba ();
 
   data_check_template ("mul.dsc", "mul.dat");
 
@@ -0,0 +1,293 @@
+/* tpool -- Test file for the pool of temporary variables.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+/* compute a few functions using the pool at precision prec */
+static void
+compute (mpc_ptr *r, mpc_srcptr z, mpc_srcptr w)
+{
+  mpc_exp (r[0], z, MPC_RNDNN);
+  mpc_div (r[1], z, w, MPC_RNDZZ);
+  mpc_sin_cos (r[2], r[3], z, MPC_RNDNN, MPC_RNDUD);
+  mpc_tan (r[4], w, MPC_RNDNN);
+  mpc_asin (r[5], z, MPC_RNDDU);
+  mpc_log10 (r[6], w, MPC_RNDNN);
+  mpc_pow (r[7], z, w, MPC_RNDNN);
+}
+
+#define N 8
+
+static void
+check_steady_state (mpfr_prec_t prec)
+{
+  mpc_t z, w, a[N], b[N];
+  mpc_ptr ra[N], rb[N];
+  unsigned long hits, misses;
+  int i, k;
+
+  mpc_init2 (z, prec);
+  mpc_init2 (w, prec);
+  mpc_set_ui_ui (z, 3, 1, MPC_RNDNN);
+  mpc_div_ui (z, z, 7, MPC_RNDNN);
+  mpc_set_si_si (w, -5, 11, MPC_RNDNN);
+  mpc_div_ui (w, w, 13, MPC_RNDNN);
+  for (i = 0; i < N; i++)
+    {
+      mpc_init2 (a[i], prec);
+      mpc_init2 (b[i], prec);
+      ra[i] = a[i];
+      rb[i] = b[i];
+    }
+
+  /* the first call fills the pool */
+  compute (ra, z, w);
+
+  mpc_reset_pool_stats ();
+  for (k = 0; k < 10; k++)
+    compute (rb, z, w);
+  mpc_get_pool_stats (&hits, &misses);
+
+  /* if the pool is enabled, the following calls must not allocate */
+  if (hits != 0 && misses != 0)
+    {
+      printf ("Error in pool: %lu misses in steady state at precision %lu\n",
+              misses, (unsigned long) prec);
+      exit (1);
+    }
+
+  /* reusing buffers must not change the results */
+  for (i = 0; i < N; i++)
+    if (mpc_cmp (a[i], b[i]) != 0)
+      {
+        printf ("Error in pool: results differ for function %d "
+                "at precision %lu\n", i, (unsigned long) prec);
+        MPC_OUT (a[i]);
+        MPC_OUT (b[i]);
+        exit (1);
+      }
+
+  /* neither must emptying the pool */
+  mpc_free_pool ();
+  compute (rb, z, w);
+  for (i = 0; i < N; i++)
+    if (mpc_cmp (a[i], b[i]) != 0)
+      {
+        printf ("Error in pool: results differ for function %d "
+                "after mpc_free_pool at precision %lu\n",
+                i, (unsigned long) prec);
+        MPC_OUT (a[i]);
+        MPC_OUT (b[i]);
+        exit (1);
+      }
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_clear (a[i]);
+      mpc_clear (b[i]);
+    }
+  mpc_clear (z);
+  mpc_clear (w);
+}
+
+/* check that the _ws functions give the same results as the usual ones,
+   and do not allocate once their workspace is warm */
+static void
+check_workspace (mpfr_prec_t prec)
+{
+  mpc_t z, w, a, b, c, d;
+  mpc_ptr x[2];
+  mpc_workspace_t ws;
+  unsigned long hits, misses;
+  int k;
+
+  mpc_workspace_init (ws, prec);
+  mpc_init2 (z, prec);
+  mpc_init2 (w, prec);
+  mpc_init2 (a, prec);
+  mpc_init2 (b, prec);
+  mpc_init2 (c, prec);
+  mpc_init2 (d, prec);
+  mpc_set_ui_ui (z, 3, 1, MPC_RNDNN);
+  mpc_div_ui (z, z, 7, MPC_RNDNN);
+  mpc_set_si_si (w, -5, 11, MPC_RNDNN);
+  mpc_div_ui (w, w, 13, MPC_RNDNN);
+  x[0] = z;
+  x[1] = w;
+
+  for (k = 0; k < 2; k++)
+    {
+#define CHECK(f, g)                                                     \
+      do {                                                              \
+        f;                                                              \
+        g;                                                              \
+        if (mpc_cmp (a, b) != 0)                                        \
+          {                                                             \
+            printf ("Error in " #f " at precision %lu\n",               \
+                    (unsigned long) prec);                              \
+            MPC_OUT (a);                                                \
+            MPC_OUT (b);                                                \
+            exit (1);                                                   \
+          }                                                             \
+      } while (0)
+
+      CHECK (mpc_mul_ws (a, z, w, MPC_RNDNN, ws),
+             mpc_mul (b, z, w, MPC_RNDNN));
+      CHECK (mpc_div_ws (a, z, w, MPC_RNDZU, ws),
+             mpc_div (b, z, w, MPC_RNDZU));
+      CHECK (mpc_exp_ws (a, w, MPC_RNDNN, ws),
+             mpc_exp (b, w, MPC_RNDNN));
+      CHECK (mpc_sin_cos_ws (a, c, z, MPC_RNDNN, MPC_RNDNN, ws),
+             mpc_sin_cos (b, d, z, MPC_RNDNN, MPC_RNDNN));
+      CHECK (mpc_pow_ws (a, z, w, MPC_RNDDN, ws),
+             mpc_pow (b, z, w, MPC_RNDDN));
+      CHECK (mpc_pow_ui_ws (a, z, 1234567, MPC_RNDNN, ws),
+             mpc_pow_ui (b, z, 1234567, MPC_RNDNN));
+      CHECK (mpc_pow_si_ws (a, w, -17, MPC_RNDNN, ws),
+             mpc_pow_si (b, w, -17, MPC_RNDNN));
+      CHECK (mpc_dot_ws (a, x, x, 2, MPC_RNDNN, ws),
+             mpc_dot (b, x, x, 2, MPC_RNDNN));
+      if (mpc_cmp (c, d) != 0)
+        {
+          printf ("Error in mpc_sin_cos_ws at precision %lu\n",
+                  (unsigned long) prec);
+          exit (1);
+        }
+    }
+
+  /* once warm, the workspace serves all requests */
+  mpc_reset_pool_stats ();
+  mpc_exp_ws (a, w, MPC_RNDNN, ws);
+  mpc_div_ws (a, z, w, MPC_RNDNN, ws);
+  mpc_pow_ui_ws (a, z, 1234567, MPC_RNDNN, ws);
+  mpc_get_pool_stats (&hits, &misses);
+  if (hits != 0 && misses != 0)
+    {
+      printf ("Error in workspace: %lu misses in steady state at precision "
+              "%lu\n", misses, (unsigned long) prec);
+      exit (1);
+    }
+
+  mpc_clear (z);
+  mpc_clear (w);
+  mpc_clear (a);
+  mpc_clear (b);
+  mpc_clear (c);
+  mpc_clear (d);
+  mpc_workspace_clear (ws);
+}
+
+/* GMP memory functions counting the memory in use */
+static long live;
+static void * (*saved_alloc) (size_t);
+static void * (*saved_realloc) (void *, size_t, size_t);
+static void (*saved_free) (void *, size_t);
+
+static void *
+count_alloc (size_t n)
+{
+  live += (long) n;
+  return (*saved_alloc) (n);
+}
+
+static void *
+count_realloc (void *p, size_t old, size_t n)
+{
+  live += (long) n - (long) old;
+  return (*saved_realloc) (p, old, n);
+}
+
+static void
+count_free (void *p, size_t n)
+{
+  live -= (long) n;
+  (*saved_free) (p, n);
+}
+
+/* the pool of a thread keeps at most 65536 limbs after computations at a
+   precision of about 2^20 bits, where the Ziv loops of mpc_div and
+   mpc_sqrt use several buffers of 2^15 limbs */
+static void
+check_bound (void)
+{
+  mpc_t z, w, a, b, c;
+  long before;
+
+  mp_get_memory_functions (&saved_alloc, &saved_realloc, &saved_free);
+  mp_set_memory_functions (count_alloc, count_realloc, count_free);
+  mpc_free_pool ();
+  mpfr_free_cache ();
+  before = live;
+
+  mpc_init2 (z, 1000000);
+  mpc_init2 (w, 1000000);
+  mpc_init2 (a, 1000000);
+  mpc_init2 (b, 1000000);
+  mpc_init2 (c, 1000000);
+  mpc_set_ui_ui (z, 3, 1, MPC_RNDNN);
+  mpc_div_ui (z, z, 7, MPC_RNDNN);
+  mpc_set_si_si (w, -5, 11, MPC_RNDNN);
+  mpc_div_ui (w, w, 13, MPC_RNDNN);
+  mpc_mul (a, z, w, MPC_RNDNN);
+  mpc_div (b, z, w, MPC_RNDZZ);
+  mpc_sqrt (c, w, MPC_RNDNN);
+  mpc_clear (z);
+  mpc_clear (w);
+  mpc_clear (a);
+  mpc_clear (b);
+  mpc_clear (c);
+  mpfr_free_cache ();
+  if (live - before > 65536 * (long) sizeof (mp_limb_t))
+    {
+      printf ("Error in pool: %ld bytes kept after mpc_div at precision "
+              "1000000\n", live - before);
+      exit (1);
+    }
+
+  mpc_free_pool ();
+  if (live != before)
+    {
+      printf ("Error in pool: %ld bytes kept after mpc_free_pool\n",
+              live - before);
+      exit (1);
+    }
+  mp_set_memory_functions (saved_alloc, saved_realloc, saved_free);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t prec;
+
+  test_start ();
+
+  for (prec = 2; prec <= 1024; prec += prec / 2 + 1)
+    {
+      check_steady_state (prec);
+      check_workspace (prec);
+    }
+
+  mpc_free_pool ();
+  check_bound ();
+
+  test_end ();
+
+  return 0;
+}
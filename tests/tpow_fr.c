@@ -47,6 +47,54 @@ test_reuse (void)
   mpc_clear (z);
 }
 
+/* compare mpc_pow_fr, which computes x^y in polar form for y real, with
+   mpc_pow_ui and mpc_pow_si for integer exponents */
+static void
+compare_pow_si (void)
+{
+  mpc_t x, z, zz;
+  mpfr_t y;
+  mpfr_prec_t prec;
+  long n;
+  int i, r, inex, inex_ref;
+  known_signs_t ks = {1, 1};
+
+  mpfr_init2 (y, 64);
+  for (prec = 2; prec <= 300; prec += 37)
+    {
+      mpc_init2 (x, prec);
+      mpc_init2 (z, prec);
+      mpc_init2 (zz, prec);
+      for (i = 0; i < 10; i++)
+        {
+          test_default_random (x, -4, 4, 128, 0);
+          for (n = -1000003; n <= 1000003; n += 142857)
+            for (r = 0; r <= 4; r++)
+              {
+                mpc_rnd_t rnd = MPC_RND (r, 4 - r);
+
+                mpfr_set_si (y, n, MPFR_RNDN);
+                inex = mpc_pow_fr (z, x, y, rnd);
+                inex_ref = mpc_pow_si (zz, x, n, rnd);
+                if (inex != inex_ref || !same_mpc_value (z, zz, ks))
+                  {
+                    printf ("mpc_pow_fr and mpc_pow_si differ for n=%ld\n",
+                            n);
+                    MPC_OUT (x);
+                    MPC_OUT (z);
+                    MPC_OUT (zz);
+                    printf ("inex = %d, expected %d\n", inex, inex_ref);
+                    exit (1);
+                  }
+              }
+        }
+      mpc_clear (x);
+      mpc_clear (z);
+      mpc_clear (zz);
+    }
+  mpfr_clear (y);
+}
+
 #define MPC_FUNCTION_CALL                                               \
   P[0].mpc_inex = mpc_pow_fr (P[1].mpc, P[2].mpc, P[3].mpfr, P[4].mpc_rnd)
 #define MPC_FUNCTION_CALL_REUSE_OP1                                     \
@@ -65,6 +113,7 @@ main (void)
   data_check_template ("pow_fr.dsc", "pow_fr.dat");
 
   tgeneric_template ("pow_fr.dsc", 2, 1024, 7, 10);
+  compare_pow_si ();
 
   test_end ();
 
@@ -0,0 +1,175 @@
+/* tpow_table -- test file for mpc_pow_table.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+#define N 70
+
+static mpc_t a[N + 1], b;
+static int inex[N + 1];
+
+/* compare a[0..n] with the powers of x computed by mpc_pow_ui */
+static void
+check_table (mpc_ptr x, unsigned long n, mpc_rnd_t rnd)
+{
+  known_signs_t ks = {1, 1};
+  unsigned long i;
+  int inex_ref;
+
+  for (i = 0; i <= n; i++)
+    {
+      mpc_set_prec (b, MPC_PREC_RE (a[i]));
+      inex_ref = mpc_pow_ui (b, x, i, rnd);
+      if (!same_mpc_value (a[i], b, ks) || inex[i] != inex_ref)
+        {
+          printf ("Error in mpc_pow_table for power %lu of %lu, rnd=(%s,%s)\n",
+                  i, n, mpfr_print_rnd_mode (MPC_RND_RE (rnd)),
+                  mpfr_print_rnd_mode (MPC_RND_IM (rnd)));
+          MPC_OUT (x);
+          MPC_OUT (a[i]);
+          MPC_OUT (b);
+          printf ("inex got %d, expected %d\n", inex[i], inex_ref);
+          exit (1);
+        }
+    }
+}
+
+/* powers of x with various precisions of the entries */
+static void
+check_prec (mpc_ptr x, mpfr_prec_t prec, unsigned long n, mpc_rnd_t rnd)
+{
+  unsigned long i;
+
+  for (i = 0; i <= n; i++)
+    mpc_set_prec (a[i], prec + (i % 7));
+  mpc_pow_table (a[0], x, n, inex, rnd);
+  check_table (x, n, rnd);
+}
+
+static void
+check_random (void)
+{
+  mpc_t x;
+  mpfr_prec_t prec;
+  mpfr_exp_t emin, emax;
+  int i, r;
+
+  mpc_init2 (x, 2);
+  for (prec = 2; prec <= 300; prec += 47)
+    for (i = 0; i < 10; i++)
+      for (r = 0; r <= 4; r++)
+        {
+          mpc_rnd_t rnd = MPC_RND (r, 4 - r);
+
+          mpc_set_prec (x, prec);
+          test_default_random (x, -20, 20, 128, 25);
+          check_prec (x, prec, N, rnd);
+          check_prec (x, prec, i, rnd);
+          /* results out of the exponent range */
+          emin = mpfr_get_emin ();
+          emax = mpfr_get_emax ();
+          mpfr_set_emin (-100);
+          mpfr_set_emax (100);
+          check_prec (x, prec, N, rnd);
+          mpfr_set_emin (emin);
+          mpfr_set_emax (emax);
+        }
+  mpc_clear (x);
+}
+
+static void
+check_special (void)
+{
+  mpc_t x;
+  int r;
+
+  mpc_init2 (x, 53);
+  for (r = 0; r <= 4; r++)
+    {
+      mpc_rnd_t rnd = MPC_RND (r, 4 - r);
+
+      /* exact powers */
+      mpc_set_si_si (x, 1, -1, MPC_RNDNN);
+      check_prec (x, 2, N, rnd);
+      check_prec (x, 53, N, rnd);
+      mpc_set_si_si (x, 3, 2, MPC_RNDNN);
+      mpc_div_2ui (x, x, 1, MPC_RNDNN);
+      check_prec (x, 53, N, rnd);
+      /* a zero part */
+      mpc_set_si_si (x, 0, 3, MPC_RNDNN);
+      check_prec (x, 30, N, rnd);
+      mpc_set_si_si (x, -3, 0, MPC_RNDNN);
+      mpc_div_2ui (x, x, 1, MPC_RNDNN);
+      check_prec (x, 30, N, rnd);
+      /* non-finite parts */
+      mpc_set_si_si (x, 1, 1, MPC_RNDNN);
+      mpfr_set_inf (mpc_realref (x), -1);
+      check_prec (x, 30, N, rnd);
+      mpfr_set_nan (mpc_imagref (x));
+      check_prec (x, 30, N, rnd);
+    }
+  mpc_clear (x);
+}
+
+/* op is an element of rop */
+static void
+check_inplace (void)
+{
+  mpc_t x;
+  unsigned long i;
+
+  mpc_init2 (x, 100);
+  for (i = 0; i <= N; i++)
+    mpc_set_prec (a[i], 100);
+  test_default_random (x, -5, 5, 128, 0);
+  mpc_set (a[1], x, MPC_RNDNN);
+  mpc_pow_table (a[0], a[1], N, inex, MPC_RNDZU);
+  check_table (x, N, MPC_RNDZU);
+  mpc_set (a[N], x, MPC_RNDNN);
+  mpc_pow_table (a[0], a[N], N, inex, MPC_RNDZU);
+  check_table (x, N, MPC_RNDZU);
+  /* inex may be NULL */
+  mpc_pow_table (a[0], x, N, NULL, MPC_RNDNN);
+  mpc_clear (x);
+}
+
+int
+main (void)
+{
+  int i;
+
+  test_start ();
+
+  for (i = 0; i <= N; i++)
+    mpc_init2 (a[i], 2);
+  mpc_init2 (b, 2);
+
+  check_special ();
+  check_random ();
+  check_inplace ();
+
+  for (i = 0; i <= N; i++)
+    mpc_clear (a[i]);
+  mpc_clear (b);
+
+  test_end ();
+
+  return 0;
+}
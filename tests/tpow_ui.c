@@ -73,6 +73,60 @@ compare_mpc_pow (mpfr_prec_t pmax, int iter, unsigned long nbits)
   mpc_clear (y);
 }
 
+/* compare mpc_pow_ui and mpc_pow_si with mpc_pow on Gaussian integers,
+   whose powers are exact for small exponents, so that they are computed
+   exactly or rounded from an approximation depending on the precision */
+static void
+compare_exact (void)
+{
+  mpfr_prec_t p;
+  mpc_t x, y, z, t;
+  long a, b;
+  unsigned long n;
+  int r, inex_pow, inex_pow_ui;
+  mpc_rnd_t rnd;
+
+  mpc_init3 (y, sizeof (unsigned long) * CHAR_BIT, MPFR_PREC_MIN);
+  mpc_init2 (x, 4);
+  for (p = 2; p <= 130; p += 32)
+    {
+      mpc_init2 (z, p);
+      mpc_init2 (t, p);
+      for (a = -3; a <= 3; a++)
+        for (b = 1; b <= 3; b++)
+          for (n = 3; n <= 60; n += 19)
+            for (r = 0; r <= 4; r++)
+              {
+                rnd = MPC_RND (r, 4 - r);
+                mpc_set_si_si (x, a == 0 ? 1 : a, b, MPC_RNDNN);
+                mpc_set_ui (y, n, MPC_RNDNN);
+                inex_pow = mpc_pow (z, x, y, rnd);
+                inex_pow_ui = mpc_pow_ui (t, x, n, rnd);
+                if (mpc_cmp (z, t) != 0 || inex_pow != inex_pow_ui)
+                  {
+                    printf ("mpc_pow and mpc_pow_ui differ for x=");
+                    mpc_out_str (stdout, 10, 0, x, MPC_RNDNN);
+                    printf (" n=%lu\n", n);
+                    exit (1);
+                  }
+                mpc_set_si (y, -(long) n, MPC_RNDNN);
+                inex_pow = mpc_pow (z, x, y, rnd);
+                inex_pow_ui = mpc_pow_si (t, x, -(long) n, rnd);
+                if (mpc_cmp (z, t) != 0 || inex_pow != inex_pow_ui)
+                  {
+                    printf ("mpc_pow and mpc_pow_si differ for x=");
+                    mpc_out_str (stdout, 10, 0, x, MPC_RNDNN);
+                    printf (" n=-%lu\n", n);
+                    exit (1);
+                  }
+              }
+      mpc_clear (z);
+      mpc_clear (t);
+    }
+  mpc_clear (x);
+  mpc_clear (y);
+}
+
 #define MPC_FUNCTION_CALL                                               \
   P[0].mpc_inex = mpc_pow_ui (P[1].mpc, P[2].mpc, P[3].ui, P[4].mpc_rnd)
 #define MPC_FUNCTION_CALL_REUSE_OP1                                     \
@@ -117,6 +171,9 @@ main (int argc, char *argv[])
   data_check_template ("pow_ui.dsc", "pow_ui.dat");
 
   compare_mpc_pow (100, 5, 19);
+  /* exponents of up to 40 bits use larger windows */
+  compare_mpc_pow (30, 2, 40);
+  compare_exact ();
 
   test_end ();
 
@@ -43,6 +43,159 @@ test_large (void)
   mpz_clear (t);
 }
 
+/* compare mpc_pow_z with mpc_pow for exponents not fitting in a long and
+   bases close to the unit circle, for which the result may be in the
+   exponent range, and for random bases */
+static void
+compare_mpc_pow (void)
+{
+  mpc_t x, z, zz, y;
+  mpfr_t theta;
+  mpz_t t;
+  mpfr_prec_t prec, l;
+  int i, r, s, inex, inex_ref;
+  known_signs_t ks = {1, 1};
+
+  mpz_init (t);
+  for (prec = 2; prec <= 150; prec += 37)
+    {
+      mpc_init2 (x, prec);
+      mpc_init2 (z, prec);
+      mpc_init2 (zz, prec);
+      mpfr_init2 (theta, prec);
+      for (i = 0; i < 6; i++)
+        for (l = sizeof (long) * CHAR_BIT + 1; l <= 2 * prec + 80;
+             l += prec / 2 + 13)
+          for (s = -1; s <= 1; s += 2)
+            {
+              if (i < 4)
+                {
+                  mpfr_urandomb (theta, rands);
+                  mpfr_mul_ui (theta, theta, 7, MPFR_RNDN);
+                  mpfr_sin_cos (mpc_imagref (x), mpc_realref (x), theta,
+                                MPFR_RNDN);
+                }
+              else
+                test_default_random (x, -3, 3, 128, 0);
+              mpz_urandomb (t, rands, l);
+              mpz_setbit (t, l - 1);
+              if (s < 0)
+                mpz_neg (t, t);
+              mpc_init3 (y, l, MPFR_PREC_MIN);
+              mpc_set_z (y, t, MPC_RNDNN);
+              for (r = 0; r <= 4; r++)
+                {
+                  mpc_rnd_t rnd = MPC_RND (r, 4 - r);
+
+                  inex_ref = mpc_pow (zz, x, y, rnd);
+                  inex = mpc_pow_z (z, x, t, rnd);
+                  if (inex != inex_ref || !same_mpc_value (z, zz, ks))
+                    {
+                      printf ("mpc_pow and mpc_pow_z differ for\n");
+                      MPC_OUT (x);
+                      printf ("y=");
+                      mpz_out_str (stdout, 10, t);
+                      printf ("\n");
+                      MPC_OUT (z);
+                      MPC_OUT (zz);
+                      printf ("inex = %d, expected %d\n", inex, inex_ref);
+                      exit (1);
+                    }
+                }
+              mpc_clear (y);
+            }
+      mpc_clear (x);
+      mpc_clear (z);
+      mpc_clear (zz);
+      mpfr_clear (theta);
+    }
+  mpz_clear (t);
+}
+
+/* compare mpc_pow_z with mpc_pow for negative exponents in
+   (-2^(CHAR_BIT*sizeof(long)), LONG_MIN), which are passed as unsigned
+   long with a negative sign, for bases of modulus larger than 1 and
+   close to 1 */
+static void
+test_below_long_min (void)
+{
+  mpc_t x, z, zz, y;
+  mpz_t t;
+  int i, j, r, inex, inex_ref;
+  known_signs_t ks = {1, 1};
+
+  mpc_init2 (x, 53);
+  mpc_init2 (z, 53);
+  mpc_init2 (zz, 53);
+  mpc_init3 (y, sizeof (long) * CHAR_BIT, MPFR_PREC_MIN);
+  mpz_init (t);
+  for (i = 0; i < 4; i++)
+    {
+      if (i == 0)
+        mpc_set_ui_ui (x, 3ul, 1ul, MPC_RNDNN);
+      else if (i == 1)
+        {
+          /* 1 + 2^-11*i */
+          mpc_set_ui_ui (x, 1ul, 1ul, MPC_RNDNN);
+          mpfr_div_2ui (mpc_imagref (x), mpc_imagref (x), 11, MPFR_RNDN);
+        }
+      else if (i == 2)
+        {
+          /* 1 - 2^-30 + 2^-20*i */
+          mpc_set_ui_ui (x, 1ul, 1ul, MPC_RNDNN);
+          mpfr_div_2ui (mpc_imagref (x), mpc_imagref (x), 20, MPFR_RNDN);
+          mpfr_set_ui_2exp (mpc_realref (zz), 1ul, -30, MPFR_RNDN);
+          mpfr_sub (mpc_realref (x), mpc_realref (x), mpc_realref (zz),
+                    MPFR_RNDN);
+        }
+      else
+        test_default_random (x, -3, 3, 128, 0);
+      for (j = 0; j < 4; j++)
+        {
+          if (j == 0)
+            {
+              /* 2^(CHAR_BIT*sizeof(long)-1) + 5 */
+              mpz_set_ui (t, 1ul);
+              mpz_mul_2exp (t, t, sizeof (long) * CHAR_BIT - 1);
+              mpz_add_ui (t, t, 5ul);
+            }
+          else if (j == 1 && sizeof (long) * CHAR_BIT == 64)
+            mpz_set_str (t, "9516902796259510887", 10);
+          else
+            {
+              mpz_urandomb (t, rands, sizeof (long) * CHAR_BIT);
+              mpz_setbit (t, sizeof (long) * CHAR_BIT - 1);
+            }
+          mpz_neg (t, t);
+          mpc_set_z (y, t, MPC_RNDNN);
+          for (r = 0; r <= 4; r++)
+            {
+              mpc_rnd_t rnd = MPC_RND (r, 4 - r);
+
+              inex_ref = mpc_pow (zz, x, y, rnd);
+              inex = mpc_pow_z (z, x, t, rnd);
+              if (inex != inex_ref || !same_mpc_value (z, zz, ks))
+                {
+                  printf ("mpc_pow and mpc_pow_z differ for\n");
+                  MPC_OUT (x);
+                  printf ("y=");
+                  mpz_out_str (stdout, 10, t);
+                  printf ("\n");
+                  MPC_OUT (z);
+                  MPC_OUT (zz);
+                  printf ("inex = %d, expected %d\n", inex, inex_ref);
+                  exit (1);
+                }
+            }
+        }
+    }
+  mpc_clear (x);
+  mpc_clear (z);
+  mpc_clear (zz);
+  mpc_clear (y);
+  mpz_clear (t);
+}
+
 #define MPC_FUNCTION_CALL                                               \
   P[0].mpc_inex = mpc_pow_z (P[1].mpc, P[2].mpc, P[3].mpz, P[4].mpc_rnd)
 #define MPC_FUNCTION_CALL_REUSE_OP1                                     \
@@ -53,11 +206,23 @@ test_large (void)
 int
 main (void)
 {
+  mpfr_exp_t emin, emax;
+
   test_start ();
 
   data_check_template ("pow_z.dsc", "pow_z.dat");
 
   test_large ();
+  test_below_long_min ();
+  compare_mpc_pow ();
+  /* more results in the largest exponent range */
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  mpfr_set_emin (mpfr_get_emin_min ());
+  mpfr_set_emax (mpfr_get_emax_max ());
+  compare_mpc_pow ();
+  mpfr_set_emin (emin);
+  mpfr_set_emax (emax);
 
   test_end ();
 
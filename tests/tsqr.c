@@ -164,6 +164,62 @@ reuse_bug (void)
   mpc_clear (z1);
 }
 
+/* x+y underflows in the Karatsuba squaring of large operands, while
+   x^2-y^2 does not; and x*y is rounded down while 2*x*y overflows */
+static void
+check_range (void)
+{
+  mpfr_exp_t emin = mpfr_get_emin (), emax = mpfr_get_emax ();
+  mpc_t x, z;
+  int inex;
+
+  mpc_init2 (x, 3000);
+  mpc_init2 (z, 3000);
+
+  /* x = 2^40 + 2^-110 - i*2^40, x^2 = 2^-69 + 2^-220 - i*(2^81 + 2^-69) */
+  mpfr_set_ui_2exp (mpc_realref (x), 1, -150, MPFR_RNDN);
+  mpfr_add_ui (mpc_realref (x), mpc_realref (x), 1, MPFR_RNDN);
+  mpfr_mul_2ui (mpc_realref (x), mpc_realref (x), 40, MPFR_RNDN);
+  mpfr_set_si_2exp (mpc_imagref (x), -1, 40, MPFR_RNDN);
+  mpfr_set_emin (-100);
+  mpfr_set_emax (100);
+  inex = mpc_sqr (z, x, MPC_RNDNN);
+  mpfr_set_emin (emin);
+  mpfr_set_emax (emax);
+  mpfr_mul_2ui (mpc_realref (z), mpc_realref (z), 69, MPFR_RNDN);
+  mpfr_sub_ui (mpc_realref (z), mpc_realref (z), 1, MPFR_RNDN);
+  if (mpfr_cmp_ui_2exp (mpc_realref (z), 1, -151) != 0 || inex != 0)
+    {
+      printf ("Error in mpc_sqr for an underflow in x+y\n");
+      MPC_OUT (x);
+      exit (1);
+    }
+
+  /* x = (1-2^-200)*2^50 * (1+i) */
+  mpc_set_prec (x, 200);
+  mpc_set_prec (z, 200);
+  mpc_set_ui_ui (x, 1, 1, MPC_RNDNN);
+  mpc_mul_2ui (x, x, 50, MPC_RNDNN);
+  mpfr_nextbelow (mpc_realref (x));
+  mpfr_nextbelow (mpc_imagref (x));
+  mpfr_set_emin (-100);
+  mpfr_set_emax (100);
+  inex = mpc_sqr (z, x, MPC_RNDNN);
+  mpfr_set_emin (emin);
+  mpfr_set_emax (emax);
+  if (!mpfr_zero_p (mpc_realref (z)) || !mpfr_inf_p (mpc_imagref (z))
+      || MPC_INEX_RE (inex) != 0 || MPC_INEX_IM (inex) <= 0)
+    {
+      printf ("Error in mpc_sqr for an overflow in 2*x*y\n");
+      MPC_OUT (z);
+      printf ("inex = (%i, %i)\n", MPC_INEX_RE (inex), MPC_INEX_IM (inex));
+      exit (1);
+    }
+
+  mpc_clear (x);
+  mpc_clear (z);
+}
+
 #define MPC_FUNCTION_CALL                                       \
   P[0].mpc_inex = mpc_sqr (P[1].mpc, P[2].mpc, P[3].mpc_rnd)
 #define MPC_FUNCTION_CALL_REUSE_OP1                             \
@@ -192,6 +248,7 @@ main (void)
   tgeneric_template ("sqr.dsc", 2, 1024, 1, 1024);
 
   reuse_bug ();
+  check_range ();
 
   test_end ();
 
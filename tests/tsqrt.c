@@ -61,12 +61,73 @@ bug20200207 (void)
   mpfr_set_emax (emax);
 }
 
+/* compare the double-double evaluation for small precisions with the
+   generic code, which is used when the exponent range is reduced */
+static void
+check_fp (void)
+{
+  mpfr_exp_t emin = mpfr_get_emin ();
+  mpfr_exp_t emax = mpfr_get_emax ();
+  mpfr_prec_t prec;
+  mpc_t x, z, zr;
+  int i, rnd_re, rnd_im, inex, inex_r;
+  known_signs_t ks = {1, 1};
+
+  mpc_init2 (x, 2);
+  mpc_init2 (z, 2);
+  mpc_init2 (zr, 2);
+  for (prec = 2; prec <= 53; prec++)
+    {
+      mpc_set_prec (x, prec);
+      mpc_set_prec (z, prec);
+      mpc_set_prec (zr, prec);
+      for (i = 0; i < 4; i++)
+        {
+          if (i == 0)
+            {
+              /* exact square root */
+              mpc_set_si_si (z, (long) prec - 27, 3 - (long) prec, MPC_RNDNN);
+              mpc_sqr (x, z, MPC_RNDNN);
+            }
+          else
+            test_default_random (x, -300, 300, 128, 0);
+          for (rnd_re = 0; rnd_re < 4; rnd_re ++)
+            for (rnd_im = 0; rnd_im < 4; rnd_im ++)
+              {
+                inex = mpc_sqrt (z, x, MPC_RND (rnd_re, rnd_im));
+                mpfr_set_emin (-700);
+                mpfr_set_emax (700);
+                inex_r = mpc_sqrt (zr, x, MPC_RND (rnd_re, rnd_im));
+                mpfr_set_emin (emin);
+                mpfr_set_emax (emax);
+                if (!same_mpc_value (z, zr, ks) || inex != inex_r)
+                  {
+                    printf ("Error in mpc_sqrt for small precision and "
+                            "rnd=(%s,%s)\n",
+                            mpfr_print_rnd_mode (rnd_re),
+                            mpfr_print_rnd_mode (rnd_im));
+                    MPC_OUT (x);
+                    MPC_OUT (z);
+                    MPC_OUT (zr);
+                    printf ("inex got %s, expected %s\n", MPC_INEX_STR (inex),
+                            MPC_INEX_STR (inex_r));
+                    exit (1);
+                  }
+              }
+        }
+    }
+  mpc_clear (x);
+  mpc_clear (z);
+  mpc_clear (zr);
+}
+
 int
 main (void)
 {
   test_start ();
 
   bug20200207 ();
+  check_fp ();
   data_check_template ("sqrt.dsc", "sqrt.dat");
 
   tgeneric_template ("sqrt.dsc", 2, 1024, 7, 256);
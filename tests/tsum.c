@@ -55,12 +55,81 @@ check_special (void)
   mpc_clear (res);
 }
 
+/* compare mpc_sum_mt with mpc_sum on long arrays, for several numbers of
+   threads: random terms, terms of alternating signs cancelling exactly,
+   and random terms between two huge opposite ones, so that the partial
+   sums of the threads do not allow to round their sum */
+static void
+check_mt (void)
+{
+  /* N terms give MPC_MT_CHUNK_MIN = 1024 terms to each of 6 threads */
+#define N 6144
+  static mpc_t z[N];
+  static mpc_ptr t[N];
+  mpc_t res, ref;
+  known_signs_t ks = {1, 1};
+  mpfr_prec_t prec;
+  mpc_rnd_t rnd;
+  unsigned int threads;
+  int i, kind, r, inex, inex_ref;
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_init2 (z[i], 2);
+      t[i] = z[i];
+    }
+  for (prec = 2; prec <= 400; prec += 199)
+    for (kind = 0; kind < 3; kind++)
+      {
+        for (i = 0; i < N; i++)
+          {
+            mpc_set_prec (z[i], prec);
+            if (kind == 1)
+              mpc_set_si_si (z[i], (i % 2) ? -i / 2 : i / 2,
+                             (i % 2) ? i / 2 : -i / 2, MPC_RNDNN);
+            else
+              test_default_random (z[i], -10, 10, 128, 0);
+          }
+        if (kind == 2)
+          {
+            mpc_mul_2ui (z[0], z[0], 300, MPC_RNDNN);
+            mpc_neg (z[N - 1], z[0], MPC_RNDNN);
+          }
+        mpc_init2 (res, prec);
+        mpc_init2 (ref, prec);
+        for (r = 0; r < 4; r++)
+          {
+            rnd = MPC_RND (r, 3 - r);
+            inex_ref = mpc_sum (ref, t, N, rnd);
+            for (threads = 1; threads <= 6; threads++)
+              {
+                inex = mpc_sum_mt (res, t, N, rnd, threads);
+                if (inex != inex_ref || !same_mpc_value (res, ref, ks))
+                  {
+                    printf ("mpc_sum_mt differs from the sequential function "
+                            "for %u threads, kind %d, precision %lu\n",
+                            threads, kind, (unsigned long) prec);
+                    MPC_OUT (ref);
+                    MPC_OUT (res);
+                    exit (1);
+                  }
+              }
+          }
+        mpc_clear (res);
+        mpc_clear (ref);
+      }
+  for (i = 0; i < N; i++)
+    mpc_clear (z[i]);
+#undef N
+}
+
 int
 main (void)
 {
   test_start ();
 
   check_special ();
+  check_mt ();
 
   test_end ();
 
@@ -0,0 +1,179 @@
+/* tvec -- Test file for the elementwise functions on arrays.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+#define N 24
+
+static mpc_t x[N], y[N], z[N], a[N], b[N], c[N], d[N];
+static int inex[N];
+
+static void
+check_element (const char *name, unsigned long i, mpc_ptr got, mpc_ptr ref,
+               int inex_got, int inex_ref)
+{
+  known_signs_t ks = {1, 1};
+
+  if (!same_mpc_value (got, ref, ks) || inex_got != inex_ref)
+    {
+      printf ("Error in mpc_vec_%s for element %lu\n", name, i);
+      MPC_OUT (x[i]);
+      MPC_OUT (y[i]);
+      MPC_OUT (got);
+      MPC_OUT (ref);
+      printf ("inex got %d, expected %d\n", inex_got, inex_ref);
+      exit (1);
+    }
+}
+
+/* compare the vector function with the scalar function f for element i */
+#define CHECK(name, f)                                                  \
+  for (i = 0; i < N; i++)                                               \
+    check_element (name, i, a[i], b[i], inex[i], f)
+
+/* operands with regular and special elements, with exponents in
+   [emin, emax] */
+static void
+fill (mpc_t *v, mpfr_exp_t emin, mpfr_exp_t emax)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    test_default_random (v[i], emin, emax, 128, 16);
+  mpfr_set_inf (mpc_realref (v[1]), -1);
+  mpfr_set_nan (mpc_imagref (v[2]));
+  mpfr_set_inf (mpc_imagref (v[3]), +1);
+  mpfr_set_zero (mpc_realref (v[4]), -1);
+  mpfr_set_zero (mpc_imagref (v[5]), +1);
+}
+
+static void
+check_vec (mpfr_prec_t prec, mpc_rnd_t rnd, mpc_rnd_t rnd2)
+{
+  mpfr_exp_t emin, emax;
+  int i;
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_set_prec (x[i], prec);
+      mpc_set_prec (y[i], prec);
+      mpc_set_prec (z[i], prec);
+      /* vary the precision of the results */
+      mpc_set_prec (a[i], prec + i);
+      mpc_set_prec (b[i], prec + i);
+      mpc_set_prec (c[i], prec + 2 * i);
+      mpc_set_prec (d[i], prec + 2 * i);
+    }
+  fill (x, -100, 100);
+  fill (y, -100, 100);
+  fill (z, -100, 100);
+
+  mpc_vec_add (a[0], x[0], y[0], N, inex, rnd);
+  CHECK ("add", mpc_add (b[i], x[i], y[i], rnd));
+  mpc_vec_sub (a[0], x[0], y[0], N, inex, rnd);
+  CHECK ("sub", mpc_sub (b[i], x[i], y[i], rnd));
+  mpc_vec_mul (a[0], x[0], y[0], N, inex, rnd);
+  CHECK ("mul", mpc_mul (b[i], x[i], y[i], rnd));
+  mpc_vec_sqr (a[0], x[0], N, inex, rnd);
+  CHECK ("sqr", mpc_sqr (b[i], x[i], rnd));
+  mpc_vec_fma (a[0], x[0], y[0], z[0], N, inex, rnd);
+  CHECK ("fma", mpc_fma (b[i], x[i], y[i], z[i], rnd));
+  mpc_vec_div (a[0], x[0], y[0], N, inex, rnd);
+  CHECK ("div", mpc_div (b[i], x[i], y[i], rnd));
+
+  /* exp, with results out of the exponent range */
+  fill (x, -100, 7);
+  mpc_vec_exp (a[0], x[0], N, inex, rnd);
+  CHECK ("exp", mpc_exp (b[i], x[i], rnd));
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  mpfr_set_emin (-64);
+  mpfr_set_emax (64);
+  mpc_vec_exp (a[0], x[0], N, inex, rnd);
+  CHECK ("exp", mpc_exp (b[i], x[i], rnd));
+  mpfr_set_emin (emin);
+  mpfr_set_emax (emax);
+
+  /* exp, in place */
+  for (i = 0; i < N; i++)
+    {
+      mpc_set_prec (a[i], prec);
+      mpc_set_prec (b[i], prec);
+      mpc_set (a[i], x[i], MPC_RNDNN);
+    }
+  mpc_vec_exp (a[0], a[0], N, inex, rnd);
+  CHECK ("exp", mpc_exp (b[i], x[i], rnd));
+
+  /* sin_cos, also in place for the sine */
+  mpc_vec_sin_cos (a[0], c[0], x[0], N, inex, rnd, rnd2);
+  for (i = 0; i < N; i++)
+    {
+      int r = mpc_sin_cos (b[i], d[i], x[i], rnd, rnd2);
+      check_element ("sin_cos", i, a[i], b[i], MPC_INEX1 (inex[i]),
+                     MPC_INEX1 (r));
+      check_element ("sin_cos", i, c[i], d[i], MPC_INEX2 (inex[i]),
+                     MPC_INEX2 (r));
+      mpc_set (a[i], x[i], MPC_RNDNN);
+    }
+  mpc_vec_sin_cos (a[0], NULL, a[0], N, NULL, rnd, rnd2);
+  for (i = 0; i < N; i++)
+    check_element ("sin_cos", i, a[i], b[i], 0, 0);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t prec;
+  int i;
+
+  test_start ();
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_init2 (x[i], 2);
+      mpc_init2 (y[i], 2);
+      mpc_init2 (z[i], 2);
+      mpc_init2 (a[i], 2);
+      mpc_init2 (b[i], 2);
+      mpc_init2 (c[i], 2);
+      mpc_init2 (d[i], 2);
+    }
+
+  for (prec = 2; prec <= 512; prec += prec / 2 + 7)
+    {
+      check_vec (prec, MPC_RNDNN, MPC_RNDZU);
+      check_vec (prec, MPC_RNDUD, MPC_RNDDZ);
+    }
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_clear (x[i]);
+      mpc_clear (y[i]);
+      mpc_clear (z[i]);
+      mpc_clear (a[i]);
+      mpc_clear (b[i]);
+      mpc_clear (c[i]);
+      mpc_clear (d[i]);
+    }
+
+  test_end ();
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+/* tvec_view -- Test file for mpc_vec_t.
+
+Copyright (C) 2020 INRIA
+
+This file is part of GNU MPC.
+
+GNU MPC is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+GNU MPC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see http://www.gnu.org/licenses/ .
+*/
+
+#include "mpc-tests.h"
+
+#define N 37
+#define M 8 /* size of the views */
+
+static void
+check_element (const char *what, unsigned long i, mpc_ptr got, mpc_ptr ref)
+{
+  known_signs_t ks = {1, 1};
+
+  if (!same_mpc_value (got, ref, ks))
+    {
+      printf ("Error in mpc_vec_t (%s) for element %lu\n", what, i);
+      MPC_OUT (got);
+      MPC_OUT (ref);
+      exit (1);
+    }
+}
+
+static void
+check_vec_t (mpfr_prec_t prec)
+{
+  mpc_vec_t v;
+  mpc_t x[N], y[N], z, view[M];
+  unsigned long i, j, k;
+  int inex, inex_ref;
+
+  mpc_vec_init2 (v, N, prec);
+  mpc_init2 (z, prec);
+  for (i = 0; i < N; i++)
+    {
+      mpc_init2 (x[i], prec + 10);
+      mpc_init2 (y[i], prec);
+      test_default_random (x[i], -50, 50, 128, 16);
+    }
+  mpfr_set_inf (mpc_realref (x[1]), -1);
+  mpfr_set_nan (mpc_imagref (x[2]));
+  mpfr_set_zero (mpc_realref (x[3]), -1);
+  mpfr_set_zero (mpc_imagref (x[4]), +1);
+
+  /* a new vector contains NaNs */
+  for (i = 0; i < N; i++)
+    {
+      mpc_vec_get (z, v, i, MPC_RNDNN);
+      if (!mpfr_nan_p (mpc_realref (z)) || !mpfr_nan_p (mpc_imagref (z)))
+        {
+          printf ("Error in mpc_vec_init2: element %lu is not NaN\n", i);
+          exit (1);
+        }
+    }
+
+  /* set and get round as mpc_set */
+  for (i = 0; i < N; i++)
+    {
+      inex = mpc_vec_set (v, i, x[i], MPC_RNDZU);
+      inex_ref = mpc_set (y[i], x[i], MPC_RNDZU);
+      if (inex != inex_ref)
+        {
+          printf ("Error in mpc_vec_set: wrong ternary value for element "
+                  "%lu\n", i);
+          exit (1);
+        }
+    }
+  for (i = 0; i < N; i++)
+    {
+      inex = mpc_vec_get (z, v, i, MPC_RNDNN);
+      MPC_ASSERT (inex == 0);
+      check_element ("get", i, z, y[i]);
+    }
+
+  /* work on views of M elements, and store them back */
+  for (i = 0; i < N; i += M)
+    {
+      k = (N - i < M) ? N - i : M;
+      mpc_vec_view (view[0], v, i, k);
+      for (j = 0; j < k; j++)
+        check_element ("view", i + j, view[j], y[i + j]);
+      mpc_vec_exp (view[0], view[0], k, NULL, MPC_RNDNN);
+      mpc_vec_store (v, i, view[0], k);
+    }
+  for (i = 0; i < N; i++)
+    {
+      mpc_exp (y[i], y[i], MPC_RNDNN);
+      mpc_vec_get (z, v, i, MPC_RNDNN);
+      check_element ("exp on views", i, z, y[i]);
+    }
+
+  /* mpc_mul_i in place exchanges the parts of a view with mpfr_swap, so
+     that each part points to the significand of the other one; the views
+     remain valid after storing them */
+  for (i = 0; i < N; i += M)
+    {
+      k = (N - i < M) ? N - i : M;
+      mpc_vec_view (view[0], v, i, k);
+      for (j = 0; j < k; j++)
+        mpc_mul_i (view[j], view[j], (j % 2 == 0) ? +1 : -1, MPC_RNDNN);
+      mpc_vec_store (v, i, view[0], k);
+      for (j = 0; j < k; j++)
+        {
+          mpc_mul_i (y[i + j], y[i + j], (j % 2 == 0) ? +1 : -1, MPC_RNDNN);
+          check_element ("view after mpc_mul_i", i + j, view[j], y[i + j]);
+        }
+      for (j = 0; j < k; j++)
+        mpc_sqr (view[j], view[j], MPC_RNDNN);
+      mpc_vec_store (v, i, view[0], k);
+    }
+  for (i = 0; i < N; i++)
+    {
+      mpc_sqr (y[i], y[i], MPC_RNDNN);
+      mpc_vec_get (z, v, i, MPC_RNDNN);
+      check_element ("mpc_mul_i on views", i, z, y[i]);
+    }
+
+  /* views stored at shifted indices, or whose parts have been exchanged
+     with parts of other views, are read before they are overwritten */
+  mpc_vec_view (view[0], v, 0, M);
+  mpc_vec_store (v, 1, view[0], M);
+  for (i = M; i >= 1; i--)
+    mpc_set (y[i], y[i - 1], MPC_RNDNN);
+  for (i = 0; i < N; i++)
+    {
+      mpc_vec_get (z, v, i, MPC_RNDNN);
+      check_element ("shifted views", i, z, y[i]);
+    }
+  mpc_vec_view (view[0], v, 0, 2);
+  mpc_swap (view[0], view[1]);
+  mpc_vec_store (v, 0, view[0], 2);
+  mpc_swap (y[0], y[1]);
+  mpc_vec_view (view[0], v, 0, 2);
+  mpfr_swap (mpc_realref (view[0]), mpc_imagref (view[1]));
+  mpc_vec_store (v, 0, view[0], 2);
+  mpfr_swap (mpc_realref (y[0]), mpc_imagref (y[1]));
+  for (i = 0; i < N; i++)
+    {
+      mpc_vec_get (z, v, i, MPC_RNDNN);
+      check_element ("swapped views", i, z, y[i]);
+    }
+
+  /* storing variables that are not views rounds to nearest */
+  mpc_vec_store (v, 0, x[0], N);
+  for (i = 0; i < N; i++)
+    {
+      mpc_set (y[i], x[i], MPC_RNDNN);
+      mpc_vec_get (z, v, i, MPC_RNDNN);
+      check_element ("store", i, z, y[i]);
+    }
+
+  for (i = 0; i < N; i++)
+    {
+      mpc_clear (x[i]);
+      mpc_clear (y[i]);
+    }
+  mpc_clear (z);
+  mpc_vec_clear (v);
+}
+
+int
+main (void)
+{
+  mpc_vec_t v;
+  mpfr_prec_t prec;
+
+  test_start ();
+
+  mpc_vec_init2 (v, 0, 53);
+  mpc_vec_clear (v);
+
+  for (prec = 2; prec <= 1000; prec += prec / 3 + 1)
+    check_vec_t (prec);
+
+  test_end ();
+
+  return 0;
+}
@@ -64,3 +64,13 @@ __attribute__ ((__unused__)) int nop)\
 #define DECLARE_TIME_2OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn],y[kn], MPC_RNDNN), 2 )
 /* functions with 1 operand */
 #define DECLARE_TIME_1OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn], MPC_RNDNN), 1 )
+
+/* vector functions are called on blocks of BENCH_VEC_BLOCK consecutive
+   elements, BENCH_VEC_BLOCK dividing the number n of elements, and store
+   their ternary values into vec_inex */
+#define BENCH_VEC_BLOCK 10
+#define BENCH_VEC(kn) ((kn) - (kn) % BENCH_VEC_BLOCK)
+/* vector functions with 2 operands */
+#define DECLARE_TIME_VEC_2OP(func)   DECLARE_TIME_NOP(func, func(z[BENCH_VEC(kn)],x[BENCH_VEC(kn)],y[BENCH_VEC(kn)], BENCH_VEC_BLOCK, vec_inex, MPC_RNDNN), 2 )
+/* vector functions with 1 operand */
+#define DECLARE_TIME_VEC_1OP(func)   DECLARE_TIME_NOP(func, func(z[BENCH_VEC(kn)],x[BENCH_VEC(kn)], BENCH_VEC_BLOCK, vec_inex, MPC_RNDNN), 1 )
@@ -38,13 +38,17 @@ enum egroupfunc
 {
   egroup_arith = 0,             /* e.g., arith ... */
   egroup_special,               /* e.g., cos, ... */
+  egroup_branch,                /* e.g., asin near 1, ... */
+  egroup_vector,                /* e.g., vec_add, ... */
   egroup_last                   /* to get the number of enum */
 };
 
 /* name of the group of functions */
 const char *groupname [] = { 
 "Arith  ", 
-"Special"
+"Special",
+"Branch ",
+"Vector "
 };
 
 
@@ -63,7 +67,12 @@ struct benchfunc
 DECLARE_TIME_2OP (mpc_add)
 DECLARE_TIME_2OP (mpc_sub)
 DECLARE_TIME_2OP (mpc_mul)
+DECLARE_TIME_1OP (mpc_sqr)
+DECLARE_TIME_NOP (mpc_norm, mpc_norm (mpc_realref (z[kn]), x[kn], MPFR_RNDN), 1)
+DECLARE_TIME_NOP (mpc_fma, mpc_fma (z[kn], x[kn], y[kn], x[kn], MPC_RNDNN), 2)
+DECLARE_TIME_NOP (mpc_fmma, mpc_fmma (z[kn], x[kn], y[kn], y[kn], y[kn], MPC_RNDNN), 2)
 DECLARE_TIME_2OP (mpc_div)
+DECLARE_TIME_1OP (mpc_inv)
 DECLARE_TIME_1OP (mpc_sqrt)
 DECLARE_TIME_1OP (mpc_exp)
 DECLARE_TIME_1OP (mpc_log)
@@ -72,9 +81,62 @@ DECLARE_TIME_1OP (mpc_sin)
 DECLARE_TIME_1OP (mpc_cos)
 DECLARE_TIME_1OP (mpc_asin) 
 DECLARE_TIME_1OP (mpc_acos)
+DECLARE_TIME_1OP (mpc_asinh)
+DECLARE_TIME_1OP (mpc_acosh)
+
+/* loops of scalar calls with the interface of the vector functions, to
+   measure the gain of the latter */
+static void
+loop_mpc_add (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, unsigned long n,
+              int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  for (i = 0; i < n; i++)
+    inex[i] = mpc_add (rop + i, op1 + i, op2 + i, rnd);
+}
+
+static void
+loop_mpc_mul (mpc_ptr rop, mpc_srcptr op1, mpc_srcptr op2, unsigned long n,
+              int *inex, mpc_rnd_t rnd)
+{
+  unsigned long i;
+  for (i = 0; i < n; i++)
+    inex[i] = mpc_mul (rop + i, op1 + i, op2 + i, rnd);
+}
+
+static void
+loop_mpc_exp (mpc_ptr rop, mpc_srcptr op, unsigned long n, int *inex,
+              mpc_rnd_t rnd)
+{
+  unsigned long i;
+  for (i = 0; i < n; i++)
+    inex[i] = mpc_exp (rop + i, op + i, rnd);
+}
+
+static void
+loop_mpc_sin_cos (mpc_ptr rop_sin, mpc_ptr rop_cos, mpc_srcptr op,
+                  unsigned long n, int *inex,
+                  mpc_rnd_t rnd_sin, mpc_rnd_t rnd_cos)
+{
+  unsigned long i;
+  for (i = 0; i < n; i++)
+    inex[i] = mpc_sin_cos (rop_sin + i, rop_cos + i, op + i, rnd_sin, rnd_cos);
+}
+
+static int vec_inex[BENCH_VEC_BLOCK];
+
+DECLARE_TIME_VEC_2OP (mpc_vec_add)
+DECLARE_TIME_VEC_2OP (loop_mpc_add)
+DECLARE_TIME_VEC_2OP (mpc_vec_mul)
+DECLARE_TIME_VEC_2OP (loop_mpc_mul)
+DECLARE_TIME_VEC_1OP (mpc_vec_exp)
+DECLARE_TIME_VEC_1OP (loop_mpc_exp)
+/* y receives the cosine */
+DECLARE_TIME_NOP (mpc_vec_sin_cos, mpc_vec_sin_cos (z[BENCH_VEC(kn)], y[BENCH_VEC(kn)], x[BENCH_VEC(kn)], BENCH_VEC_BLOCK, vec_inex, MPC_RNDNN, MPC_RNDNN), 1)
+DECLARE_TIME_NOP (loop_mpc_sin_cos, loop_mpc_sin_cos (z[BENCH_VEC(kn)], y[BENCH_VEC(kn)], x[BENCH_VEC(kn)], BENCH_VEC_BLOCK, vec_inex, MPC_RNDNN, MPC_RNDNN), 1)
 
 /* number of operations to score*/
-#define NB_BENCH_OP 12
+#define NB_BENCH_OP 29
 /* number of random numbers */
 #define NB_RAND_CPLX 10000
 
@@ -84,7 +146,12 @@ const struct benchfunc
       {"add", ADDR_TIME_NOP (mpc_add), ADDR_ACCURATE_TIME_NOP (mpc_add), egroup_arith, 2},
       {"sub", ADDR_TIME_NOP (mpc_sub), ADDR_ACCURATE_TIME_NOP (mpc_sub), egroup_arith, 2},
       {"mul", ADDR_TIME_NOP (mpc_mul), ADDR_ACCURATE_TIME_NOP (mpc_mul), egroup_arith, 2},
+      {"sqr", ADDR_TIME_NOP (mpc_sqr), ADDR_ACCURATE_TIME_NOP (mpc_sqr), egroup_arith, 1},
+      {"norm", ADDR_TIME_NOP (mpc_norm), ADDR_ACCURATE_TIME_NOP (mpc_norm), egroup_arith, 1},
+      {"fma", ADDR_TIME_NOP (mpc_fma), ADDR_ACCURATE_TIME_NOP (mpc_fma), egroup_arith, 2},
+      {"fmma", ADDR_TIME_NOP (mpc_fmma), ADDR_ACCURATE_TIME_NOP (mpc_fmma), egroup_arith, 2},
       {"div", ADDR_TIME_NOP (mpc_div), ADDR_ACCURATE_TIME_NOP (mpc_div), egroup_arith, 2},
+      {"inv", ADDR_TIME_NOP (mpc_inv), ADDR_ACCURATE_TIME_NOP (mpc_inv), egroup_arith, 1},
       {"sqrt", ADDR_TIME_NOP (mpc_sqrt), ADDR_ACCURATE_TIME_NOP (mpc_sqrt), egroup_arith, 1},
       {"exp", ADDR_TIME_NOP (mpc_exp), ADDR_ACCURATE_TIME_NOP (mpc_exp), egroup_special, 1},
       {"log", ADDR_TIME_NOP (mpc_log), ADDR_ACCURATE_TIME_NOP (mpc_log), egroup_special, 1},
@@ -92,7 +159,23 @@ const struct benchfunc
       {"sin", ADDR_TIME_NOP (mpc_sin), ADDR_ACCURATE_TIME_NOP (mpc_sin), egroup_special, 1},
       {"cos", ADDR_TIME_NOP (mpc_cos), ADDR_ACCURATE_TIME_NOP (mpc_cos), egroup_special, 1},
       {"asin", ADDR_TIME_NOP (mpc_asin), ADDR_ACCURATE_TIME_NOP (mpc_asin), egroup_special, 1},
-      {"acos", ADDR_TIME_NOP (mpc_acos), ADDR_ACCURATE_TIME_NOP (mpc_acos), egroup_special, 1}
+      {"acos", ADDR_TIME_NOP (mpc_acos), ADDR_ACCURATE_TIME_NOP (mpc_acos), egroup_special, 1},
+      /* the following ones are called on arguments close to the branch
+         points and the axes, see bench_near_branch */
+      {"basin", ADDR_TIME_NOP (mpc_asin), ADDR_ACCURATE_TIME_NOP (mpc_asin), egroup_branch, 1},
+      {"bacos", ADDR_TIME_NOP (mpc_acos), ADDR_ACCURATE_TIME_NOP (mpc_acos), egroup_branch, 1},
+      {"basinh", ADDR_TIME_NOP (mpc_asinh), ADDR_ACCURATE_TIME_NOP (mpc_asinh), egroup_branch, 1},
+      {"bacosh", ADDR_TIME_NOP (mpc_acosh), ADDR_ACCURATE_TIME_NOP (mpc_acosh), egroup_branch, 1},
+      /* the following ones process BENCH_VEC_BLOCK elements per call,
+         with the vector function (v) or a loop of scalar calls (l) */
+      {"vadd", ADDR_TIME_NOP (mpc_vec_add), ADDR_ACCURATE_TIME_NOP (mpc_vec_add), egroup_vector, 2},
+      {"ladd", ADDR_TIME_NOP (loop_mpc_add), ADDR_ACCURATE_TIME_NOP (loop_mpc_add), egroup_vector, 2},
+      {"vmul", ADDR_TIME_NOP (mpc_vec_mul), ADDR_ACCURATE_TIME_NOP (mpc_vec_mul), egroup_vector, 2},
+      {"lmul", ADDR_TIME_NOP (loop_mpc_mul), ADDR_ACCURATE_TIME_NOP (loop_mpc_mul), egroup_vector, 2},
+      {"vexp", ADDR_TIME_NOP (mpc_vec_exp), ADDR_ACCURATE_TIME_NOP (mpc_vec_exp), egroup_vector, 1},
+      {"lexp", ADDR_TIME_NOP (loop_mpc_exp), ADDR_ACCURATE_TIME_NOP (loop_mpc_exp), egroup_vector, 1},
+      {"vsc", ADDR_TIME_NOP (mpc_vec_sin_cos), ADDR_ACCURATE_TIME_NOP (mpc_vec_sin_cos), egroup_vector, 1},
+      {"lsc", ADDR_TIME_NOP (loop_mpc_sin_cos), ADDR_ACCURATE_TIME_NOP (loop_mpc_sin_cos), egroup_vector, 1}
     };
 
 /* the following arrays must have the same number of elements */
@@ -101,15 +184,40 @@ const struct benchfunc
 const int arrayprecision_op1[] =
   { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 
   50, 100, 200, 350, 700, 1500, 3000, 6000, 10000, 1500, 3000, 5000,
+  53, 106
 };
 
 /* list of precisions to test for the second operand */
 const int arrayprecision_op2[] =
   { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384,
-  50, 100, 200, 350, 700, 1500, 3000, 6000, 10000, 3000, 6000, 10000
-  
+  50, 100, 200, 350, 700, 1500, 3000, 6000, 10000, 3000, 6000, 10000,
+  53, 106
 };
 
+/* number of calls to the GMP memory allocation functions, which are also
+   used by GNU MPFR and GNU MPC; it is reported per call of the benchmarked
+   function, and shows for instance the effect of the pool of temporary
+   variables and of the MPFR functions computing several operations with
+   only one rounding */
+static unsigned long bench_nalloc = 0;
+static void *(*bench_gmp_alloc) (size_t);
+static void *(*bench_gmp_realloc) (void *, size_t, size_t);
+static void (*bench_gmp_free) (void *, size_t);
+
+static void *
+bench_alloc (size_t n)
+{
+  bench_nalloc++;
+  return bench_gmp_alloc (n);
+}
+
+static void *
+bench_realloc (void *p, size_t old_size, size_t new_size)
+{
+  bench_nalloc++;
+  return bench_gmp_realloc (p, old_size, new_size);
+}
+
 /* get the time in microseconds */
 static unsigned long
 get_cputime (void)
@@ -150,6 +258,44 @@ bench_random_array (int n, mpfr_prec_t precision, gmp_randstate_t randstate)
   return ptr;
 }
 
+/* move the n random complex numbers of x, with parts in [0, 1), at a
+   distance of about 1e-1000 from the branch points +/-1 and +/-i of the
+   inverse trigonometric and hyperbolic functions, or from the real and
+   imaginary axes outside of them, where the naive formulae suffer from
+   cancellation */
+static void
+bench_near_branch (mpc_t *x, int n)
+{
+  int j;
+
+  for (j = 0; j < n; j++)
+    {
+      mpfr_ptr re = mpc_realref (x[j]), im = mpc_imagref (x[j]);
+
+      mpfr_mul_2si (im, im, -3322, MPFR_RNDN);
+      switch (j % 6)
+        {
+        case 0: /* 1 + i*eps */
+          mpfr_set_ui (re, 1, MPFR_RNDN);
+          break;
+        case 1: /* -1 + i*eps */
+          mpfr_set_si (re, -1, MPFR_RNDN);
+          break;
+        case 2: /* in (0, 1) + i*eps */
+          break;
+        case 3: /* in (1, 2) + i*eps */
+          mpfr_add_ui (re, re, 1, MPFR_RNDN);
+          break;
+        case 4: /* eps + i */
+          mpfr_swap (re, im);
+          mpfr_set_ui (im, 1, MPFR_RNDN);
+          break;
+        default: /* eps + i * (1, 2) */
+          mpfr_swap (re, im);
+          mpfr_add_ui (im, im, 1, MPFR_RNDN);
+        }
+    }
+}
 
 /* Print the positive number x with 3 significant digits or at most 3 digits
    after the komma, using 7 digits before the komma. */
@@ -209,6 +355,8 @@ compute_score (double *zscore, int op, gmp_randstate_t randstate)
       xptr = bench_random_array (NB_RAND_CPLX, precision1, randstate);
       yptr = bench_random_array (NB_RAND_CPLX, precision2, randstate);
       zptr = bench_random_array (NB_RAND_CPLX, precision3, randstate);
+      if (arrayfunc[i].group == egroup_branch)
+        bench_near_branch (xptr, NB_RAND_CPLX);
 
       /* compute the number of operations per seconds */
       if (arrayfunc[i].noperands==2)
@@ -227,13 +375,14 @@ compute_score (double *zscore, int op, gmp_randstate_t randstate)
 
       /* ti expressed in microseconds */
       niter = (niter + 9) / 10;
+      bench_nalloc = 0;
       ti = arrayfunc[i].func_accurate (niter, NB_RAND_CPLX, zptr, xptr, yptr, arrayfunc[i].noperands);
 
       ops_per_time = 1e5 * niter / (double) ti;
          /* use 0.1s */
 
       sensible_print (ops_per_time);
-      printf ("\n");
+      printf (" %7.2f alloc\n", (double) bench_nalloc / (double) niter);
 
       *zscore *= ops_per_time;
 
@@ -299,6 +448,9 @@ main (void)
 
   gmp_randstate_t randstate;
 
+  mp_get_memory_functions (&bench_gmp_alloc, &bench_gmp_realloc,
+                           &bench_gmp_free);
+  mp_set_memory_functions (bench_alloc, bench_realloc, bench_gmp_free);
   gmp_randinit_default (randstate);
 
   for (i = 0; i < NB_BENCH_OP; i++)